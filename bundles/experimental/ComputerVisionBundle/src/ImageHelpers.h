@@ -170,216 +170,45 @@ inline unsigned short * makeCheckerboard( const unsigned int width, const unsign
 	return data;
 }
 
-inline cv::Mat *const convertToCvMat( Image &src )
+inline int getCvType( Image const& src )
 {
-	unsigned int width = src.getWidth();
-	unsigned int height = src.getHeight();
-	unsigned char *data = src.getData();
-	void *d = static_cast< void * >( data );
-	int cvType;
-
-	if ( width == 0 || height == 0 )
-	{
-	}
-
-	ImageType type = src.getImageType();
-
-	unsigned int numChannels = src.getChannelOrder().getNumberOfChannels();
-	switch ( numChannels )
+	int depth;
+	switch( src.getImageType().getDatatype() )
 	{
-	case 1:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC1;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC1;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC1;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC1;
-			break;
-		default:
-			cvType = CV_8UC1;
-			break;
-		}
+	case ImageType::UNSIGNED_SHORT:
+		depth = CV_16U;
 		break;
-	case 2:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC2;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC2;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC2;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC2;
-			break;
-		default:
-			cvType = CV_8UC2;
-			break;
-		}
+	case ImageType::FLOAT:
+		depth = CV_32F;
 		break;
-	case 3:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC3;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC3;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC3;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC3;
-			break;
-		default:
-			cvType = CV_8UC3;
-			break;
-		}
-		break;
-	case 4:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC4;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC4;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC4;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC4;
-			break;
-		default:
-			cvType = CV_8UC4;
-			break;
-		}
+	case ImageType::DOUBLE:
+		depth = CV_64F;
 		break;
 	default:
-		cvType = CV_8UC1;
+		depth = CV_8U;
 		break;
 	}
 
-	cv::Mat *result = new cv::Mat( src.getHeight(), src.getWidth(), cvType, d );
-
-	return result;
-}
-
-inline cv::Mat const* const convertToCvMat( Image const& src )
-{
-	unsigned int width = src.getWidth();
-	unsigned int height = src.getHeight();
-	unsigned char * data = const_cast< unsigned char * >( src.getData() );
-	void *d = static_cast< void * >( data );
-	int cvType;
-
-	if ( width == 0 || height == 0 )
-	{
-	}
-
-	ImageType type = src.getImageType();
-
 	unsigned int numChannels = src.getChannelOrder().getNumberOfChannels();
-	switch ( numChannels )
+	if ( numChannels < 1 || numChannels > 4 )
 	{
-	case 1:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC1;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC1;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC1;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC1;
-			break;
-		default:
-			cvType = CV_8UC1;
-			break;
-		}
-		break;
-	case 2:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC2;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC2;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC2;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC2;
-			break;
-		default:
-			cvType = CV_8UC2;
-			break;
-		}
-		break;
-	case 3:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC3;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC3;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC3;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC3;
-			break;
-		default:
-			cvType = CV_8UC3;
-			break;
-		}
-		break;
-	case 4:
-		switch( type.getDatatype() )
-		{
-		case ImageType::UNSIGNED_BYTE:
-			cvType = CV_8UC4;
-			break;
-		case ImageType::UNSIGNED_SHORT:
-			cvType = CV_16UC4;
-			break;
-		case ImageType::FLOAT:
-			cvType = CV_32FC4;
-			break;
-		case ImageType::DOUBLE:
-			cvType = CV_64FC4;
-			break;
-		default:
-			cvType = CV_8UC4;
-			break;
-		}
-		break;
-	default:
-		cvType = CV_8UC1;
-		break;
+		return CV_8UC1;
 	}
 
-	cv::Mat *result = new cv::Mat( src.getHeight(), src.getWidth(), cvType, d );
+	return CV_MAKETYPE( depth, numChannels );
+}
 
-	return result;
-}
\ No newline at end of file
+// header on the image's pixels, no copy & no heap allocation; the row pitch becomes the mat's step,
+// so sub images & images with padded rows can be handed to opencv directly.
+// the mat is only valid as long as the image's payload is - non-const access to the image may detach it
+inline cv::Mat convertToCvMat( Image &src )
+{
+	unsigned char *data = src.getData();
+	return cv::Mat( src.getHeight(), src.getWidth(), getCvType( src ), static_cast< void * >( data ), src.getRowPitch() );
+}
+
+inline cv::Mat const convertToCvMat( Image const& src )
+{
+	unsigned char *data = const_cast< unsigned char * >( src.getData() );
+	return cv::Mat( src.getHeight(), src.getWidth(), getCvType( src ), static_cast< void * >( data ), src.getRowPitch() );
+}
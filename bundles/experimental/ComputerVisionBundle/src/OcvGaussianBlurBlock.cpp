@@ -21,11 +21,39 @@
 #include "opencv2/imgproc/imgproc.hpp"
 
 #include <iostream>
+#include <algorithm>
 
 using namespace _2Real::bundle;
 using namespace _2Real;
 using namespace std;
 
+namespace
+{
+	// blurs the image in bands of rows, which BlockHandle::parallelFor spreads over the idle workers.
+	// opencv reads the rows around a band from the whole image, so the result equals a single blur
+	struct GaussianBlurBands
+	{
+		GaussianBlurBands( cv::Mat const& s, cv::Mat &d, cv::Size const& k, const double sX, const double sY, const int b ) :
+			src( s ), dst( d ), kernel( k ), sigmaX( sX ), sigmaY( sY ), border( b ),
+			rows( s.rows, std::max( 32, k.height ) )
+		{
+		}
+
+		void blur( const unsigned int &band )
+		{
+			cv::Mat out = dst.rowRange( rows.getBegin( band ), rows.getEnd( band ) );
+			cv::GaussianBlur( src.rowRange( rows.getBegin( band ), rows.getEnd( band ) ), out, kernel, sigmaX, sigmaY, border );
+		}
+
+		cv::Mat const&		src;
+		cv::Mat				&dst;
+		cv::Size			kernel;
+		double				sigmaX, sigmaY;
+		int					border;
+		RangePartition		rows;
+	};
+}
+
 OcvGaussianBlurBlock::OcvGaussianBlurBlock() : Block(), m_OutChannelOrder( ImageChannelOrder::RGB ), m_OutImageType( ImageType::UNSIGNED_BYTE ) {}
 OcvGaussianBlurBlock::~OcvGaussianBlurBlock() {}
 
@@ -106,13 +134,11 @@ void OcvGaussianBlurBlock::update()
 		}
 
 		// no copies or anything involved here, this just allows 'viewing' the imagesource as cv mat
-		cv::Mat const* const matSrc = convertToCvMat( input );
-		cv::Mat *const matDst = convertToCvMat( output );
-
-		cv::GaussianBlur( *matSrc, *matDst, cv::Size( kernelX, kernelY ), sigmaX, sigmaY, border );
+		cv::Mat const matSrc = convertToCvMat( input );
+		cv::Mat matDst = convertToCvMat( output );
 
-		delete matSrc;
-		delete matDst;
+		GaussianBlurBands bands( matSrc, matDst, cv::Size( kernelX, kernelY ), sigmaX, sigmaY, border );
+		m_Block.parallelFor( bands.rows.getCount(), bands, &GaussianBlurBands::blur );
 	}
 	catch( Exception & e )
 	{
@@ -177,13 +203,10 @@ void OcvHistogramEqualizationBlock::update()
 			m_OutImageType = output.getImageType();
 		}
 
-		cv::Mat const* const matSrc = convertToCvMat( input );
-		cv::Mat *const matDst = convertToCvMat( output );
-
-		cv::equalizeHist( *matSrc, *matDst );
+		cv::Mat const matSrc = convertToCvMat( input );
+		cv::Mat matDst = convertToCvMat( output );
 
-		delete matSrc;
-		delete matDst;
+		cv::equalizeHist( matSrc, matDst );
 	}
 	catch( Exception & e )
 	{
@@ -26,6 +26,30 @@ using namespace _2Real::bundle;
 using namespace _2Real;
 using namespace std;
 
+namespace
+{
+	// filters the image in bands of rows, as the gaussian blur block does; opencv reads the rows around
+	// a band from the whole image, so the result equals a single pass
+	struct SobelBands
+	{
+		SobelBands( cv::Mat const& s, cv::Mat &d, const int x, const int y ) :
+			src( s ), dst( d ), orderX( x ), orderY( y ), rows( s.rows, 32 )
+		{
+		}
+
+		void filter( const unsigned int &band )
+		{
+			cv::Mat out = dst.rowRange( rows.getBegin( band ), rows.getEnd( band ) );
+			cv::Sobel( src.rowRange( rows.getBegin( band ), rows.getEnd( band ) ), out, 2, orderX, orderY );
+		}
+
+		cv::Mat const&		src;
+		cv::Mat				&dst;
+		int					orderX, orderY;
+		RangePartition		rows;
+	};
+}
+
 OcvSobelBlock::OcvSobelBlock() : Block(), m_OutChannelOrder( ImageChannelOrder::RGB ), m_OutImageType( ImageType::UNSIGNED_BYTE ) {}
 OcvSobelBlock::~OcvSobelBlock() {}
 
@@ -90,13 +114,11 @@ void OcvSobelBlock::update()
 		}
 
 		// no copies or anything involved here, this just allows 'viewing' the imagesource as cv mat
-		cv::Mat const* const matSrc = convertToCvMat( input );
-		cv::Mat *const matDst = convertToCvMat( output );
-
-		cv::Sobel( *matSrc, *matDst, 2, orderX, orderY );
+		cv::Mat const matSrc = convertToCvMat( input );
+		cv::Mat matDst = convertToCvMat( output );
 
-		delete matSrc;
-		delete matDst;
+		SobelBands bands( matSrc, matDst, orderX, orderY );
+		m_Block.parallelFor( bands.rows.getCount(), bands, &SobelBands::filter );
 	}
 	catch( Exception & e )
 	{
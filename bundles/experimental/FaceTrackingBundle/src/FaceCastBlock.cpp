@@ -362,10 +362,13 @@ bool FaceCastBlock::makeDepthCast( const _2Real::Image &depthImg, const _2Real::
 
 	unsigned short *avrgPtr = &( m_avrgArray[0] );
 
+	// in pixels; rows may be padded, or the image may be a sub image
+	const size_t stride = depthImg.getRowPitch() / sizeof( unsigned short );
+
 	unsigned short minDepth = ~0x00;
 	for( int j = (int)v0; j < (int)v1; j++ )
 	{
-		unsigned short *depthPtr = (unsigned short*)depthImg.getData() + j * depthImg.getWidth() + (int)u0;
+		unsigned short *depthPtr = (unsigned short*)depthImg.getData() + j * stride + (int)u0;
 		for( int i = (int)u0; i < (int)u1; i++, depthPtr++ )
 			if( *depthPtr && minDepth > *depthPtr )
 				minDepth = *depthPtr;
@@ -386,7 +389,7 @@ bool FaceCastBlock::makeDepthCast( const _2Real::Image &depthImg, const _2Real::
 			v0 = clamp( v, 0.0, depthImg.getHeight() - 1.0 );
 			v1 = clamp( v + stepSizeY, 0.0, depthImg.getHeight() - 1.0 );
 
-			*( avrgPtr++ ) = avrgArea( (unsigned short*)depthImg.getData(), (int)u0, (int)v0, (int)u1, (int)v1, depthImg.getWidth(), cutoff );
+			*( avrgPtr++ ) = avrgArea( (unsigned short*)depthImg.getData(), (int)u0, (int)v0, (int)u1, (int)v1, stride, cutoff );
 		}
 	}
 
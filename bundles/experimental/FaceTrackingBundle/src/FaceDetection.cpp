@@ -461,10 +461,16 @@ namespace facetracking
 				return false;
 
 			m_sourceImg->imageData = (char*)img.getData();	//IplImage does not have const ptrs to image data, so we have to cast.
+			m_sourceImg->widthStep = (int)img.getRowPitch();	//rows may be padded, or the image may be a sub image
+			m_sourceImg->imageSize = m_sourceImg->widthStep * m_sourceImg->height;
 
 			//if source image is in the correct format anyways, we don't convert or copy, but simply use the raw source data
 			if( m_greyImgOnlyHeader )
+			{
 				m_greyImg->imageData = m_sourceImg->imageData;
+				m_greyImg->widthStep = m_sourceImg->widthStep;
+				m_greyImg->imageSize = m_sourceImg->imageSize;
+			}
 			else
 				cvCvtColor( m_sourceImg, m_greyImg, m_conversionFlag );
 
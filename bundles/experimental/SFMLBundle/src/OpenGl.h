@@ -160,14 +160,19 @@ namespace _2Real
 				else if ( imageType == ImageType::FLOAT )				t = GL_FLOAT;
 				else if ( imageType == ImageType::DOUBLE )				t = GL_DOUBLE;
 
+				// the buffer holds the pixels without gaps
+				Image contiguous( img );
+				contiguous.makeContiguous();
+				Image const& pixels = contiguous;
+
 				const unsigned int e = img.getWidth() * img.getHeight() * img.getNumberOfChannels();
-				const size_t s = img.getByteSize();
+				const size_t s = pixels.getByteSize();
 
 				bool createNewStorage = ( ( t != buffer->mDatatype ) || ( e != buffer->mElementCount ) );
 
 				glBindBuffer( buffer->mTarget, buffer->mHandle );
-				if ( createNewStorage )		glBufferData( buffer->mTarget, s, img.getData(), usageHint );
-				else						glBufferSubData( buffer->mTarget, 0, s, img.getData() );
+				if ( createNewStorage )		glBufferData( buffer->mTarget, s, pixels.getData(), usageHint );
+				else						glBufferSubData( buffer->mTarget, 0, s, pixels.getData() );
 				glBindBuffer( buffer->mTarget, 0 );
 
 				buffer->mDatatype = t;
@@ -241,16 +246,31 @@ namespace _2Real
 
 				bool createNewStorage = ( ( w != texture->mWidth ) || ( h != texture->mHeight ) || ( s.format != texture->mSettings.format ) );
 
+				// rows may be padded or belong to a larger image ( sub image ): gl skips the gaps, as long as the
+				// pitch is a whole number of pixels. otherwise ( e.g. rgb rows padded to 64 bytes ) the rows are compacted
+				const size_t pixelBytes = img.getNumberOfChannels() * imageType.getByteSize();
+				Image contiguous( img );
+				if ( img.getRowPitch() % pixelBytes != 0 ) contiguous.makeContiguous();
+				Image const& pixels = contiguous;
+
+				GLint unpackAlignment;
+				glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpackAlignment );
+				glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+				glPixelStorei( GL_UNPACK_ROW_LENGTH, static_cast< GLint >( pixels.getRowPitch() / pixelBytes ) );
+
 				glBindTexture( GL_TEXTURE_2D, texture->mHandle );
 				if ( createNewStorage )
 				{
-					glTexImage2D( GL_TEXTURE_2D, 0, s.format, w, h, 0, imageFormat, type, img.getData() );
+					glTexImage2D( GL_TEXTURE_2D, 0, s.format, w, h, 0, imageFormat, type, pixels.getData() );
 				}
 				else
 				{
-					glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, w, h, imageFormat, type, img.getData() );
+					glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, w, h, imageFormat, type, pixels.getData() );
 				}
 
+				glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+				glPixelStorei( GL_UNPACK_ALIGNMENT, unpackAlignment );
+
 				if ( texture->mSettings != s )
 				{
 					glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, s.wrapS );
@@ -55,7 +55,10 @@ public:
 		IplImage* one = cvCreateImage(cvSize(img.getWidth(), img.getHeight()), img.getBitsPerChannel(), img.getNumberOfChannels());
 		IplImage* two = cvCreateImage(cvSize(img.getWidth(), img.getHeight()), img.getBitsPerChannel(), img.getNumberOfChannels());
 
-		one->imageData = (char*)img.getData();
+		// the loop below walks imageSize bytes without row gaps
+		_2Real::Image contiguous( img );
+		contiguous.makeContiguous();
+		one->imageData = (char*)static_cast< _2Real::Image const& >( contiguous ).getData();
 
 		uchar* src = (uchar*) one->imageData;
 		uchar* dst = (uchar*) two->imageData;
@@ -163,6 +163,8 @@ public:
 		IplImage* two = cvCreateImage(cvSize(img.getWidth(), img.getHeight()), img.getBitsPerChannel(), img.getNumberOfChannels());
 		IplImage* image = cvCreateImage(cvSize(img.getWidth(), img.getHeight()), IPL_DEPTH_8U, 1);
 
+		// the loop below walks imageSize bytes without row gaps
+		img.makeContiguous();
 		one->imageData = (char*)img.getData();
 
 		uchar* src = (uchar*) one->imageData;
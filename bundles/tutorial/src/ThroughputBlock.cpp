@@ -24,7 +24,22 @@ void ThroughputBlock::setup( BlockHandle &block )
 {
 	try
 	{
-		m_pBlockHandle = block;
+		m_FilePath.resolve( block, "filepath" );
+		m_Number.resolve( block, "number" );
+		m_Bool.resolve( block, "bool" );
+		m_UChar.resolve( block, "uchar" );
+		m_Char.resolve( block, "char" );
+		m_UShort.resolve( block, "ushort" );
+		m_Short.resolve( block, "short" );
+		m_UInt.resolve( block, "uint" );
+		m_Int.resolve( block, "int" );
+		m_ULong.resolve( block, "ulong" );
+		m_Long.resolve( block, "long" );
+		m_Float.resolve( block, "float" );
+		m_Double.resolve( block, "double" );
+		m_Point.resolve( block, "point" );
+		m_String.resolve( block, "string" );
+		m_Vector.resolve( block, "vector" );
 	}
 	catch ( Exception &e )
 	{
@@ -37,23 +52,23 @@ void ThroughputBlock::update()
 {
 	try
 	{
-		// throughput inlets to 
-		m_pBlockHandle.getOutletHandle("filepath").getWriteableRef<_2Real::FilePath>() = m_pBlockHandle.getInletHandle("filepath").getReadableRef<_2Real::FilePath>();
-		m_pBlockHandle.getOutletHandle("number").getWriteableRef<_2Real::Number>() = m_pBlockHandle.getInletHandle("number").getReadableRef<_2Real::Number>();
-		m_pBlockHandle.getOutletHandle("bool").getWriteableRef<bool>() = m_pBlockHandle.getInletHandle("bool").getReadableRef<bool>();
-		m_pBlockHandle.getOutletHandle("uchar").getWriteableRef<unsigned char>() = m_pBlockHandle.getInletHandle("uchar").getReadableRef<unsigned char>();
-		m_pBlockHandle.getOutletHandle("char").getWriteableRef<char>() = m_pBlockHandle.getInletHandle("char").getReadableRef<char>();
-		m_pBlockHandle.getOutletHandle("ushort").getWriteableRef<unsigned short>() = m_pBlockHandle.getInletHandle("ushort").getReadableRef<unsigned short>();
-		m_pBlockHandle.getOutletHandle("short").getWriteableRef<short>() = m_pBlockHandle.getInletHandle("short").getReadableRef<short>();
-		m_pBlockHandle.getOutletHandle("uint").getWriteableRef<unsigned int>() = m_pBlockHandle.getInletHandle("uint").getReadableRef<unsigned int>();
-		m_pBlockHandle.getOutletHandle("int").getWriteableRef<int>() = m_pBlockHandle.getInletHandle("int").getReadableRef<int>();
-		m_pBlockHandle.getOutletHandle("ulong").getWriteableRef<unsigned long>() = m_pBlockHandle.getInletHandle("ulong").getReadableRef<unsigned long>();
-		m_pBlockHandle.getOutletHandle("long").getWriteableRef<long>() = m_pBlockHandle.getInletHandle("long").getReadableRef<long>();
-		m_pBlockHandle.getOutletHandle("float").getWriteableRef<float>() = m_pBlockHandle.getInletHandle("float").getReadableRef<float>();
-		m_pBlockHandle.getOutletHandle("double").getWriteableRef<double>() = m_pBlockHandle.getInletHandle("double").getReadableRef<double>();
-		m_pBlockHandle.getOutletHandle("point").getWriteableRef<_2Real::Point>() = m_pBlockHandle.getInletHandle("point").getReadableRef<_2Real::Point>();
-		m_pBlockHandle.getOutletHandle("string").getWriteableRef<string>() = m_pBlockHandle.getInletHandle("string").getReadableRef<string>();
-		m_pBlockHandle.getOutletHandle("vector").getWriteableRef<std::vector<_2Real::Number>>() = m_pBlockHandle.getInletHandle("vector").getReadableRef<std::vector<_2Real::Number>>();
+		// throughput inlets to outlets, the handles were resolved & type checked in setup
+		m_FilePath.update();
+		m_Number.update();
+		m_Bool.update();
+		m_UChar.update();
+		m_Char.update();
+		m_UShort.update();
+		m_Short.update();
+		m_UInt.update();
+		m_Int.update();
+		m_ULong.update();
+		m_Long.update();
+		m_Float.update();
+		m_Double.update();
+		m_Point.update();
+		m_String.update();
+		m_Vector.update();
 	}
 	catch ( Exception &e )
 	{
@@ -1,8 +1,29 @@
 #pragma once
 #include "_2RealBlock.h"
 
+#include <string>
+
 using namespace _2Real::bundle;
 
+// an inlet & the outlet of the same name, resolved once in setup
+template< typename T >
+struct Throughput
+{
+	void resolve( BlockHandle &block, std::string const& name )
+	{
+		in = TypedInletHandle< T >( block.getInletHandle( name ) );
+		out = TypedOutletHandle< T >( block.getOutletHandle( name ) );
+	}
+
+	void update()
+	{
+		*out = *in;
+	}
+
+	TypedInletHandle< T >		in;
+	TypedOutletHandle< T >		out;
+};
+
 class ThroughputBlock : public Block
 {
 public:
@@ -14,5 +35,20 @@ public:
 
 private:
 
-	BlockHandle			m_pBlockHandle;
+	Throughput< _2Real::FilePath >					m_FilePath;
+	Throughput< _2Real::Number >					m_Number;
+	Throughput< bool >								m_Bool;
+	Throughput< unsigned char >						m_UChar;
+	Throughput< char >								m_Char;
+	Throughput< unsigned short >					m_UShort;
+	Throughput< short >								m_Short;
+	Throughput< unsigned int >						m_UInt;
+	Throughput< int >								m_Int;
+	Throughput< unsigned long >						m_ULong;
+	Throughput< long >								m_Long;
+	Throughput< float >								m_Float;
+	Throughput< double >							m_Double;
+	Throughput< _2Real::Point >						m_Point;
+	Throughput< std::string >						m_String;
+	Throughput< std::vector< _2Real::Number > >		m_Vector;
 };
\ No newline at end of file
@@ -21,6 +21,8 @@
 #include "bundle/_2RealBlockHandle.h"
 #include "bundle/_2RealInletHandle.h"
 #include "bundle/_2RealOutletHandle.h"
+#include "bundle/_2RealTypedInletHandle.h"
+#include "bundle/_2RealTypedOutletHandle.h"
 #include "helpers/_2RealException.h"
 #include "_2RealDatatypes.h"
 
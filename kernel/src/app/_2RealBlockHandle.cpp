@@ -121,6 +121,50 @@ namespace _2Real
 			m_Block->updateWithFixedRate( updatesPerSecond );
 		}
 
+		unsigned long BlockHandle::getSkippedDeadlines() const
+		{
+			checkValidity( m_Block );
+			return m_Block->getSkippedDeadlines();
+		}
+
+		BlockMetrics BlockHandle::getMetrics() const
+		{
+			checkValidity( m_Block );
+			BlockMetrics metrics;
+			m_Block->getMetrics( metrics );
+			return metrics;
+		}
+
+		void BlockHandle::resetMetrics()
+		{
+			checkValidity( m_Block );
+			m_Block->resetMetrics();
+		}
+
+		void BlockHandle::setPriority( const BlockPriority::Priority priority )
+		{
+			checkValidity( m_Block );
+			m_Block->setPriority( priority );
+		}
+
+		BlockPriority::Priority BlockHandle::getPriority() const
+		{
+			checkValidity( m_Block );
+			return m_Block->getPriority();
+		}
+
+		void BlockHandle::setDeadline( const long microseconds )
+		{
+			checkValidity( m_Block );
+			m_Block->setDeadline( microseconds );
+		}
+
+		void BlockHandle::setThreadPool( std::string const& name )
+		{
+			checkValidity( m_Block );
+			m_Block->setThreadPool( name );
+		}
+
 		void BlockHandle::setup()
 		{
 			checkValidity( m_Block );
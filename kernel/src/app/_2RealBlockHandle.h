@@ -19,6 +19,8 @@
 #pragma once
 
 #include "app/_2RealCallbacks.h"
+#include "app/_2RealBlockMetrics.h"
+#include "engine/_2RealBlockPriority.h"
 
 #include <vector>
 #include <string>
@@ -72,6 +74,24 @@ namespace _2Real
 
 			// negative or zero: no time based update at all
 			void setUpdateRate( const double updatesPerSecond );
+			// number of update rate deadlines that passed without an update ( block too slow, or timer too late )
+			unsigned long getSkippedDeadlines() const;
+
+			// profiling counters since creation or the last reset, see BlockMetrics
+			BlockMetrics getMetrics() const;
+			void resetMetrics();
+
+			// ready blocks are updated earliest deadline first: an update request's deadline is the time it was
+			// issued plus the block's relative deadline, which defaults to 2 / 20 / 100 ms for high / normal / low priority.
+			// use high priority for output critical blocks, low priority for heavy analysis
+			void setPriority( const BlockPriority::Priority priority );
+			BlockPriority::Priority getPriority() const;
+			// relative deadline in microseconds, zero restores the priority's default
+			void setDeadline( const long microseconds );
+
+			// moves the block to a thread pool created with Engine::createThreadPool, an empty name means the default pool.
+			// the block must not be running or belong to a frame group
+			void setThreadPool( std::string const& name );
 
 			void setup();										// will stop the block and then set it up -> a new start is needed
 			void start();
@@ -0,0 +1,52 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#pragma once
+
+namespace _2Real
+{
+	namespace app
+	{
+		// snapshot of a block's profiling counters, all times in microseconds
+		struct BlockMetrics
+		{
+			enum { HistogramBuckets = 24 };
+
+			BlockMetrics() :
+				updates( 0 ), updatesPerSecond( 0.0 ), averageUpdateTime( 0 ), maxUpdateTime( 0 ),
+				averageQueueWait( 0 ), maxQueueWait( 0 ), averageTriggerLatency( 0 ), maxTriggerLatency( 0 ),
+				averagePublishTime( 0 ), maxPublishTime( 0 ), droppedInletItems( 0 ), skippedDeadlines( 0 )
+			{
+				for ( unsigned int i=0; i<HistogramBuckets; ++i ) updateTimeHistogram[ i ] = 0;
+			}
+
+			unsigned long		updates;
+			double				updatesPerSecond;		// averaged over at least the last second
+			long				averageUpdateTime;		// time spent in the block's update()
+			long				maxUpdateTime;
+			unsigned long		updateTimeHistogram[ HistogramBuckets ];	// bucket i: updates that took less than 2^i us ( & at least 2^(i-1) ), the last one is open
+			long				averageQueueWait;		// time a request spent in the thread pool before a worker picked it up
+			long				maxQueueWait;
+			long				averageTriggerLatency;	// first fulfilled trigger condition -> start of the update
+			long				maxTriggerLatency;
+			long				averagePublishTime;		// time spent publishing the outlets ( incl. notifying all receivers )
+			long				maxPublishTime;
+			unsigned long		droppedInletItems;		// summed over all inlets, see OverflowPolicy
+			unsigned long		skippedDeadlines;		// see BlockHandle::getSkippedDeadlines
+		};
+	}
+}
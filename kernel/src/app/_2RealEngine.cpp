@@ -19,12 +19,15 @@
 #include "app/_2RealEngine.h"
 #include "app/_2RealAppData.h"
 #include "engine/_2RealEngineImpl.h"
+#include "engine/_2RealLogger.h"
+#include "engine/_2RealTracer.h"
 #include "engine/_2RealLink.h"
 #include "engine/_2RealInlet.h"
 #include "engine/_2RealOutlet.h"
 #include "engine/_2RealAbstractIOManager.h"
 #include "engine/_2RealFunctionBlock.h"
 #include "helpers/_2RealSingletonHolder.h"
+#include "helpers/_2RealThreadAffinity.h"
 #include "xml/_2RealXMLWriter.h"
 #include "_2RealConfigLoader.h"
 
@@ -70,6 +73,91 @@ namespace _2Real
 			m_EngineImpl.clearBlockInstances();
 		}
 
+		BufferPoolStatistics Engine::getBufferPoolStatistics() const
+		{
+			return BufferPool::getStatistics();
+		}
+
+		void Engine::setBufferPoolLimit( const size_t maxCachedBytes )
+		{
+			BufferPool::setMaxCachedBytes( maxCachedBytes );
+		}
+
+		void Engine::clearBufferPool()
+		{
+			BufferPool::clear();
+		}
+
+		void Engine::setLogLevel( const LogLevel::Level level )
+		{
+			m_EngineImpl.getLogger().setLevel( level );
+		}
+
+		LogLevel::Level Engine::getLogLevel() const
+		{
+			return m_EngineImpl.getLogger().getLevel();
+		}
+
+		void Engine::setLogCategories( const unsigned int categories )
+		{
+			m_EngineImpl.getLogger().setCategories( categories );
+		}
+
+		void Engine::setMetricsLogging( const bool enabled )
+		{
+			m_EngineImpl.setMetricsLogging( enabled );
+		}
+
+		void Engine::createThreadPool( std::string const& name, std::vector< unsigned int > const& cpus, const unsigned int numThreads )
+		{
+			m_EngineImpl.createThreadPool( name, cpus, numThreads );
+		}
+
+		void Engine::destroyThreadPool( std::string const& name )
+		{
+			m_EngineImpl.destroyThreadPool( name );
+		}
+
+		unsigned int Engine::getNumberOfNumaNodes() const
+		{
+			return ThreadAffinity::getNumberOfNumaNodes();
+		}
+
+		std::vector< unsigned int > Engine::getCpusOfNumaNode( const unsigned int node ) const
+		{
+			return ThreadAffinity::getCpusOfNumaNode( node );
+		}
+
+		void Engine::startTracing( const unsigned int maxEventsPerThread )
+		{
+			Tracer::start( maxEventsPerThread );
+		}
+
+		unsigned long Engine::stopTracing( std::string const& filePath )
+		{
+			return Tracer::stop( filePath );
+		}
+
+		unsigned int Engine::createFrameGroup( BlockHandles const& blocks, const double framesPerSecond )
+		{
+			return m_EngineImpl.createFrameGroup( blocks, framesPerSecond );
+		}
+
+		void Engine::destroyFrameGroup( const unsigned int id )
+		{
+			m_EngineImpl.destroyFrameGroup( id );
+		}
+
+		unsigned int Engine::fuseLinearChains()
+		{
+			return m_EngineImpl.fuseLinearChains();
+		}
+
+		void Engine::unfuseLinearChains()
+		{
+			m_EngineImpl.unfuseLinearChains();
+		}
+
 		BundleHandle & Engine::loadBundle( string const& libraryPath )
 		{
 			return m_EngineImpl.loadLibrary( libraryPath ).getHandle();
@@ -24,6 +24,8 @@
 #include "app/_2RealOutletHandle.h"
 #include "app/_2RealBundleHandle.h"
 #include "app/_2RealBlockHandle.h"
+#include "helpers/_2RealBufferPool.h"
+#include "engine/_2RealLogLevel.h"
 
 #include <string>
 #include <set>
@@ -138,6 +140,54 @@ namespace _2Real
 			// returns the difference to the previous system state
 			SystemState *loadConfiguration( std::string const& dataSource );
 
+			// images & audio buffers allocate their payloads from a process wide pool:
+			// a steady-state pipeline should show a growing number of hits & a constant number of misses
+			BufferPoolStatistics	getBufferPoolStatistics() const;
+			// upper limit for the memory held by released buffers, default is 256 MB
+			void					setBufferPoolLimit( const size_t maxCachedBytes );
+			// frees all currently unused buffers
+			void					clearBufferPool();
+
+			// the engine logs to EngineLog.txt; default level is info, per update cycle messages need debug
+			void					setLogLevel( const LogLevel::Level level );
+			LogLevel::Level			getLogLevel() const;
+			// or'ed LogCategory::Category values, default is all
+			void					setLogCategories( const unsigned int categories );
+
+			// writes the metrics of all blocks to the log every 5 seconds ( level info ), off by default
+			void					setMetricsLogging( const bool enabled );
+
+			// additional thread pools, e.g. one per cpu socket: the workers are pinned to the given cpus ( none: not pinned )
+			// & allocate frame buffers on the numa node of those cpus. numThreads 0 means one worker per cpu.
+			// blocks are moved there with BlockHandle::setThreadPool; a pool can't be destroyed while blocks use it
+			void					createThreadPool( std::string const& name, std::vector< unsigned int > const& cpus, const unsigned int numThreads = 0 );
+			void					destroyThreadPool( std::string const& name );
+			unsigned int			getNumberOfNumaNodes() const;
+			std::vector< unsigned int >		getCpusOfNumaNode( const unsigned int node ) const;
+
+			// records setup, update, trigger, inlet receive & outlet notify events of all threads into a timeline;
+			// stopTracing writes it as chrome trace json ( open in chrome://tracing or ui.perfetto.dev ) and returns
+			// the number of events. a thread that records more than maxEventsPerThread events drops the rest
+			void					startTracing( const unsigned int maxEventsPerThread = 65536 );
+			unsigned long			stopTracing( std::string const& filePath );
+
+			// frame mode: the blocks are updated by one clock, in the order given by the links between them -
+			// independent blocks in parallel, a block right after the blocks it depends on. within the frame,
+			// inlets read the outlets of their predecessors directly; update rates & inlet policies are ignored.
+			// the blocks must be set up, but not started ( and can't be started while grouped ); removing
+			// one of them or changing links to their inlets destroys the group. throws if the links contain a cycle
+			unsigned int			createFrameGroup( BlockHandles const& blocks, const double framesPerSecond );
+			void					destroyFrameGroup( const unsigned int id );
+
+			// fuses linear chains: a link from an outlet that feeds nothing else into the only linked inlet of a block that
+			// has no update rate & a newer data policy; other inlets may only be set by the application & must not have
+			// an and-newer-data policy. the downstream block is then updated right after the upstream block ( also after
+			// a single step ), by the same thread, without going through inlet buffer & scheduler. only blocks that are not
+			// running and not in a frame group are considered; changing links to a fused inlet or removing one of the
+			// blocks undoes the fusion. returns the number of links that were fused
+			unsigned int			fuseLinearChains();
+			void					unfuseLinearChains();
+
 		private:
 
 			void registerToExceptionInternal( BlockExcCallback &cb );
@@ -180,6 +180,36 @@ namespace _2Real
 			( *m_InletIO )[ 0 ].setBufferSize( size );
 		}
 
+		void InletHandle::setOverflowPolicy( OverflowPolicy const& policy )
+		{
+			checkValidity( m_InletIO );
+			( *m_InletIO )[ 0 ].setOverflowPolicy( policy );
+		}
+
+		unsigned long InletHandle::getOverflowCount() const
+		{
+			checkValidity( m_InletIO );
+			return ( *m_InletIO )[ 0 ].getOverflowCount();
+		}
+
+		void InletHandle::setBatchDelivery( const bool enabled )
+		{
+			checkValidity( m_InletIO );
+			( *m_InletIO )[ 0 ].setBatchDelivery( enabled );
+		}
+
+		void InletHandle::setImageFormat( ImageType const& type, ImageChannelOrder const& order, const double scale )
+		{
+			checkValidity( m_InletIO );
+			( *m_InletIO )[ 0 ].setImageFormat( ImageFormat( type, order, scale ) );
+		}
+
+		void InletHandle::clearImageFormat()
+		{
+			checkValidity( m_InletIO );
+			( *m_InletIO )[ 0 ].clearImageFormat();
+		}
+
 		std::string const& InletHandle::getName() const
 		{
 			checkValidity( m_InletIO );
@@ -21,6 +21,7 @@
 #include "helpers/_2RealAny.h"
 #include "helpers/_2RealOptions.h"
 #include "engine/_2RealInletPolicy.h"
+#include "engine/_2RealOverflowPolicy.h"
 
 namespace _2Real
 {
@@ -95,6 +96,24 @@ namespace _2Real
 
 			void				setBufferSize( const unsigned int size );
 
+			// what happens to data that arrives while the buffer is full, default is drop oldest;
+			// block producer also carries how long a sender may wait for a free slot
+			void				setOverflowPolicy( OverflowPolicy const& policy );
+			// number of data items that were discarded because the buffer was full
+			unsigned long		getOverflowCount() const;
+
+			// if enabled, the block sees all data items that arrived since its last update ( bundle::InletHandle::getBatchSize ),
+			// and the trigger condition is evaluated once per batch. a batch holds at most buffer size items, so raise it as well;
+			// items beyond that are handled by the overflow policy ( drop oldest discards the batch's oldest items )
+			void				setBatchDelivery( const bool enabled );
+
+			// image inlets: received images are converted to this depth & channel order ( see ImageConversion ),
+			// values are multiplied by scale, <= 0 maps the full range of the source type onto the target type.
+			// conversion happens on the block's thread, right before the update that takes the image.
+			// linkWithConversion sets the format of the inlet's initial value, unless there is one already
+			void				setImageFormat( ImageType const& type, ImageChannelOrder const& order, const double scale = 0. );
+			void				clearImageFormat();
+
 			template< typename TData >
 			std::set< Option< TData > > getOptionMapping() const
 			{
@@ -138,6 +138,18 @@ namespace _2Real
 			EngineImpl::instance().destroyLink( inlet.m_InletIO->operator[]( 0 ), *m_OutletIO );
 		}
 
+		void OutletHandle::setParallelFanOut( const bool enabled )
+		{
+			checkValidity( m_OutletIO );
+			m_OutletIO->m_IsParallelFanOut.store( enabled ? 1 : 0 );
+		}
+
+		bool OutletHandle::isParallelFanOut() const
+		{
+			checkValidity( m_OutletIO );
+			return ( m_OutletIO->m_IsParallelFanOut.load() != 0 );
+		}
+
 		void OutletHandle::registerToNewData( OutletDataCallback callback, void *userData ) const
 		{
 			checkValidity( m_OutletIO );
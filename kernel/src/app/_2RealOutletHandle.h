@@ -59,6 +59,11 @@ namespace _2Real
 			bool linkWithConversion( InletHandle &inletHandle );
 			void unlinkFrom( InletHandle &inletHandle );
 
+			// deliver new data to all linked inlets in parallel, on the thread pool of the owning block;
+			// pays off for outlets with many receivers, whose buffers & trigger policies are then run concurrently
+			void setParallelFanOut( const bool enabled );
+			bool isParallelFanOut() const;
+
 			AppData				getLastOutput() const;
 
 			void registerToNewData( OutletDataCallback callback, void *userData = nullptr ) const;
@@ -18,7 +18,6 @@
 
 #include "bundle/_2RealBlockHandle.h"
 #include "engine/_2RealFunctionBlockIOManager.h"
-#include "helpers/_2RealStringHelpers.h"
 
 using std::string;
 
@@ -86,13 +85,37 @@ namespace _2Real
 		InletHandle & BlockHandle::getInletHandle( string const& name ) const
 		{
 			checkValidity( m_IO );
-			return m_IO->getBundleInletHandle( trim ( name ) );
+			return m_IO->getBundleInletHandle( name );
 		}
 
 		OutletHandle & BlockHandle::getOutletHandle( string const& name ) const
 		{
 			checkValidity( m_IO );
-			return m_IO->getBundleOutletHandle( trim ( name ) );
+			return m_IO->getBundleOutletHandle( name );
+		}
+
+		unsigned int BlockHandle::getInletIndex( string const& name ) const
+		{
+			checkValidity( m_IO );
+			return m_IO->getInletIndex( name );
+		}
+
+		unsigned int BlockHandle::getOutletIndex( string const& name ) const
+		{
+			checkValidity( m_IO );
+			return m_IO->getOutletIndex( name );
+		}
+
+		InletHandle & BlockHandle::getInletHandle( const unsigned int index ) const
+		{
+			checkValidity( m_IO );
+			return m_IO->getBundleInletHandle( index );
+		}
+
+		OutletHandle & BlockHandle::getOutletHandle( const unsigned int index ) const
+		{
+			checkValidity( m_IO );
+			return m_IO->getBundleOutletHandle( index );
 		}
 
 		BlockHandle::InletHandles const& BlockHandle::getAllInletHandles() const
@@ -106,5 +129,11 @@ namespace _2Real
 			checkValidity( m_IO );
 			return m_IO->getBundleOutletHandles();
 		}
+
+		void BlockHandle::parallelFor( const unsigned int count, AbstractCallback< const unsigned int > &body ) const
+		{
+			checkValidity( m_IO );
+			m_IO->getParallelExecutor().parallelFor( count, body );
+		}
 	}
 }
\ No newline at end of file
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "helpers/_2RealParallelFor.h"
+
 #include <string>
 #include <vector>
 
@@ -50,11 +52,30 @@ namespace _2Real
 			BlockHandle& operator=( BlockHandle const& src );
 			~BlockHandle();
 
+			// names are case insensitive; the lookup is cheap, but resolving the handles once in setup() is cheaper still
 			InletHandle &			getInletHandle( std::string const& name ) const;
 			OutletHandle &			getOutletHandle( std::string const& name ) const;
+
+			// inlets & outlets are numbered in the order the bundle's metainfo defines them
+			unsigned int			getInletIndex( std::string const& name ) const;
+			unsigned int			getOutletIndex( std::string const& name ) const;
+			InletHandle &			getInletHandle( const unsigned int index ) const;
+			OutletHandle &			getOutletHandle( const unsigned int index ) const;
 			InletHandles const&		getAllInletHandles() const;
 			OutletHandles const&	getAllOutletHandles() const;
 
+			// runs body.invoke( i ) for every i in [ 0, count ) and returns once all are done; the calling thread
+			// works on the items together with the idle workers of the engine's thread pool, so a single heavy
+			// update() can use free cores without oversubscribing the machine. the first exception is rethrown
+			void					parallelFor( const unsigned int count, AbstractCallback< const unsigned int > &body ) const;
+
+			template< typename TCallable >
+			void parallelFor( const unsigned int count, TCallable &callable, typename MemberCallback< TCallable, const unsigned int >::Callback method ) const
+			{
+				MemberCallback< TCallable, const unsigned int > body( callable, method );
+				parallelFor( count, body );
+			}
+
 			bool isValid() const;
 			void invalidate();
 
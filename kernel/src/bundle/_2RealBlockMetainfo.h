@@ -51,7 +51,7 @@ namespace _2Real
 			template< typename TData >
 			void addInlet( std::string const& name, TData initialValue, InletPolicy const& defaultPolicy = InletPolicy::ALWAYS )
 			{
-				addInletInternal( name, createTypeDescriptor< TData >(), Any( initialValue ), AnyOptionSet(), defaultPolicy );
+				addInletInternal( name, getTypeDescriptor< TData >(), Any( initialValue ), AnyOptionSet(), defaultPolicy );
 			}
 
 			template< typename TData >
@@ -60,7 +60,7 @@ namespace _2Real
 			template< typename TData >
 			void addMultiInlet( std::string const& name, TData initialValue, InletPolicy const& defaultPolicy = InletPolicy::ALWAYS )
 			{
-				addMultiInletInternal( name, createTypeDescriptor< TData >(), Any( initialValue ), AnyOptionSet(), defaultPolicy );
+				addMultiInletInternal( name, getTypeDescriptor< TData >(), Any( initialValue ), AnyOptionSet(), defaultPolicy );
 			}
 
 			template< typename TData >
@@ -69,7 +69,7 @@ namespace _2Real
 			template< typename TData >
 			void addOutlet( std::string const& name )
 			{
-				addOutletInternal( name, createTypeDescriptor< TData >(), Any( TData() ) );
+				addOutletInternal( name, getTypeDescriptor< TData >(), Any( TData() ) );
 			}
 
 		private:
@@ -85,13 +85,13 @@ namespace _2Real
 		template< >
 		inline void BlockMetainfo::addInlet< int >( std::string const& name, int initialValue, Options< int > const& options, InletPolicy const& defaultPolicy )
 		{
-			addInletInternal( name, createTypeDescriptor< int >(), Any( initialValue ), AnyOptionSet( options ), defaultPolicy );
+			addInletInternal( name, getTypeDescriptor< int >(), Any( initialValue ), AnyOptionSet( options ), defaultPolicy );
 		}
 
 		template< >
 		inline void BlockMetainfo::addMultiInlet< int >( std::string const& name, int initialValue, Options< int > const& options, InletPolicy const& defaultPolicy )
 		{
-			addMultiInletInternal( name, createTypeDescriptor< int >(), Any( initialValue ), AnyOptionSet( options ), defaultPolicy );
+			addMultiInletInternal( name, getTypeDescriptor< int >(), Any( initialValue ), AnyOptionSet( options ), defaultPolicy );
 		}
 	}
 }
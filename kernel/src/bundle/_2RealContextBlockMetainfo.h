@@ -48,7 +48,7 @@ namespace _2Real
 			template< typename TData >
 			void addOutlet( std::string const& name )
 			{
-				addOutletInternal( name, createTypeDescriptor< TData >(), Any( TData() ) );
+				addOutletInternal( name, getTypeDescriptor< TData >(), Any( TData() ) );
 			}
 
 		private:
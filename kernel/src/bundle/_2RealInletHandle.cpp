@@ -87,12 +87,31 @@ namespace _2Real
 			return ( *m_Inlet )[ index ].getHandle();
 		}
 
-		Any InletHandle::getCurrentData() const
+		Any const& InletHandle::getCurrentData() const
 		{
 			checkValidity( m_Inlet );
 			return ( *m_Inlet )[ 0 ].getCurrentData().anyValue;
 		}
 
+		unsigned int InletHandle::getBatchSize() const
+		{
+			checkValidity( m_Inlet );
+			return static_cast< unsigned int >( ( *m_Inlet )[ 0 ].getCurrentBatch().size() );
+		}
+
+		Any const& InletHandle::getBatchData( const unsigned int index ) const
+		{
+			checkValidity( m_Inlet );
+			TimestampedDataBatch const& batch = ( *m_Inlet )[ 0 ].getCurrentBatch();
+			if ( index >= batch.size() )
+			{
+				std::ostringstream msg;
+				msg << "batch index " << index << " is out of range, batch size is " << batch.size();
+				throw OutOfRangeException( msg.str() );
+			}
+			return batch[ index ].anyValue;
+		}
+
 		bool InletHandle::hasUpdated() const
 		{
 			checkValidity( m_Inlet );
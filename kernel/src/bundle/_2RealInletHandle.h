@@ -29,9 +29,15 @@ namespace _2Real
 
 	namespace bundle
 	{
+		template< typename TData >
+		class TypedInletHandle;
+
 		class InletHandle
 		{
 
+			template< typename TData >
+			friend class TypedInletHandle;
+
 		public:
 
 			InletHandle();
@@ -50,7 +56,7 @@ namespace _2Real
 					throw UninitializedHandleException( msg.str() );
 				}
 
-				Any curr = getCurrentData();
+				Any const& curr = getCurrentData();
 				TData const& data = curr.extract< TData >();
 				return data;
 			}
@@ -65,11 +71,30 @@ namespace _2Real
 					throw UninitializedHandleException( msg.str() );
 				}
 
-				Any curr = getCurrentData();
+				Any const& curr = getCurrentData();
 				TData const& data = curr.extract< TData >();
 				return new TData( data );
 			}
 
+			// batched delivery ( see app::InletHandle::setBatchDelivery ): all items received since the last update,
+			// oldest first - the last one is also the current data. always 0 if batched delivery is disabled
+			unsigned int getBatchSize() const;
+
+			template< typename TData >
+			TData const& getBatchItem( const unsigned int index ) const
+			{
+				if ( m_Inlet == nullptr )
+				{
+					std::ostringstream msg;
+					msg << "input handle not initialized";
+					throw UninitializedHandleException( msg.str() );
+				}
+
+				Any const& item = getBatchData( index );
+				TData const& data = item.extract< TData >();
+				return data;
+			}
+
 			bool isValid() const;
 			void invalidate();
 
@@ -85,7 +110,8 @@ namespace _2Real
 
 		private:
 
-			Any					getCurrentData() const;
+			Any const&			getCurrentData() const;
+			Any const&			getBatchData( const unsigned int index ) const;
 			AbstractInlet		*m_Inlet;
 
 		};
@@ -85,6 +85,11 @@ namespace _2Real
 			return m_Outlet->getWriteableData();
 		}
 
+		TypeDescriptor const& OutletHandle::getTypeDescriptor() const
+		{
+			return m_Outlet->getTypeDescriptor();
+		}
+
 		void OutletHandle::discard()
 		{
 			checkValidity( m_Outlet );
@@ -29,9 +29,15 @@ namespace _2Real
 
 	namespace bundle
 	{
+		template< typename TData >
+		class TypedOutletHandle;
+
 		class OutletHandle
 		{
 
+			template< typename TData >
+			friend class TypedOutletHandle;
+
 		public:
 
 			OutletHandle();
@@ -62,8 +68,10 @@ namespace _2Real
 
 		private:
 
-			Any &		getCurrentData();
-			Outlet				*m_Outlet;
+			Any &					getCurrentData();
+			// no side effects, unlike getCurrentData, which detaches & marks the outlet as written
+			TypeDescriptor const&	getTypeDescriptor() const;
+			Outlet					*m_Outlet;
 
 		};
 	}
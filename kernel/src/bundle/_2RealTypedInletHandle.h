@@ -0,0 +1,80 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include "bundle/_2RealInletHandle.h"
+
+#include <sstream>
+
+namespace _2Real
+{
+	namespace bundle
+	{
+		// an inlet handle bound to the inlet's datatype. the type is checked once, when the handle is created
+		// ( typically in setup ), every access afterwards is a plain pointer dereference: no type check, no
+		// virtual call, no locking. the reference stays valid for the lifetime of the block, its value changes
+		// from one update to the next. only for basic inlets - use operator[] of the multi inlet's InletHandle
+		// to get at its subinlets, but keep in mind that those may be removed between updates
+		template< typename TData >
+		class TypedInletHandle
+		{
+
+		public:
+
+			TypedInletHandle() : m_Data( nullptr ) {}
+
+			explicit TypedInletHandle( InletHandle const& handle ) :
+				m_Handle( handle ),
+				m_Data( nullptr )
+			{
+				if ( m_Handle.isMultiInlet() )
+				{
+					throw TypeMismatchException( "typed inlet handle: inlet is a multi inlet, use one of its subinlets" );
+				}
+
+				Any const& data = m_Handle.getCurrentData();
+				if ( !data.isDatatype< TData >() )
+				{
+					std::ostringstream msg;
+					msg << "typed inlet handle: inlet's type " << data.getTypeDescriptor().m_TypeName << " does not match template parameter";
+					throw TypeMismatchException( msg.str() );
+				}
+				m_Data = &data;
+			}
+
+			TData const& getReadableRef() const
+			{
+				return m_Data->extractUnchecked< TData >();
+			}
+
+			TData const& operator*() const			{ return getReadableRef(); }
+			TData const* operator->() const			{ return &getReadableRef(); }
+
+			bool hasUpdated() const					{ return m_Handle.hasUpdated(); }
+			bool hasChanged() const					{ return m_Handle.hasChanged(); }
+			bool isValid() const					{ return m_Data != nullptr && m_Handle.isValid(); }
+
+		private:
+
+			InletHandle			m_Handle;
+			Any const			*m_Data;		// the inlet's current data, same address for the lifetime of the inlet
+
+		};
+	}
+}
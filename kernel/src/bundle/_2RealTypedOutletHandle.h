@@ -0,0 +1,75 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include "bundle/_2RealOutletHandle.h"
+
+#include <sstream>
+
+namespace _2Real
+{
+	namespace bundle
+	{
+		// an outlet handle bound to the outlet's datatype. the type is checked once, when the handle is created
+		// ( typically in setup ), an access afterwards costs one non virtual call - the outlet's copy on write
+		// check - but no type check & no locking. the reference is valid until the end of the current update:
+		// the outlet may swap buffers between updates, so get it anew in every update
+		template< typename TData >
+		class TypedOutletHandle
+		{
+
+		public:
+
+			TypedOutletHandle() {}
+
+			explicit TypedOutletHandle( OutletHandle const& handle ) :
+				m_Handle( handle )
+			{
+				if ( !m_Handle.isValid() )
+				{
+					throw UninitializedHandleException( "typed outlet handle: outlet handle not initialized" );
+				}
+
+				TypeDescriptor const& type = m_Handle.getTypeDescriptor();
+				if ( !type.isSameType( *_2Real::getTypeDescriptor< TData >() ) )
+				{
+					std::ostringstream msg;
+					msg << "typed outlet handle: outlet's type " << type.m_TypeName << " does not match template parameter";
+					throw TypeMismatchException( msg.str() );
+				}
+			}
+
+			TData & getWriteableRef()
+			{
+				return m_Handle.getCurrentData().extractUnchecked< TData >();
+			}
+
+			TData & operator*()						{ return getWriteableRef(); }
+			TData * operator->()					{ return &getWriteableRef(); }
+
+			void discard()							{ m_Handle.discard(); }
+			bool isValid() const					{ return m_Handle.isValid(); }
+
+		private:
+
+			OutletHandle		m_Handle;
+
+		};
+	}
+}
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "helpers/_2RealException.h"
+#include "helpers/_2RealBufferPool.h"
 
 #include <memory>
 
@@ -35,15 +36,17 @@ namespace _2Real
 
 		AudioBuffer() :
 			m_SampleRate( 0 ), m_ChannelCount( 0 ), m_SampleCount( 0 ), m_SizeInBytes( 0 ), m_BitResolution( 0 ),
-			m_PresentationTimestamp( 0 ), m_Data( nullptr ), m_Deleter( new NullDeleter< unsigned char > )
+			m_PresentationTimestamp( 0 ), m_Data( nullptr ), m_IsDataOwner( false )
 		{
 		}
 
+		// copies share the pooled buffer of the source, the first non-const access detaches
 		AudioBuffer( AudioBuffer const& src ) :
 			m_SampleRate( src.m_SampleRate ), m_ChannelCount( src.m_ChannelCount ), m_SampleCount( src.m_SampleCount ),
-			m_SizeInBytes( src.m_SizeInBytes ), m_BitResolution( src.m_BitResolution ), m_PresentationTimestamp( src.m_PresentationTimestamp )
+			m_SizeInBytes( src.m_SizeInBytes ), m_BitResolution( src.m_BitResolution ), m_PresentationTimestamp( src.m_PresentationTimestamp ),
+			m_Data( nullptr ), m_IsDataOwner( false )
 		{
-			makeCopy( src.m_Data, m_SizeInBytes );
+			shareData( src );
 		}
 
 		AudioBuffer& operator=( AudioBuffer const& src )
@@ -57,10 +60,7 @@ namespace _2Real
 			m_BitResolution= src.m_BitResolution;
 			m_PresentationTimestamp = src.m_PresentationTimestamp;
 
-			m_Deleter->safeDelete( m_Data );
-			delete m_Deleter;
-
-			makeCopy( src.m_Data, m_SizeInBytes );
+			shareData( src );
 
 			return *this;
 		}
@@ -69,30 +69,44 @@ namespace _2Real
 			const unsigned int channelCount, const unsigned int bitResolution, double pts ) :
 			m_SampleRate( sampleRate ), m_ChannelCount( channelCount ), m_SampleCount( sampleCount ),
 			m_SizeInBytes( size ), m_BitResolution( bitResolution ), m_PresentationTimestamp( pts ), m_Data( data ),
-			m_Deleter( owns ? static_cast< Deleter< unsigned char > * >( new ArrayDeleter< unsigned char > ) : new NullDeleter< unsigned char > )
+			m_IsDataOwner( owns )
 		{
 		}
 
 		~AudioBuffer()
 		{
-			m_Deleter->safeDelete( m_Data );
-			delete m_Deleter;
+			releaseOwnedData();
 		}
 
+		// owned data is adopted, anything else is copied into a pooled buffer
 		void assign( unsigned char * data, bool owns, const long size, const unsigned int sampleRate, const unsigned int sampleCount,
 			const unsigned int channelCount, const unsigned int bitResolution, double pts )
 		{
 			m_SampleRate = sampleRate;
-			m_ChannelCount = sampleCount;
-			m_SampleCount = channelCount;
+			m_ChannelCount = channelCount;
+			m_SampleCount = sampleCount;
 			m_SizeInBytes = size;
 			m_BitResolution= bitResolution;
 			m_PresentationTimestamp = pts;
 
-			m_Deleter->safeDelete( m_Data );
-			delete m_Deleter;
+			if ( data == m_Data )
+			{
+				if ( owns && m_Buffer.isNull() ) m_IsDataOwner = true;
+				return;
+			}
 
-			makeCopy( data, m_SizeInBytes );
+			releaseOwnedData();
+			if ( owns || data == nullptr )
+			{
+				m_Buffer.reset();
+				m_Data = data;
+				m_IsDataOwner = owns && data != nullptr;
+			}
+			else
+			{
+				m_Buffer.assign( data, m_SizeInBytes );
+				m_Data = m_Buffer.getData();
+			}
 		}
 
 		unsigned int getSampleRate() const			{ return m_SampleRate; }
@@ -102,7 +116,8 @@ namespace _2Real
 		unsigned int getBitResolution() const		{ return m_BitResolution; }
 		double getPresentationTimestamp() const		{ return m_PresentationTimestamp; }
 		unsigned char const* getData() const	    { return m_Data; }  	// NOTE: removed "const" before & to eliminate warnings. Didn't occur necessary to me (ottona)
-		unsigned char *& getData()      			{ return m_Data; }
+		unsigned char *& getData()      			{ detach(); return m_Data; }
+		bool isShared() const						{ return !m_Buffer.isNull() && !m_Buffer.isUnique(); }
 
 		bool operator==( AudioBuffer const& src ) const
 		{
@@ -123,39 +138,39 @@ namespace _2Real
 
 	private:
 
-		void makeCopy( unsigned char const*const data, const unsigned int sz )
+		void releaseOwnedData()
+		{
+			if ( m_IsDataOwner )
+			{
+				delete [] m_Data;
+				m_IsDataOwner = false;
+			}
+			m_Data = nullptr;
+		}
+
+		void shareData( AudioBuffer const& src )
 		{
-			if ( data != nullptr )
+			releaseOwnedData();
+			if ( !src.m_Buffer.isNull() )
 			{
-				m_Deleter = new ArrayDeleter< unsigned char >;
-				m_Data = new unsigned char[ sz ];
-				memcpy( m_Data, data, sz );
+				m_Buffer = src.m_Buffer;
 			}
 			else
 			{
-				m_Data = nullptr;
-				m_Deleter = new NullDeleter< unsigned char >;
+				// user data can't be shared
+				m_Buffer.assign( src.m_Data, m_SizeInBytes );
 			}
+			m_Data = m_Buffer.getData();
 		}
 
-		template< typename TData >
-		struct Deleter
-		{
-			virtual void safeDelete( TData *& data) const = 0;
-			virtual ~Deleter() {}
-		};
-
-		template< typename TData >
-		struct NullDeleter : public Deleter< TData >
+		void detach()
 		{
-			void safeDelete( TData *& data) const {}
-		};
-
-		template< typename TData >
-		struct ArrayDeleter : public Deleter< TData >
-		{
-			void safeDelete( TData *& data) const { delete [] data; data = nullptr; }
-		};
+			if ( isShared() )
+			{
+				m_Buffer.makeUnique( m_SizeInBytes );
+				m_Data = m_Buffer.getData();
+			}
+		}
 
 		unsigned int				m_SampleRate;
 		unsigned int				m_ChannelCount;
@@ -164,7 +179,8 @@ namespace _2Real
 		unsigned int				m_BitResolution;
 		double						m_PresentationTimestamp;
 		unsigned char				*m_Data;
-		Deleter< unsigned char >	*m_Deleter;
+		bool						m_IsDataOwner;
+		SharedBuffer				m_Buffer;
 
 	};
 }
@@ -21,31 +21,15 @@
 
 #include "datatypes/_2RealImageT.h"
 #include "helpers/_2RealHelpers.h"
+#include "helpers/_2RealBufferPool.h"
+#include "helpers/_2RealContentHash.h"
+#include "helpers/_2RealException.h"
+
+#include <string.h>
+#include <algorithm>
 
 namespace _2Real
 {
-	template< typename TData >
-	class Deleter
-	{
-	public:
-		virtual void safeDelete( TData *& data) const = 0;
-		virtual ~Deleter() {}
-	};
-
-	template< typename TData >
-	class NullDeleter : public Deleter< TData >
-	{
-	public:
-		void safeDelete( TData *& data) const {}
-	};
-
-	template< typename TData >
-	class ArrayDeleter : public Deleter< TData >
-	{
-	public:
-		void safeDelete( TData *& data) const { delete [] data; data = nullptr; }
-	};
-
 	class ImageType
 	{
 
@@ -126,6 +110,11 @@ namespace _2Real
 	inline bool operator!=( const ImageType &lhs, ImageType::IMAGE_TYPE rhs )		{	return lhs.m_ImageType != rhs;	}
 	inline bool operator!=( ImageType::IMAGE_TYPE lhs, const ImageType &rhs )		{	return lhs != rhs.m_ImageType;	}
 
+	// the payload is either an array handed over by the user ( owns == true: adopted, no copy )
+	// or a pooled buffer; copies share the pooled buffer, which is detached on the first non-const access.
+	// non-owned user data is copied into the pool, b/c its lifetime is unknown.
+	// rows are getRowPitch() bytes apart, which is more than a row's pixels for images with padded rows
+	// ( see allocate ) and for sub images, which are views into the pooled buffer of their parent
 	class Image
 	{
 
@@ -133,39 +122,32 @@ namespace _2Real
 
 		Image() :
 			m_Data( nullptr ),
+			m_IsDataOwner( false ),
 			m_Width( 0 ),
 			m_Height( 0 ),
+			m_RowPitch( 0 ),
 			m_Size( 0 ),
 			m_ImageType( ImageType::UNSIGNED_BYTE ),
-			m_ChannelOrder( ImageChannelOrder::R ),
-			m_Deleter( new NullDeleter< unsigned char >() )
+			m_ChannelOrder( ImageChannelOrder::R )
 		{
 		}
 
 		~Image()
 		{
-			m_Deleter->safeDelete( m_Data );
-			delete m_Deleter;
+			releaseData();
 		}
 
 		Image( Image const& src ) :
+			m_Data( nullptr ),
+			m_IsDataOwner( false ),
 			m_Width( src.m_Width ),
 			m_Height( src.m_Height ),
+			m_RowPitch( src.m_RowPitch ),
 			m_Size( src.m_Size ),
 			m_ImageType( src.m_ImageType ),
 			m_ChannelOrder( src.m_ChannelOrder )
 		{
-			if ( src.m_Data != nullptr )
-			{
-				m_Deleter = new ArrayDeleter< unsigned char >();
-				m_Data = new unsigned char[ m_Size ];
-				memcpy( m_Data, src.m_Data, m_Size );
-			}
-			else
-			{
-				m_Data = nullptr;
-				m_Deleter = new NullDeleter< unsigned char >();
-			}
+			shareData( src );
 		}
 
 		Image& operator=( Image const& src )
@@ -178,209 +160,366 @@ namespace _2Real
 			m_Size = src.m_Size;
 			m_Width = src.m_Width;
 			m_Height = src.m_Height;
+			m_RowPitch = src.m_RowPitch;
 			m_ChannelOrder = src.m_ChannelOrder;
 			m_ImageType = src.m_ImageType;
 
-			m_Deleter->safeDelete( m_Data );
-			safeDelete( m_Deleter );
-
-			if ( src.m_Data != nullptr )
-			{
-				m_Deleter = new ArrayDeleter< unsigned char >();
-				m_Data = new unsigned char[ m_Size ];
-				memcpy( m_Data, src.m_Data, m_Size );
-			}
-			else
-			{
-				m_Data = nullptr;
-				m_Deleter = new NullDeleter< unsigned char >();
-			}
+			shareData( src );
 
 			return *this;
 		}
 
 		Image( unsigned char *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o ) :
 			m_Data( data ),
+			m_IsDataOwner( owns ),
 			m_Width( w ),
 			m_Height( h ),
+			m_RowPitch( w * o.getNumberOfChannels() * sizeof( unsigned char ) ),
 			m_Size( w * h * o.getNumberOfChannels() * sizeof( unsigned char ) ),
 			m_ImageType( ImageType::UNSIGNED_BYTE ),
-			m_ChannelOrder( o ),
-			m_Deleter( owns ? static_cast< Deleter< unsigned char > * >( new ArrayDeleter< unsigned char > ) : new NullDeleter< unsigned char > )
+			m_ChannelOrder( o )
 		{
 		}
 
 		Image( unsigned short *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o ) :
 			m_Data( reinterpret_cast< unsigned char * >( data ) ),
+			m_IsDataOwner( owns ),
 			m_Width( w ),
 			m_Height( h ),
+			m_RowPitch( w * o.getNumberOfChannels() * sizeof( unsigned short ) ),
 			m_Size( w * h * o.getNumberOfChannels() * sizeof( unsigned short ) ),
 			m_ImageType( ImageType::UNSIGNED_SHORT ),
-			m_ChannelOrder( o ),
-			m_Deleter( owns ? static_cast< Deleter< unsigned char > * >( new ArrayDeleter< unsigned char > ) : new NullDeleter< unsigned char > )
+			m_ChannelOrder( o )
 		{
 		}
 
 		Image( float *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o ) :
 			m_Data( reinterpret_cast< unsigned char * >( data ) ),
+			m_IsDataOwner( owns ),
 			m_Width( w ),
 			m_Height( h ),
+			m_RowPitch( w * o.getNumberOfChannels() * sizeof( float ) ),
 			m_Size( w * h * o.getNumberOfChannels() * sizeof( float ) ),
 			m_ImageType( ImageType::FLOAT ),
-			m_ChannelOrder( o ),
-			m_Deleter( owns ? static_cast< Deleter< unsigned char > * >( new ArrayDeleter< unsigned char > ) : new NullDeleter< unsigned char > )
+			m_ChannelOrder( o )
 		{
 		}
 
 		Image( double *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o ) :
 			m_Data( reinterpret_cast< unsigned char * >( data ) ),
+			m_IsDataOwner( owns ),
 			m_Width( w ),
 			m_Height( h ),
+			m_RowPitch( w * o.getNumberOfChannels() * sizeof( double ) ),
 			m_Size( w * h * o.getNumberOfChannels() * sizeof( double ) ),
 			m_ImageType( ImageType::DOUBLE ),
-			m_ChannelOrder( o ),
-			m_Deleter( owns ? static_cast< Deleter< unsigned char > * >( new ArrayDeleter< unsigned char > ) : new NullDeleter< unsigned char > )
+			m_ChannelOrder( o )
+		{
+		}
+
+		// allocates an uninitialized image from the buffer pool
+		Image( const ImageType type, const unsigned int w, const unsigned int h, const ImageChannelOrder o ) :
+			m_Data( nullptr ),
+			m_IsDataOwner( false ),
+			m_Width( w ),
+			m_Height( h ),
+			m_RowPitch( w * o.getNumberOfChannels() * type.getByteSize() ),
+			m_Size( w * h * o.getNumberOfChannels() * type.getByteSize() ),
+			m_ImageType( type ),
+			m_ChannelOrder( o )
 		{
+			m_Buffer.allocate( m_Size );
+			m_Data = m_Buffer.getData();
 		}
 
 		void assign( unsigned char *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
 		{
-			m_ImageType = ImageType::UNSIGNED_BYTE;
+			setData( data, owns, ImageType::UNSIGNED_BYTE, w, h, o );
+		}
+
+		void assign( unsigned short *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
+		{
+			setData( reinterpret_cast< unsigned char * >( data ), owns, ImageType::UNSIGNED_SHORT, w, h, o );
+		}
+
+		void assign( float *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
+		{
+			setData( reinterpret_cast< unsigned char * >( data ), owns, ImageType::FLOAT, w, h, o );
+		}
+
+		void assign( double *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
+		{
+			setData( reinterpret_cast< unsigned char * >( data ), owns, ImageType::DOUBLE, w, h, o );
+		}
+
+		// re-shapes the image, reusing the current pooled buffer if it is unshared & large enough; contents are undefined afterwards.
+		// with padRows, the pitch is rounded up to a multiple of BufferAlignment, so that every row starts on a cache line
+		void allocate( const ImageType type, const unsigned int w, const unsigned int h, const ImageChannelOrder o, const bool padRows = false )
+		{
+			m_ImageType = type;
 			m_Width = w;
 			m_Height = h;
-			m_Size = ( w * h * o.getNumberOfChannels() * sizeof( unsigned char ) );
 			m_ChannelOrder = o;
+			m_RowPitch = getRowBytes();
+			if ( padRows ) m_RowPitch = ( m_RowPitch + BufferAlignment - 1 ) & ~( BufferAlignment - 1 );
+			m_Size = getSpan();
 
-			m_Deleter->safeDelete( m_Data );
-			safeDelete( m_Deleter );
+			releaseOwnedData();
+			m_Buffer.allocate( m_RowPitch * h );
+			m_Data = m_Buffer.getData();
+		}
 
-			if ( data != nullptr )
+		// view of a region, clipped to the image: shares the pooled buffer & keeps it alive, no pixels are copied.
+		// as with any copy, writing to the view or to its parent detaches the writer.
+		// regions of user data are copied, b/c the user data can't be shared
+		Image getSubImage( const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h ) const
+		{
+			Image result;
+			result.m_ImageType = m_ImageType;
+			result.m_ChannelOrder = m_ChannelOrder;
+			if ( m_Data == nullptr || x >= m_Width || y >= m_Height )
 			{
-				m_Deleter = new ArrayDeleter< unsigned char >();
-				m_Data = new unsigned char[ m_Size ];
-				memcpy( m_Data, data, m_Size );
+				return result;
+			}
+
+			result.m_Width = std::min( w, m_Width - x );
+			result.m_Height = std::min( h, m_Height - y );
+			result.m_RowPitch = m_RowPitch;
+			result.m_Size = result.getSpan();
+
+			unsigned char *origin = m_Data + y * m_RowPitch + x * getPixelBytes();
+			if ( !m_Buffer.isNull() )
+			{
+				result.m_Buffer = m_Buffer;
+				result.m_Data = origin;
 			}
 			else
 			{
-				m_Data = nullptr;
-				m_Deleter = new NullDeleter< unsigned char >();
+				result.copyRows( origin, m_RowPitch );
 			}
+			return result;
 		}
 
-		void assign( unsigned short *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
+		// compacts an image with padded rows or a sub image into a buffer of its own, for consumers that
+		// expect getWidth() * getHeight() pixels without gaps ( e.g. buffer uploads ). no-op if contiguous
+		void makeContiguous()
 		{
-			m_ImageType = ImageType::UNSIGNED_SHORT;
-			m_Size = ( w * h * o.getNumberOfChannels() * sizeof( unsigned short ) );
-			m_Width = w;
-			m_Height = h;
-			m_ChannelOrder = o;
+			if ( m_Data != nullptr && !isContiguous() ) copyRows( m_Data, m_RowPitch );
+		}
 
-			m_Deleter->safeDelete( m_Data );
-			safeDelete( m_Deleter );
+		bool operator==( Image const& other ) const
+		{
+			if ( m_ChannelOrder != other.m_ChannelOrder ) return false;
+			else if ( m_ImageType != other.m_ImageType ) return false;
+			else if ( m_Width != other.m_Width ) return false;
+			else if ( m_Height != other.m_Height ) return false;
+			else if ( m_Data == other.m_Data && m_RowPitch == other.m_RowPitch ) return true;
+			else if ( m_Data == nullptr || other.m_Data == nullptr ) return false;
+			else if ( isContiguous() && other.isContiguous() ) return ( memcmp( m_Data, other.m_Data, m_Size ) == 0 );
 
-			if ( data != nullptr )
+			const size_t rowBytes = getRowBytes();
+			for ( unsigned int y=0; y<m_Height; ++y )
 			{
-				m_Deleter = new ArrayDeleter< unsigned char >();
-				m_Data = new unsigned char[ m_Size ];
-				memcpy( m_Data, data, m_Size );
+				if ( memcmp( getRow( y ), other.getRow( y ), rowBytes ) != 0 ) return false;
 			}
-			else
+			return true;
+		}
+
+		ImageType const&			getImageType() const { return m_ImageType; }
+		ImageChannelOrder const&	getChannelOrder() const { return m_ChannelOrder; }
+		unsigned int				getNumberOfChannels() const { return m_ChannelOrder.getNumberOfChannels(); }
+		// bytes from getData() to the end of the last row's pixels, i.e. w * h * pixel size for contiguous images
+		size_t						getByteSize() const { return m_Size; }
+		size_t						getBitsPerPixel() const { return getNumberOfChannels() * m_ImageType.getByteSize()*8; }
+		size_t						getBitsPerChannel() const { return m_ImageType.getByteSize()*8; }
+		unsigned int				getWidth() const { return m_Width; }
+		unsigned int				getHeight() const { return m_Height; }
+		size_t						getRowPitch() const { return m_RowPitch; }
+		size_t						getRowBytes() const { return m_Width * getPixelBytes(); }
+		bool						isContiguous() const { return m_Height <= 1 || m_RowPitch == getRowBytes(); }
+		unsigned char const *		getData() const { return m_Data; }
+		unsigned char *				getData() { detach(); return m_Data; }
+		unsigned char const *		getRow( const unsigned int y ) const { return m_Data + y * m_RowPitch; }
+		unsigned char *				getRow( const unsigned int y ) { detach(); return m_Data + y * m_RowPitch; }
+		bool						isShared() const { return !m_Buffer.isNull() && !m_Buffer.isUnique(); }
+
+	private:
+
+		size_t getPixelBytes() const
+		{
+			return getNumberOfChannels() * m_ImageType.getByteSize();
+		}
+
+		size_t getSpan() const
+		{
+			return ( m_Height == 0 ? 0 : m_RowPitch * ( m_Height - 1 ) + getRowBytes() );
+		}
+
+		void releaseOwnedData()
+		{
+			if ( m_IsDataOwner )
 			{
-				m_Data = nullptr;
-				m_Deleter = new NullDeleter< unsigned char >();
+				delete [] m_Data;
+				m_IsDataOwner = false;
 			}
+			m_Data = nullptr;
 		}
 
-		void assign( float *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
+		void releaseData()
 		{
-			m_ImageType = ImageType::FLOAT;
-			m_Size = ( w * h * o.getNumberOfChannels() * sizeof( float ) );
-			m_Width = w;
-			m_Height = h;
-			m_ChannelOrder = o;
+			releaseOwnedData();
+			m_Buffer.reset();
+		}
 
-			m_Deleter->safeDelete( m_Data );
-			safeDelete( m_Deleter );
+		// copies the rows of the current shape into a new pooled buffer, without padding
+		void copyRows( unsigned char const* src, const size_t srcPitch )
+		{
+			const size_t rowBytes = getRowBytes();
+			SharedBuffer buffer( rowBytes * m_Height );
+			unsigned char *dst = buffer.getData();
+			if ( srcPitch == rowBytes )
+			{
+				memcpy( dst, src, rowBytes * m_Height );
+			}
+			else
+			{
+				for ( unsigned int y=0; y<m_Height; ++y )
+				{
+					memcpy( dst + y * rowBytes, src + y * srcPitch, rowBytes );
+				}
+			}
 
-			if ( data != nullptr )
+			releaseData();
+			m_Buffer.swap( buffer );
+			m_Data = m_Buffer.getData();
+			m_RowPitch = rowBytes;
+			m_Size = rowBytes * m_Height;
+		}
+
+		void shareData( Image const& src )
+		{
+			if ( !src.m_Buffer.isNull() )
+			{
+				SharedBuffer buffer( src.m_Buffer );
+				releaseData();
+				m_Buffer.swap( buffer );
+				m_Data = src.m_Data;
+			}
+			else if ( src.m_Data != nullptr && src.isContiguous() )
+			{
+				// user data can't be shared, so it goes into a pooled buffer ( reusing ours if possible )
+				unsigned char const* data = src.m_Data;
+				releaseOwnedData();
+				m_Buffer.assign( data, m_Size );
+				m_Data = m_Buffer.getData();
+			}
+			else if ( src.m_Data != nullptr )
 			{
-				m_Deleter = new ArrayDeleter< unsigned char >();
-				m_Data = new unsigned char[ m_Size ];
-				memcpy( m_Data, data, m_Size );
+				copyRows( src.m_Data, src.m_RowPitch );
 			}
 			else
 			{
-				m_Data = nullptr;
-				m_Deleter = new NullDeleter< unsigned char >();
+				releaseData();
 			}
 		}
 
-		void assign( double *data, bool owns, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
+		// re-assigning the current payload with a shape that needs more bytes than it holds grows a pooled
+		// buffer ( keeping its bytes ) and throws for user data, whose size is only known from the previous shape
+		void setData( unsigned char *data, const bool owns, const ImageType type, const unsigned int w, const unsigned int h, const ImageChannelOrder o )
 		{
-			m_ImageType = ImageType::DOUBLE;
-			m_Size = ( w * h * o.getNumberOfChannels() * sizeof( double ) );
+			const size_t size = w * h * o.getNumberOfChannels() * type.getByteSize();
+			if ( data != nullptr && data == m_Data && m_Buffer.isNull() && size > m_Size )
+			{
+				throw Exception( "Image::assign: the new shape exceeds the size of the image's data" );
+			}
+
+			m_ImageType = type;
 			m_Width = w;
 			m_Height = h;
 			m_ChannelOrder = o;
+			m_RowPitch = w * o.getNumberOfChannels() * type.getByteSize();
+			m_Size = size;
 
-			m_Deleter->safeDelete( m_Data );
-			safeDelete( m_Deleter );
+			if ( data != nullptr && data == m_Data )
+			{
+				// re-assignment of the current payload, e.g. after writing into getData()
+				if ( !m_Buffer.isNull() )
+				{
+					const size_t available = m_Buffer.getCapacity() - ( m_Data - m_Buffer.getData() );
+					if ( m_Size > available )
+					{
+						SharedBuffer buffer( m_Size );
+						memcpy( buffer.getData(), m_Data, available );
+						m_Buffer.swap( buffer );
+						m_Data = m_Buffer.getData();
+					}
+				}
+				else if ( owns ) m_IsDataOwner = true;
+				return;
+			}
 
-			if ( data != nullptr )
+			if ( owns || data == nullptr )
 			{
-				m_Deleter = new ArrayDeleter< unsigned char >();
-				m_Data = new unsigned char[ m_Size ];
-				memcpy( m_Data, data, m_Size );
+				releaseData();
+				m_Data = data;
+				m_IsDataOwner = owns && data != nullptr;
 			}
 			else
 			{
-				m_Data = nullptr;
-				m_Deleter = new NullDeleter< unsigned char >();
+				releaseOwnedData();
+				m_Buffer.assign( data, m_Size );
+				m_Data = m_Buffer.getData();
 			}
 		}
 
-		bool operator==( Image const& other ) const
+		// copy-on-write: a pooled buffer shared with other images is copied before it can be written to.
+		// an image that starts at the buffer keeps its padding, a view is copied without the rest of its parent
+		void detach()
 		{
-			if ( m_ChannelOrder != other.m_ChannelOrder ) return false;
-			else if ( m_ImageType != other.m_ImageType ) return false;
-			else if ( m_Width != other.m_Width ) return false;
-			else if ( m_Height != other.m_Height ) return false;
-			else if ( m_Size != other.m_Size ) return false;
-			else
+			if ( isShared() )
 			{
-				unsigned char *pThis = m_Data;
-				unsigned char *pOther = other.m_Data;
-				for ( unsigned int i=0; i<m_Size; ++i )
+				if ( m_Data == m_Buffer.getData() )
 				{
-					if ( *pThis != *pOther ) return false;
-					++pThis;
-					++pOther;
+					m_Buffer.makeUnique( m_RowPitch * m_Height );
+					m_Data = m_Buffer.getData();
+				}
+				else
+				{
+					copyRows( m_Data, m_RowPitch );
 				}
-
-				return true;
 			}
 		}
 
-		ImageType const&			getImageType() const { return m_ImageType; }
-		ImageChannelOrder const&	getChannelOrder() const { return m_ChannelOrder; }
-		unsigned int				getNumberOfChannels() const { return m_ChannelOrder.getNumberOfChannels(); }
-		size_t						getByteSize() const { return m_Size; }
-		size_t						getBitsPerPixel() const { return getNumberOfChannels() * m_ImageType.getByteSize()*8; }
-		size_t						getBitsPerChannel() const { return m_ImageType.getByteSize()*8; }
-		unsigned int				getWidth() const { return m_Width; }
-		unsigned int				getHeight() const { return m_Height; }
-		unsigned char const *		getData() const { return m_Data; }
-		unsigned char *				getData() { return m_Data; }
-
-	private:
-
+		SharedBuffer				m_Buffer;
 		unsigned char				*m_Data;
+		bool						m_IsDataOwner;
 		unsigned int				m_Width;
 		unsigned int				m_Height;
+		size_t						m_RowPitch;
 		size_t						m_Size;
 		ImageType					m_ImageType;
 		ImageChannelOrder			m_ChannelOrder;
-		Deleter< unsigned char >	*m_Deleter;
 
 	};
+
+	// contiguous images are hashed in one go, strided ones row by row - equal pixels in different
+	// layouts may thus hash differently, which at worst reports an unchanged value as changed
+	template < >
+	inline bool hashContent( Image const& image, unsigned long long &hash )
+	{
+		const unsigned long long shape = ( static_cast< unsigned long long >( image.getWidth() ) << 32 ) ^ image.getHeight()
+			^ ( static_cast< unsigned long long >( image.getImageType().getDatatype() ) << 24 ) ^ ( static_cast< unsigned long long >( image.getChannelOrder().getCode() ) << 56 );
+		if ( image.getData() == nullptr || image.isContiguous() )
+		{
+			hash = hashBytes( image.getData(), image.getData() == nullptr ? 0 : image.getByteSize(), shape );
+			return true;
+		}
+
+		hash = shape;
+		for ( unsigned int y=0; y<image.getHeight(); ++y )
+		{
+			hash = hashBytes( image.getRow( y ), image.getRowBytes(), hash );
+		}
+		return true;
+	}
 }
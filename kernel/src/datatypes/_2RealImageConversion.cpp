@@ -0,0 +1,642 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#include "datatypes/_2RealImageConversion.h"
+
+#include <algorithm>
+#include <string.h>
+#include <string>
+
+// sse2 is part of every x64 cpu; the ssse3 & avx2 kernels are compiled if the compiler knows
+// the intrinsics, and only called if the cpu supports the instruction set
+#if defined( _M_X64 ) || defined( __x86_64__ ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ )
+	#define _2REAL_SSE2
+	#include <emmintrin.h>
+	#include <tmmintrin.h>
+	#if defined( __GNUC__ ) || ( defined( _MSC_VER ) && _MSC_VER >= 1700 )
+		#define _2REAL_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
+#if defined( __GNUC__ )
+	#define _2REAL_TARGET( isa ) __attribute__(( target( isa ) ))
+#else
+	#define _2REAL_TARGET( isa )
+	#if defined( _2REAL_SSE2 )
+		#include <intrin.h>
+	#endif
+#endif
+
+namespace _2Real
+{
+
+	namespace
+	{
+
+		struct CpuFeatures
+		{
+			bool	sse2;
+			bool	ssse3;
+			bool	avx2;
+		};
+
+		CpuFeatures detectCpuFeatures()
+		{
+			CpuFeatures features = { false, false, false };
+#if defined( _2REAL_SSE2 )
+			features.sse2 = true;
+#endif
+#if defined( _2REAL_SSE2 ) && defined( __GNUC__ )
+			__builtin_cpu_init();
+			features.ssse3 = ( __builtin_cpu_supports( "ssse3" ) != 0 );
+	#if defined( _2REAL_AVX2 )
+			features.avx2 = ( __builtin_cpu_supports( "avx2" ) != 0 );
+	#endif
+#elif defined( _2REAL_SSE2 )
+			int info[ 4 ];
+			__cpuid( info, 0 );
+			const int maxLeaf = info[ 0 ];
+			__cpuid( info, 1 );
+			features.ssse3 = ( ( info[ 2 ] & ( 1 << 9 ) ) != 0 );
+	#if defined( _2REAL_AVX2 )
+			// the os must save the ymm registers as well
+			const bool hasAvx = ( ( info[ 2 ] & ( 1 << 28 ) ) != 0 ) && ( ( info[ 2 ] & ( 1 << 27 ) ) != 0 );
+			if ( maxLeaf >= 7 && hasAvx && ( _xgetbv( 0 ) & 6 ) == 6 )
+			{
+				__cpuidex( info, 7, 0 );
+				features.avx2 = ( ( info[ 1 ] & ( 1 << 5 ) ) != 0 );
+			}
+	#endif
+#endif
+			return features;
+		}
+
+		const CpuFeatures s_Detected = detectCpuFeatures();
+		CpuFeatures s_Cpu = s_Detected;			// what the kernels may use, see limitInstructionSet
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// values
+
+		template< typename T >
+		inline T saturate( const double v )
+		{
+			return static_cast< T >( v );
+		}
+
+		template< >
+		inline unsigned char saturate( const double v )
+		{
+			return !( v > 0. ) ? 0 : ( v >= 255. ? 255 : static_cast< unsigned char >( v + .5 ) );
+		}
+
+		template< >
+		inline unsigned short saturate( const double v )
+		{
+			return !( v > 0. ) ? 0 : ( v >= 65535. ? 65535 : static_cast< unsigned short >( v + .5 ) );
+		}
+
+		template< typename T >
+		inline T luminance( const T r, const T g, const T b )
+		{
+			return saturate< T >( .299 * r + .587 * g + .114 * b );
+		}
+
+		template< >
+		inline unsigned char luminance( const unsigned char r, const unsigned char g, const unsigned char b )
+		{
+			return static_cast< unsigned char >( ( 77 * r + 150 * g + 29 * b + 128 ) >> 8 );
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// channel order
+
+		enum { FILL = -1, LUMINANCE = -2 };
+
+		// for every channel of dst: the channel of src it is copied from, FILL or LUMINANCE
+		void getChannelMap( ImageChannelOrder const& src, ImageChannelOrder const& dst, int *map )
+		{
+			const unsigned int srcChannels = src.getNumberOfChannels();
+			const unsigned int dstChannels = dst.getNumberOfChannels();
+
+			if ( dstChannels == 1 )
+			{
+				map[ 0 ] = ( srcChannels == 1 ? 0 : LUMINANCE );
+				return;
+			}
+
+			for ( unsigned int c=0; c<dstChannels; ++c )
+			{
+				if ( c == dst.getRedOffset() )				map[ c ] = ( srcChannels == 1 ? 0 : src.getRedOffset() );
+				else if ( c == dst.getGreenOffset() )		map[ c ] = ( srcChannels == 1 ? 0 : src.getGreenOffset() );
+				else if ( c == dst.getBlueOffset() )		map[ c ] = ( srcChannels == 1 ? 0 : src.getBlueOffset() );
+				else if ( c == dst.getAlphaOffset() && srcChannels > 1 && src.hasAlpha() )	map[ c ] = src.getAlphaOffset();
+				else										map[ c ] = FILL;			// alpha without a source, or padding
+			}
+		}
+
+		template< typename T >
+		void swizzleValues( T const* src, const unsigned int srcChannels, T *dst, const unsigned int dstChannels, const size_t pixels,
+			int const* map, ImageChannelOrder const& srcOrder, const T fill )
+		{
+			const unsigned int r = srcOrder.getRedOffset();
+			const unsigned int g = srcOrder.getGreenOffset();
+			const unsigned int b = srcOrder.getBlueOffset();
+
+			for ( size_t p=0; p<pixels; ++p )
+			{
+				for ( unsigned int c=0; c<dstChannels; ++c )
+				{
+					const int m = map[ c ];
+					if ( m >= 0 )				dst[ c ] = src[ m ];
+					else if ( m == FILL )		dst[ c ] = fill;
+					else						dst[ c ] = luminance( src[ r ], src[ g ], src[ b ] );
+				}
+				src += srcChannels;
+				dst += dstChannels;
+			}
+		}
+
+		// byte shuffle for 4 pixels: control holds the source byte of every destination byte ( 0x80 -> 0 ), fill is or'ed in
+		bool getShuffle( int const* map, const unsigned int srcChannels, const unsigned int dstChannels, unsigned char *control, unsigned char *fill )
+		{
+			for ( unsigned int i=0; i<16; ++i )
+			{
+				control[ i ] = 0x80;
+				fill[ i ] = 0;
+			}
+
+			for ( unsigned int p=0; p<4; ++p )
+			{
+				for ( unsigned int c=0; c<dstChannels; ++c )
+				{
+					const unsigned int i = p * dstChannels + c;
+					if ( map[ c ] == LUMINANCE )		return false;
+					else if ( map[ c ] == FILL )		fill[ i ] = 0xff;
+					else								control[ i ] = static_cast< unsigned char >( p * srcChannels + map[ c ] );
+				}
+			}
+			return true;
+		}
+
+#if defined( _2REAL_SSE2 )
+
+		// every step loads & stores 16 bytes, but uses only 4 pixels of them: the margin keeps both inside the images
+		_2REAL_TARGET( "ssse3" )
+		size_t swizzle8uSsse3( unsigned char const* src, const unsigned int srcChannels, unsigned char *dst, const unsigned int dstChannels, const size_t pixels,
+			unsigned char const* control, unsigned char const* fill )
+		{
+			const __m128i shuffle = _mm_loadu_si128( reinterpret_cast< __m128i const* >( control ) );
+			const __m128i mask = _mm_loadu_si128( reinterpret_cast< __m128i const* >( fill ) );
+			const size_t margin = std::max( ( 16 + srcChannels - 1 ) / srcChannels, ( 16 + dstChannels - 1 ) / dstChannels );
+
+			size_t p = 0;
+			for ( ; p + margin <= pixels; p += 4 )
+			{
+				__m128i v = _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + p * srcChannels ) );
+				v = _mm_or_si128( _mm_shuffle_epi8( v, shuffle ), mask );
+				_mm_storeu_si128( reinterpret_cast< __m128i * >( dst + p * dstChannels ), v );
+			}
+			return p;
+		}
+
+		// rounds halves up, like saturate: the value is clamped first, so truncating v + .5 does it
+		inline __m128i scaleToInt( const __m128 v, const __m128 scale, const __m128 max )
+		{
+			const __m128 clamped = _mm_min_ps( _mm_max_ps( _mm_mul_ps( v, scale ), _mm_setzero_ps() ), max );
+			return _mm_cvttps_epi32( _mm_add_ps( clamped, _mm_set1_ps( .5f ) ) );
+		}
+
+		size_t convert16u8uSse2( unsigned short const* src, unsigned char *dst, const size_t count, const float scale )
+		{
+			const __m128 s = _mm_set1_ps( scale );
+			const __m128 max = _mm_set1_ps( 255.f );
+			const __m128i zero = _mm_setzero_si128();
+
+			size_t i = 0;
+			for ( ; i + 16 <= count; i += 16 )
+			{
+				const __m128i a = _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i ) );
+				const __m128i b = _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i + 8 ) );
+				const __m128i a0 = scaleToInt( _mm_cvtepi32_ps( _mm_unpacklo_epi16( a, zero ) ), s, max );
+				const __m128i a1 = scaleToInt( _mm_cvtepi32_ps( _mm_unpackhi_epi16( a, zero ) ), s, max );
+				const __m128i b0 = scaleToInt( _mm_cvtepi32_ps( _mm_unpacklo_epi16( b, zero ) ), s, max );
+				const __m128i b1 = scaleToInt( _mm_cvtepi32_ps( _mm_unpackhi_epi16( b, zero ) ), s, max );
+				const __m128i v = _mm_packus_epi16( _mm_packs_epi32( a0, a1 ), _mm_packs_epi32( b0, b1 ) );
+				_mm_storeu_si128( reinterpret_cast< __m128i * >( dst + i ), v );
+			}
+			return i;
+		}
+
+		size_t convert32f8uSse2( float const* src, unsigned char *dst, const size_t count, const float scale )
+		{
+			const __m128 s = _mm_set1_ps( scale );
+			const __m128 max = _mm_set1_ps( 255.f );
+
+			size_t i = 0;
+			for ( ; i + 16 <= count; i += 16 )
+			{
+				const __m128i a0 = scaleToInt( _mm_loadu_ps( src + i ), s, max );
+				const __m128i a1 = scaleToInt( _mm_loadu_ps( src + i + 4 ), s, max );
+				const __m128i b0 = scaleToInt( _mm_loadu_ps( src + i + 8 ), s, max );
+				const __m128i b1 = scaleToInt( _mm_loadu_ps( src + i + 12 ), s, max );
+				const __m128i v = _mm_packus_epi16( _mm_packs_epi32( a0, a1 ), _mm_packs_epi32( b0, b1 ) );
+				_mm_storeu_si128( reinterpret_cast< __m128i * >( dst + i ), v );
+			}
+			return i;
+		}
+
+		size_t convert16u32fSse2( unsigned short const* src, float *dst, const size_t count, const float scale )
+		{
+			const __m128 s = _mm_set1_ps( scale );
+			const __m128i zero = _mm_setzero_si128();
+
+			size_t i = 0;
+			for ( ; i + 8 <= count; i += 8 )
+			{
+				const __m128i a = _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i ) );
+				_mm_storeu_ps( dst + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( a, zero ) ), s ) );
+				_mm_storeu_ps( dst + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( a, zero ) ), s ) );
+			}
+			return i;
+		}
+
+		size_t convert8u32fSse2( unsigned char const* src, float *dst, const size_t count, const float scale )
+		{
+			const __m128 s = _mm_set1_ps( scale );
+			const __m128i zero = _mm_setzero_si128();
+
+			size_t i = 0;
+			for ( ; i + 16 <= count; i += 16 )
+			{
+				const __m128i v = _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i ) );
+				const __m128i lo = _mm_unpacklo_epi8( v, zero );
+				const __m128i hi = _mm_unpackhi_epi8( v, zero );
+				_mm_storeu_ps( dst + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) ), s ) );
+				_mm_storeu_ps( dst + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) ), s ) );
+				_mm_storeu_ps( dst + i + 8, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) ), s ) );
+				_mm_storeu_ps( dst + i + 12, _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) ), s ) );
+			}
+			return i;
+		}
+
+#endif
+
+#if defined( _2REAL_AVX2 )
+
+		// 8 pixels per step, as two in-lane shuffles of 4 pixels each
+		_2REAL_TARGET( "avx2" )
+		size_t swizzle8uAvx2( unsigned char const* src, const unsigned int srcChannels, unsigned char *dst, const unsigned int dstChannels, const size_t pixels,
+			unsigned char const* control, unsigned char const* fill )
+		{
+			const __m256i shuffle = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast< __m128i const* >( control ) ) );
+			const __m256i mask = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast< __m128i const* >( fill ) ) );
+			const size_t margin = 4 + std::max( ( 16 + srcChannels - 1 ) / srcChannels, ( 16 + dstChannels - 1 ) / dstChannels );
+
+			size_t p = 0;
+			for ( ; p + margin <= pixels; p += 8 )
+			{
+				const __m128i lo = _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + p * srcChannels ) );
+				const __m128i hi = _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + ( p + 4 ) * srcChannels ) );
+				__m256i v = _mm256_inserti128_si256( _mm256_castsi128_si256( lo ), hi, 1 );
+				v = _mm256_or_si256( _mm256_shuffle_epi8( v, shuffle ), mask );
+
+				if ( dstChannels == 4 )
+				{
+					_mm256_storeu_si256( reinterpret_cast< __m256i * >( dst + p * 4 ), v );
+				}
+				else
+				{
+					// the unused tail of the first half is overwritten by the second one
+					_mm_storeu_si128( reinterpret_cast< __m128i * >( dst + p * dstChannels ), _mm256_castsi256_si128( v ) );
+					_mm_storeu_si128( reinterpret_cast< __m128i * >( dst + ( p + 4 ) * dstChannels ), _mm256_extracti128_si256( v, 1 ) );
+				}
+			}
+			return p;
+		}
+
+		_2REAL_TARGET( "avx2" )
+		inline __m256i scaleToInt( const __m256 v, const __m256 scale, const __m256 max )
+		{
+			const __m256 clamped = _mm256_min_ps( _mm256_max_ps( _mm256_mul_ps( v, scale ), _mm256_setzero_ps() ), max );
+			return _mm256_cvttps_epi32( _mm256_add_ps( clamped, _mm256_set1_ps( .5f ) ) );
+		}
+
+		_2REAL_TARGET( "avx2" )
+		size_t convert16u8uAvx2( unsigned short const* src, unsigned char *dst, const size_t count, const float scale )
+		{
+			const __m256 s = _mm256_set1_ps( scale );
+			const __m256 max = _mm256_set1_ps( 255.f );
+			// the packs work within 128 bit lanes, this puts the 4 byte groups back in order
+			const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+
+			size_t i = 0;
+			for ( ; i + 32 <= count; i += 32 )
+			{
+				const __m256i a = scaleToInt( _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i ) ) ) ), s, max );
+				const __m256i b = scaleToInt( _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i + 8 ) ) ) ), s, max );
+				const __m256i c = scaleToInt( _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i + 16 ) ) ) ), s, max );
+				const __m256i d = scaleToInt( _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast< __m128i const* >( src + i + 24 ) ) ) ), s, max );
+				__m256i v = _mm256_packus_epi16( _mm256_packs_epi32( a, b ), _mm256_packs_epi32( c, d ) );
+				v = _mm256_permutevar8x32_epi32( v, order );
+				_mm256_storeu_si256( reinterpret_cast< __m256i * >( dst + i ), v );
+			}
+			return i;
+		}
+
+#endif
+
+		void swizzle8u( unsigned char const* src, const unsigned int srcChannels, unsigned char *dst, const unsigned int dstChannels, const size_t pixels,
+			int const* map, ImageChannelOrder const& srcOrder )
+		{
+			size_t done = 0;
+#if defined( _2REAL_SSE2 )
+			unsigned char control[ 16 ], fill[ 16 ];
+			if ( getShuffle( map, srcChannels, dstChannels, control, fill ) )
+			{
+	#if defined( _2REAL_AVX2 )
+				if ( s_Cpu.avx2 )			done = swizzle8uAvx2( src, srcChannels, dst, dstChannels, pixels, control, fill );
+				else
+	#endif
+				if ( s_Cpu.ssse3 )			done = swizzle8uSsse3( src, srcChannels, dst, dstChannels, pixels, control, fill );
+			}
+#endif
+			swizzleValues< unsigned char >( src + done * srcChannels, srcChannels, dst + done * dstChannels, dstChannels, pixels - done, map, srcOrder, 0xff );
+		}
+
+		void swizzle( Image const& src, Image &dst )
+		{
+			ImageChannelOrder const& srcOrder = src.getChannelOrder();
+			const unsigned int srcChannels = srcOrder.getNumberOfChannels();
+			const unsigned int dstChannels = dst.getNumberOfChannels();
+
+			// contiguous images are done in one pass, strided ones row by row
+			const bool packed = src.isContiguous() && dst.isContiguous();
+			const unsigned int rows = packed ? 1 : src.getHeight();
+			const size_t pixels = packed ? static_cast< size_t >( src.getWidth() ) * src.getHeight() : src.getWidth();
+
+			int map[ 4 ];
+			getChannelMap( srcOrder, dst.getChannelOrder(), map );
+
+			unsigned char *data = dst.getData();
+			for ( unsigned int y=0; y<rows; ++y )
+			{
+				unsigned char const* s = src.getRow( y );
+				unsigned char *d = data + y * dst.getRowPitch();
+				switch ( src.getImageType().getDatatype() )
+				{
+				case ImageType::UNSIGNED_BYTE:
+					swizzle8u( s, srcChannels, d, dstChannels, pixels, map, srcOrder );
+					break;
+				case ImageType::UNSIGNED_SHORT:
+					swizzleValues( reinterpret_cast< unsigned short const* >( s ), srcChannels, reinterpret_cast< unsigned short * >( d ), dstChannels, pixels, map, srcOrder, static_cast< unsigned short >( 65535 ) );
+					break;
+				case ImageType::FLOAT:
+					swizzleValues( reinterpret_cast< float const* >( s ), srcChannels, reinterpret_cast< float * >( d ), dstChannels, pixels, map, srcOrder, 1.f );
+					break;
+				case ImageType::DOUBLE:
+					swizzleValues( reinterpret_cast< double const* >( s ), srcChannels, reinterpret_cast< double * >( d ), dstChannels, pixels, map, srcOrder, 1. );
+					break;
+				}
+			}
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// depth
+
+		template< typename TSrc, typename TDst >
+		void scaleValues( TSrc const* src, TDst *dst, const size_t count, const double scale )
+		{
+			for ( size_t i=0; i<count; ++i )
+			{
+				dst[ i ] = saturate< TDst >( src[ i ] * scale );
+			}
+		}
+
+		// the combinations with simd kernels; the kernels compute in single precision
+		void convertValues( unsigned short const* src, unsigned char *dst, const size_t count, const double scale )
+		{
+			size_t done = 0;
+#if defined( _2REAL_AVX2 )
+			if ( s_Cpu.avx2 )		done = convert16u8uAvx2( src, dst, count, static_cast< float >( scale ) );
+			else
+#endif
+#if defined( _2REAL_SSE2 )
+			if ( s_Cpu.sse2 )		done = convert16u8uSse2( src, dst, count, static_cast< float >( scale ) );
+#endif
+			scaleValues( src + done, dst + done, count - done, scale );
+		}
+
+		void convertValues( float const* src, unsigned char *dst, const size_t count, const double scale )
+		{
+			size_t done = 0;
+#if defined( _2REAL_SSE2 )
+			if ( s_Cpu.sse2 ) done = convert32f8uSse2( src, dst, count, static_cast< float >( scale ) );
+#endif
+			scaleValues( src + done, dst + done, count - done, scale );
+		}
+
+		void convertValues( unsigned short const* src, float *dst, const size_t count, const double scale )
+		{
+			size_t done = 0;
+#if defined( _2REAL_SSE2 )
+			if ( s_Cpu.sse2 ) done = convert16u32fSse2( src, dst, count, static_cast< float >( scale ) );
+#endif
+			scaleValues( src + done, dst + done, count - done, scale );
+		}
+
+		void convertValues( unsigned char const* src, float *dst, const size_t count, const double scale )
+		{
+			size_t done = 0;
+#if defined( _2REAL_SSE2 )
+			if ( s_Cpu.sse2 ) done = convert8u32fSse2( src, dst, count, static_cast< float >( scale ) );
+#endif
+			scaleValues( src + done, dst + done, count - done, scale );
+		}
+
+		template< typename TSrc, typename TDst >
+		void convertValues( TSrc const* src, TDst *dst, const size_t count, const double scale )
+		{
+			scaleValues( src, dst, count, scale );
+		}
+
+		template< typename TSrc >
+		void convertFrom( TSrc const* src, unsigned char *d, ImageType const& type, const size_t count, const double scale )
+		{
+			switch ( type.getDatatype() )
+			{
+			case ImageType::UNSIGNED_BYTE:
+				convertValues( src, d, count, scale );
+				break;
+			case ImageType::UNSIGNED_SHORT:
+				convertValues( src, reinterpret_cast< unsigned short * >( d ), count, scale );
+				break;
+			case ImageType::FLOAT:
+				convertValues( src, reinterpret_cast< float * >( d ), count, scale );
+				break;
+			case ImageType::DOUBLE:
+				convertValues( src, reinterpret_cast< double * >( d ), count, scale );
+				break;
+			}
+		}
+
+		// src & dst have the same size & number of channels
+		void convertDepth( Image const& src, Image &dst, const double scale )
+		{
+			const bool packed = src.isContiguous() && dst.isContiguous();
+			const unsigned int rows = packed ? 1 : src.getHeight();
+			const size_t count = static_cast< size_t >( src.getWidth() ) * ( packed ? src.getHeight() : 1 ) * src.getNumberOfChannels();
+			const bool copy = ( src.getImageType() == dst.getImageType() && scale == 1. );
+
+			ImageType const& type = dst.getImageType();
+			unsigned char *data = dst.getData();
+			for ( unsigned int y=0; y<rows; ++y )
+			{
+				unsigned char const* s = src.getRow( y );
+				unsigned char *d = data + y * dst.getRowPitch();
+				if ( copy )
+				{
+					memcpy( d, s, count * type.getByteSize() );
+					continue;
+				}
+
+				switch ( src.getImageType().getDatatype() )
+				{
+				case ImageType::UNSIGNED_BYTE:
+					convertFrom( s, d, type, count, scale );
+					break;
+				case ImageType::UNSIGNED_SHORT:
+					convertFrom( reinterpret_cast< unsigned short const* >( s ), d, type, count, scale );
+					break;
+				case ImageType::FLOAT:
+					convertFrom( reinterpret_cast< float const* >( s ), d, type, count, scale );
+					break;
+				case ImageType::DOUBLE:
+					convertFrom( reinterpret_cast< double const* >( s ), d, type, count, scale );
+					break;
+				}
+			}
+		}
+
+		bool isReordered( ImageChannelOrder const& src, ImageChannelOrder const& dst )
+		{
+			// all single channel images are gray
+			return ( src != dst ) && !( src.getNumberOfChannels() == 1 && dst.getNumberOfChannels() == 1 );
+		}
+
+	}
+
+	double ImageConversion::getRange( ImageType const& type )
+	{
+		if ( type == ImageType::UNSIGNED_BYTE )			return 255.;
+		else if ( type == ImageType::UNSIGNED_SHORT )	return 65535.;
+		else											return 1.;
+	}
+
+	double ImageConversion::getDefaultScale( ImageType const& src, ImageType const& dst )
+	{
+		return getRange( dst ) / getRange( src );
+	}
+
+	bool ImageConversion::needsConversion( Image const& src, ImageType const& type, ImageChannelOrder const& order )
+	{
+		return !( src.getImageType() == type ) || src.getChannelOrder() != order;
+	}
+
+	void ImageConversion::convert( Image const& src, Image &dst, ImageType const& type, ImageChannelOrder const& order )
+	{
+		convert( src, dst, type, order, getDefaultScale( src.getImageType(), type ) );
+	}
+
+	void ImageConversion::convert( Image const& src, Image &dst, ImageType const& type, ImageChannelOrder const& order, const double scale )
+	{
+		if ( !needsConversion( src, type, order ) && scale == 1. )
+		{
+			dst = src;
+			return;
+		}
+
+		// shares src's payload, so that src may be dst
+		Image const source( src );
+		ImageType const& srcType = source.getImageType();
+		const unsigned int w = source.getWidth();
+		const unsigned int h = source.getHeight();
+
+		if ( source.getData() == nullptr || w == 0 || h == 0 )
+		{
+			dst.allocate( type, w, h, order );
+			return;
+		}
+
+		const bool reorder = isReordered( source.getChannelOrder(), order );
+		const bool rescale = !( srcType == type ) || scale != 1.;
+
+		if ( reorder && rescale )
+		{
+			// reorder at the smaller depth: after converting down, before converting up
+			Image tmp;
+			if ( type.getByteSize() < srcType.getByteSize() )
+			{
+				tmp.allocate( type, w, h, source.getChannelOrder() );
+				convertDepth( source, tmp, scale );
+				dst.allocate( type, w, h, order );
+				swizzle( tmp, dst );
+			}
+			else
+			{
+				tmp.allocate( srcType, w, h, order );
+				swizzle( source, tmp );
+				dst.allocate( type, w, h, order );
+				convertDepth( tmp, dst, scale );
+			}
+		}
+		else if ( reorder )
+		{
+			dst.allocate( type, w, h, order );
+			swizzle( source, dst );
+		}
+		else
+		{
+			dst.allocate( type, w, h, order );
+			convertDepth( source, dst, scale );
+		}
+	}
+
+	const char * ImageConversion::getInstructionSet()
+	{
+#if defined( _2REAL_AVX2 )
+		if ( s_Cpu.avx2 ) return "avx2";
+#endif
+		if ( s_Cpu.ssse3 ) return "ssse3";
+		if ( s_Cpu.sse2 ) return "sse2";
+		return "none";
+	}
+
+	bool ImageConversion::limitInstructionSet( const char *isa )
+	{
+		std::string const name( isa );
+		const int level = ( name == "none" ? 0 : ( name == "sse2" ? 1 : ( name == "ssse3" ? 2 : ( name == "avx2" ? 3 : -1 ) ) ) );
+		if ( level < 0 ) return false;
+
+		s_Cpu.sse2 = s_Detected.sse2 && level >= 1;
+		s_Cpu.ssse3 = s_Detected.ssse3 && level >= 2;
+		s_Cpu.avx2 = s_Detected.avx2 && level >= 3;
+		return true;
+	}
+
+}
@@ -0,0 +1,69 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include "datatypes/_2RealImage.h"
+
+namespace _2Real
+{
+
+	// the format an image inlet converts received images to ( see app::InletHandle::setImageFormat )
+	struct ImageFormat
+	{
+		ImageFormat( ImageType const& t, ImageChannelOrder const& o, const double s ) : type( t ), order( o ), scale( s ) {}
+
+		ImageType			type;
+		ImageChannelOrder	order;
+		double				scale;		// <= 0 -> ImageConversion::getDefaultScale
+	};
+
+	// channel order & depth conversion for images.
+	// swizzles between all channel orders: 3 / 4 channel orders are reordered, missing alpha / padding
+	// channels are filled with the maximum value; single channel images ( R, G, B or A ) count as gray,
+	// they are replicated into color channels, and color images are reduced to gray by their luminance.
+	// depth conversions among 8U / 16U / 32F / 64F multiply by a scale and saturate integer results.
+	// the common 8 bit swizzles & the 16U / 8U / 32F conversions have SSE2 / SSSE3 / AVX2 kernels,
+	// chosen at runtime from what the cpu supports; everything else is plain c++.
+	// strided sources ( sub images, padded rows ) are converted row by row, the results are contiguous
+	class ImageConversion
+	{
+
+	public:
+
+		// value range of the type: 255, 65535, 1 for floating point data
+		static double getRange( ImageType const& type );
+		// maps the full range of src onto the full range of dst
+		static double getDefaultScale( ImageType const& src, ImageType const& dst );
+
+		// dst is (re-)allocated through Image::allocate, i.e. from the buffer pool. if nothing needs to be
+		// converted, dst just shares src's payload. src & dst may be the same image
+		static void convert( Image const& src, Image &dst, ImageType const& type, ImageChannelOrder const& order, const double scale );
+		static void convert( Image const& src, Image &dst, ImageType const& type, ImageChannelOrder const& order );
+
+		static bool needsConversion( Image const& src, ImageType const& type, ImageChannelOrder const& order );
+
+		// most advanced instruction set the kernels use on this machine: "avx2", "ssse3", "sse2" or "none"
+		static const char * getInstructionSet();
+		// restricts the kernels to the instruction set & the ones below it ( never beyond what the cpu supports ),
+		// "none" leaves the plain c++ code. false if the name is unknown. for tests & benchmarks: not while converting
+		static bool limitInstructionSet( const char *isa );
+
+	};
+
+}
@@ -23,6 +23,8 @@
 #include <stdint.h>
 #include <memory>
 
+#include "helpers/_2RealBufferPool.h"
+
 //stdio is not pulled in automatically on unix (ottona)
 #ifdef _UNIX
 	#include <string.h>
@@ -105,21 +107,53 @@ namespace _2Real
 			}
 
 			~ChannelObject()
+			{
+				releaseData();
+			}
+
+			void releaseData()
 			{
 				if (m_IsDataOwner)
 				{
 					delete [] m_Data;
+					m_IsDataOwner = false;
 				}
+				m_Data = nullptr;
 			}
 
+			// user data or a view into an image, as opposed to a pooled buffer
+			bool isView() const { return ( m_Buffer.isNull() && !m_IsDataOwner ); }
+
 			uint32_t		m_Width, m_Height, m_RowPitch;
 			T				*m_Data;
 			uint8_t			m_Increment;
 			bool			m_IsDataOwner;
+			SharedBuffer	m_Buffer;
 		};
 
 		std::auto_ptr< ChannelObject >		m_ChannelObject;
 
+		// copies of views ( e.g. the channels of an image ) are views as well, anything else is copied into a pooled buffer
+		void copyFrom( ImageChannelT const& src )
+		{
+			ChannelObject const& other = *src.m_ChannelObject;
+			if ( other.isView() )
+			{
+				assign( other.m_Data, false, other.m_Width, other.m_Height, other.m_RowPitch, other.m_Increment );
+			}
+			else
+			{
+				ChannelObject &obj = *m_ChannelObject;
+				if ( obj.m_Buffer.isNull() ) obj.releaseData();
+				obj.m_Buffer.assign( other.m_Data, other.m_Width * other.m_Height * sizeof( T ) );
+				obj.m_Data = reinterpret_cast< T * >( obj.m_Buffer.getData() );
+				obj.m_Width = other.m_Width;
+				obj.m_Height = other.m_Height;
+				obj.m_RowPitch = other.m_RowPitch;
+				obj.m_Increment = other.m_Increment;
+			}
+		}
+
 	public:
 
 		ImageChannelT& operator=( ImageChannelT const& src )
@@ -129,22 +163,14 @@ namespace _2Real
 				return *this;
 			}
 
-			T const* srcData = src.getData();
-			size_t sz = src.getWidth() * src.getHeight();
-			T *data = new T[ sz ];
-			memcpy( data, srcData, sz*sizeof( T ) );
-			m_ChannelObject = std::auto_ptr< ChannelObject >( new ChannelObject( data, true, src.getWidth(), src.getHeight(), src.getRowPitch(), src.getIncrement() ) );
-
+			copyFrom( src );
 			return *this;
 		}
 
 		ImageChannelT( ImageChannelT const& src )
 		{
-			T const* srcData = src.getData();
-			size_t sz = src.getWidth() * src.getHeight();
-			T *data = new T[ sz ];
-			memcpy( data, srcData, sz*sizeof( T ) );
-			m_ChannelObject = std::auto_ptr< ChannelObject >( new ChannelObject( data, true, src.getWidth(), src.getHeight(), src.getRowPitch(), src.getIncrement() ) );
+			m_ChannelObject = std::auto_ptr< ChannelObject >(new ChannelObject(nullptr, false, 0, 0, 0, 1));
+			copyFrom( src );
 		}
 
 		ImageChannelT()
@@ -155,8 +181,9 @@ namespace _2Real
 		ImageChannelT(const uint32_t width, const uint32_t height)
 		{
 			unsigned int rowBytes = width * sizeof(T);
-			T *data = new T[width*height];
-			m_ChannelObject = std::auto_ptr< ChannelObject >(new ChannelObject(data, false, width, height, rowBytes, 1));
+			m_ChannelObject = std::auto_ptr< ChannelObject >(new ChannelObject(nullptr, false, width, height, rowBytes, 1));
+			m_ChannelObject->m_Buffer.allocate( width * height * sizeof( T ) );
+			m_ChannelObject->m_Data = reinterpret_cast< T * >( m_ChannelObject->m_Buffer.getData() );
 		}
 
 		ImageChannelT(T *data, const bool ownsData, const uint32_t width, const uint32_t height, const int32_t bytesPerRow, const uint8_t inc)
@@ -164,6 +191,23 @@ namespace _2Real
 			m_ChannelObject = std::auto_ptr< ChannelObject >(new ChannelObject(data, ownsData, width, height, bytesPerRow, inc));
 		}
 
+		// re-points the channel, without reallocating the channel object
+		void assign(T *data, const bool ownsData, const uint32_t width, const uint32_t height, const int32_t bytesPerRow, const uint8_t inc)
+		{
+			ChannelObject &obj = *m_ChannelObject;
+			if ( obj.m_Data != data )
+			{
+				obj.releaseData();
+				obj.m_Buffer.reset();
+			}
+			obj.m_Data = data;
+			obj.m_IsDataOwner = ownsData;
+			obj.m_Width = width;
+			obj.m_Height = height;
+			obj.m_RowPitch = bytesPerRow;
+			obj.m_Increment = inc;
+		}
+
 		const uint32_t	getWidth() const { return m_ChannelObject->m_Width; }
 		const uint32_t	getHeight() const { return m_ChannelObject->m_Height; }
 		const uint32_t	getRowPitch() const { return m_ChannelObject->m_RowPitch; }
@@ -288,6 +332,7 @@ namespace _2Real
 			m_ImageObject = std::auto_ptr< ImageObject >( new ImageObject(nullptr, false, 0, 0, 0, ImageChannelOrder::RGBA) );
 		}
 
+		// copies share the pooled buffer of the source, the first non-const access detaches
 		ImageT& operator=( ImageT const& src )
 		{
 			if ( this == &src )
@@ -295,33 +340,23 @@ namespace _2Real
 				return *this;
 			}
 
-			T* srcData = src.getData();
-			size_t sz = src.getWidth() * src.getChannelOrder().getNumberOfChannels() * src.getHeight();
-			T *data = new T[ sz ];
-
-			memcpy( data, srcData, sz*sizeof( T ) );
-
-			m_ImageObject = std::auto_ptr< ImageObject >( new ImageObject( data, true, src.getWidth(), src.getHeight(), src.getRowPitch(), src.getChannelOrder() ) );
+			m_ImageObject->shareData( *src.m_ImageObject );
 
 			return *this;
 		}
 
 		ImageT( ImageT const& src )
 		{
-			T* srcData = src.getData();
-			size_t sz = src.getWidth() * src.getChannelOrder().getNumberOfChannels() * src.getHeight();
-			T *data = new T[ sz ];
-
-			memcpy( data, srcData, sz*sizeof( T ) );
-
-			m_ImageObject = std::auto_ptr< ImageObject >( new ImageObject( data, true, src.getWidth(), src.getHeight(), src.getRowPitch(), src.getChannelOrder() ) );
+			m_ImageObject = std::auto_ptr< ImageObject >( new ImageObject(nullptr, false, 0, 0, 0, src.getChannelOrder()) );
+			m_ImageObject->shareData( *src.m_ImageObject );
 		}
 
+		// allocates an uninitialized image from the buffer pool
 		ImageT( const uint32_t width, const uint32_t height, ImageChannelOrder const& channelOrder )
 		{
 			uint32_t rowBytes = width * sizeof(T) * channelOrder.getNumberOfChannels();
-			T *data = new T[width*channelOrder.getNumberOfChannels()*height];
-			m_ImageObject = std::auto_ptr< ImageObject >( new ImageObject(data, true, width, height, rowBytes, channelOrder) );
+			m_ImageObject = std::auto_ptr< ImageObject >( new ImageObject(nullptr, false, width, height, rowBytes, channelOrder) );
+			m_ImageObject->allocate();
 		}
 
 		ImageT(T *data, const bool ownsData, const uint32_t width, const uint32_t height, ImageChannelOrder const& channelOrder)
@@ -333,7 +368,15 @@ namespace _2Real
 		void assign( T *data, const bool ownsData, const uint32_t width, const uint32_t height, ImageChannelOrder const& channelOrder )
 		{
 			uint32_t rowBytes = width * sizeof(T) * channelOrder.getNumberOfChannels();
-			m_ImageObject = std::auto_ptr< ImageObject >( new ImageObject(data, ownsData, width, height, rowBytes, channelOrder) );
+			m_ImageObject->setData( data, ownsData, width, height, rowBytes, channelOrder );
+		}
+
+		// re-shapes the image, reusing the current pooled buffer if it is unshared & large enough; contents are undefined afterwards
+		void allocate( const uint32_t width, const uint32_t height, ImageChannelOrder const& channelOrder )
+		{
+			uint32_t rowBytes = width * sizeof(T) * channelOrder.getNumberOfChannels();
+			m_ImageObject->setData( nullptr, false, width, height, rowBytes, channelOrder );
+			m_ImageObject->allocate();
 		}
 
 		bool operator==( ImageT< T > const& other ) const
@@ -345,7 +388,7 @@ namespace _2Real
 		const uint32_t				getHeight() const { return m_ImageObject->m_Height; }
 		const uint32_t				getRowPitch() const { return m_ImageObject->m_RowPitch; }
 
-		T *							getData() { return m_ImageObject->m_ImageData; }
+		T *							getData() { m_ImageObject->detach(); return m_ImageObject->m_ImageData; }
 		T *const					getData() const { return m_ImageObject->m_ImageData; }
 
 		bool						hasAlpha() const { return m_ImageObject->m_ChannelOrder.hasAlpha(); }
@@ -357,16 +400,17 @@ namespace _2Real
 		uint8_t						getBlueOffset() const { return m_ImageObject->m_ChannelOrder.getBlueOffset(); }
 		uint8_t						getAlphaOffset() const { return m_ImageObject->m_ChannelOrder.getAlphaOffset(); }
 
-		ImageChannelT< T > &		getChannelRed() { return m_ImageObject->m_Channels[ImageChannelOrder::RED]; }
-		ImageChannelT< T > &		getChannelGreen() { return m_ImageObject->m_Channels[ImageChannelOrder::GREEN]; }
-		ImageChannelT< T > &		getChannelBlue() { return m_ImageObject->m_Channels[ImageChannelOrder::BLUE]; }
-		ImageChannelT< T > &		getChannelAlpha() { return m_ImageObject->m_Channels[ImageChannelOrder::ALPHA]; }
+		ImageChannelT< T > &		getChannelRed() { m_ImageObject->detach(); return m_ImageObject->m_Channels[ImageChannelOrder::RED]; }
+		ImageChannelT< T > &		getChannelGreen() { m_ImageObject->detach(); return m_ImageObject->m_Channels[ImageChannelOrder::GREEN]; }
+		ImageChannelT< T > &		getChannelBlue() { m_ImageObject->detach(); return m_ImageObject->m_Channels[ImageChannelOrder::BLUE]; }
+		ImageChannelT< T > &		getChannelAlpha() { m_ImageObject->detach(); return m_ImageObject->m_Channels[ImageChannelOrder::ALPHA]; }
 		ImageChannelT< T > const&	getChannelRed() const { return m_ImageObject->m_Channels[ImageChannelOrder::RED]; }
 		ImageChannelT< T > const&	getChannelGreen() const { return m_ImageObject->m_Channels[ImageChannelOrder::GREEN]; }
 		ImageChannelT< T > const&	getChannelBlue() const { return m_ImageObject->m_Channels[ImageChannelOrder::BLUE]; }
 		ImageChannelT< T > const&	getChannelAlpha() const { return m_ImageObject->m_Channels[ImageChannelOrder::ALPHA]; }
 
 		bool isEmpty() const		{ return ( m_ImageObject->m_Width == 0 || m_ImageObject->m_Height == 0 || m_ImageObject->m_ImageData == nullptr ); }
+		bool isShared() const		{ return ( !m_ImageObject->m_Buffer.isNull() && !m_ImageObject->m_Buffer.isUnique() ); }
 
 	private:
 
@@ -390,6 +434,7 @@ namespace _2Real
 				else if ( m_Width != other.m_Width ) return false;
 				else if ( m_Height != other.m_Height ) return false;
 				else if ( m_RowPitch != other.m_RowPitch ) return false;
+				else if ( m_ImageData == other.m_ImageData ) return true;
 				else
 				{
 					T *pThis = m_ImageData;
@@ -407,25 +452,96 @@ namespace _2Real
 			}
 
 			~ImageObject()
+			{
+				releaseOwnedData();
+			}
+
+			void releaseOwnedData()
 			{
 				if (m_IsDataOwner)
 				{
 					delete [] m_ImageData;
+					m_IsDataOwner = false;
+				}
+				m_ImageData = nullptr;
+			}
+
+			size_t getByteSize() const { return m_RowPitch * m_Height; }
+
+			void setData(T *data, const bool ownsData, const uint32_t width, const uint32_t height, const uint32_t rowBytes, ImageChannelOrder const& order)
+			{
+				if ( data != m_ImageData )
+				{
+					releaseOwnedData();
+					m_Buffer.reset();
+				}
+
+				m_Width = width;
+				m_Height = height;
+				m_RowPitch = rowBytes;
+				m_ImageData = data;
+				m_IsDataOwner = ownsData && m_Buffer.isNull();
+				m_ChannelOrder = order;
+				initChannels();
+			}
+
+			// makes sure the image has an unshared pooled buffer of the current size
+			void allocate()
+			{
+				releaseOwnedData();
+				m_Buffer.allocate( getByteSize() );
+				m_ImageData = reinterpret_cast< T * >( m_Buffer.getData() );
+				initChannels();
+			}
+
+			// pooled buffers are shared, user data is copied into a pooled buffer ( reusing ours if possible )
+			void shareData( ImageObject const& src )
+			{
+				m_Width = src.m_Width;
+				m_Height = src.m_Height;
+				m_RowPitch = src.m_RowPitch;
+				m_ChannelOrder = src.m_ChannelOrder;
+
+				if ( !src.m_Buffer.isNull() )
+				{
+					releaseOwnedData();
+					m_Buffer = src.m_Buffer;
+				}
+				else if ( src.m_ImageData != nullptr )
+				{
+					releaseOwnedData();
+					m_Buffer.assign( src.m_ImageData, getByteSize() );
+				}
+				else
+				{
+					releaseOwnedData();
+					m_Buffer.reset();
+				}
+
+				m_ImageData = reinterpret_cast< T * >( m_Buffer.getData() );
+				initChannels();
+			}
+
+			// copy-on-write
+			void detach()
+			{
+				if ( !m_Buffer.isNull() && !m_Buffer.isUnique() )
+				{
+					m_Buffer.makeUnique( getByteSize() );
+					m_ImageData = reinterpret_cast< T * >( m_Buffer.getData() );
+					initChannels();
 				}
 			}
 
+			// the channels are views into the image data, re-pointed in place
 			void initChannels()
 			{
-				m_Channels[ImageChannelOrder::RED] =
-				ImageChannelT< T >(m_ImageData + m_ChannelOrder.getRedOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
-				m_Channels[ImageChannelOrder::GREEN] =
-				ImageChannelT< T >(m_ImageData + m_ChannelOrder.getGreenOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
-				m_Channels[ImageChannelOrder::BLUE] =
-				ImageChannelT< T >(m_ImageData + m_ChannelOrder.getBlueOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
+				m_Channels[ImageChannelOrder::RED].assign(m_ImageData + m_ChannelOrder.getRedOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
+				m_Channels[ImageChannelOrder::GREEN].assign(m_ImageData + m_ChannelOrder.getGreenOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
+				m_Channels[ImageChannelOrder::BLUE].assign(m_ImageData + m_ChannelOrder.getBlueOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
 				if(m_ChannelOrder.hasAlpha())
 				{
-					m_Channels[ImageChannelOrder::ALPHA] =
-					ImageChannelT< T >(m_ImageData + m_ChannelOrder.getAlphaOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
+					m_Channels[ImageChannelOrder::ALPHA].assign(m_ImageData + m_ChannelOrder.getAlphaOffset(), false, m_Width, m_Height, m_RowPitch, m_ChannelOrder.getNumberOfChannels());
 				}
 			}
 
@@ -440,6 +556,7 @@ namespace _2Real
 			uint32_t								m_RowPitch;
 			T										*m_ImageData;
 			bool									m_IsDataOwner;
+			SharedBuffer							m_Buffer;
 			ImageChannelOrder						m_ChannelOrder;
 			ImageChannelT< T >						m_Channels[4];
 
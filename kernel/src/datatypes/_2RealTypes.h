@@ -20,6 +20,7 @@
 
 #include "helpers/_2RealException.h"
 #include "helpers/_2RealTypeDescriptor.h"
+#include "helpers/_2RealAtomic.h"
 
 #include "datatypes/_2RealImage.h"
 #include "datatypes/_2RealImageT.h"
@@ -55,12 +56,15 @@ namespace _2Real
 
 	template< typename T > struct traits;
 
+	template< typename T >
+	TypeDescriptor const* getTypeDescriptor();
+
 	template< typename T >
 	struct traits< std::vector< T > >
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( std::vector< T > ), Type::VECTOR, "vector", traits< T >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( std::vector< T > ), Type::VECTOR, "vector", getTypeDescriptor< T >() );
 		}
 	};
 
@@ -69,7 +73,7 @@ namespace _2Real
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( std::vector< T, Eigen::aligned_allocator< T > > ), Type::VECTOR, "vector", traits< T >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( std::vector< T, Eigen::aligned_allocator< T > > ), Type::VECTOR, "vector", getTypeDescriptor< T >() );
 		}
 	};
 
@@ -78,7 +82,7 @@ namespace _2Real
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( std::list< T > ), Type::LIST, "list", traits< T >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( std::list< T > ), Type::LIST, "list", getTypeDescriptor< T >() );
 		}
 	};
 
@@ -222,7 +226,7 @@ namespace _2Real
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( Image8U ), Type::IMAGE, "image", traits< unsigned char >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( Image8U ), Type::IMAGE, "image", getTypeDescriptor< unsigned char >() );
 		}
 	};
 
@@ -231,7 +235,7 @@ namespace _2Real
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( Image16U ), Type::IMAGE, "image", traits< unsigned short >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( Image16U ), Type::IMAGE, "image", getTypeDescriptor< unsigned short >() );
 		}
 	};
 
@@ -240,7 +244,7 @@ namespace _2Real
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( Image32F ), Type::IMAGE, "image", traits< float >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( Image32F ), Type::IMAGE, "image", getTypeDescriptor< float >() );
 		}
 	};
 
@@ -249,7 +253,7 @@ namespace _2Real
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( Image64F ), Type::IMAGE, "image", traits< double >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( Image64F ), Type::IMAGE, "image", getTypeDescriptor< double >() );
 		}
 	};
 
@@ -258,7 +262,7 @@ namespace _2Real
 	{
 		static TypeDescriptor *createTypeDescriptor()
 		{
-			return new TypeDescriptor( typeid( Image ), Type::IMAGE, "image", traits< Number >::createTypeDescriptor() );
+			return new TypeDescriptor( typeid( Image ), Type::IMAGE, "image", getTypeDescriptor< Number >() );
 		}
 	};
 
@@ -418,8 +422,27 @@ namespace _2Real
 	//};
 
 	template< typename T >
-	TypeDescriptor * createTypeDescriptor()
+	struct TypeDescriptorCache
+	{
+		static TypeDescriptor const *volatile s_Descriptor;
+	};
+
+	template< typename T >
+	TypeDescriptor const *volatile TypeDescriptorCache< T >::s_Descriptor = nullptr;
+
+	// returns the interned descriptor for T: the first call locks the registry, after that this is a single
+	// atomic load, no allocation. the pointer is published by compare & swap, so a thread that sees it also
+	// sees the finished descriptor ( racing first calls all end up with the same registered instance )
+	template< typename T >
+	TypeDescriptor const* getTypeDescriptor()
 	{
-		return traits< T >::createTypeDescriptor();
+		TypeDescriptor const* descriptor = atomicLoad( TypeDescriptorCache< T >::s_Descriptor );
+		if ( descriptor == nullptr )
+		{
+			TypeDescriptor const* interned = TypeRegistry::intern( traits< T >::createTypeDescriptor() );
+			if ( atomicCompareAndSwap( TypeDescriptorCache< T >::s_Descriptor, descriptor, interned ) ) descriptor = interned;
+			else descriptor = atomicLoad( TypeDescriptorCache< T >::s_Descriptor );
+		}
+		return descriptor;
 	}
 }
@@ -48,8 +48,11 @@ namespace _2Real
 	BasicInletIO::BasicInletIO( AbstractUberBlock &owner, AbstractUpdatePolicy &policy, InletInfo const& info ) :
 		AbstractInletIO( owner, policy, info ),
 		m_Inlet( new BasicInlet( owner, info.baseName ) ),
-		m_Buffer( new BasicInletBuffer( info.initValue.anyValue, info.options ) )
+		m_Buffer( new BasicInletBuffer( info.initValue.anyValue, info.options ) ),
+		m_FrameSource( nullptr ),
+		m_FrameSourceKey( -1 )
 	{
+		m_Buffer->setTraceName( owner.getFullName() + "." + info.baseName );
 	}
 
 	BasicInletIO::~BasicInletIO()
@@ -78,6 +81,31 @@ namespace _2Real
 		m_Buffer->setBufferSize( size );
 	}
 
+	void BasicInletIO::setOverflowPolicy( OverflowPolicy const& p )
+	{
+		m_Buffer->setOverflowPolicy( p );
+	}
+
+	unsigned long BasicInletIO::getOverflowCount() const
+	{
+		return m_Buffer->getOverflowCount();
+	}
+
+	void BasicInletIO::setBatchDelivery( const bool enabled )
+	{
+		m_Buffer->setBatchDelivery( enabled );
+	}
+
+	void BasicInletIO::setImageFormat( ImageFormat const& format )
+	{
+		m_Buffer->setImageFormat( format );
+	}
+
+	void BasicInletIO::clearImageFormat()
+	{
+		m_Buffer->clearImageFormat();
+	}
+
 	void BasicInletIO::setUpdatePolicy( InletPolicy const& p )
 	{
 		m_Info.policy = p;
@@ -106,7 +134,32 @@ namespace _2Real
 
 	void BasicInletIO::syncInletData()
 	{
+		if ( m_FrameSource != nullptr )
+		{
+			// the source block was updated earlier in the same frame; if it did not publish anything new,
+			// the inlet keeps its data ( and hasUpdated returns false )
+			TimestampedData data = m_FrameSource->getData();
+			if ( data.key != m_FrameSourceKey )
+			{
+				m_FrameSourceKey = data.key;
+				m_Inlet->setData( m_Buffer->applyImageFormat( TimestampedData( data.anyValue, data.timestamp, m_Buffer->nextKey(), data.version ) ) );
+			}
+			else m_Inlet->setData( m_Inlet->getCurrentData() );
+			return;
+		}
+
+		m_Buffer->convertTriggeringData();
 		m_Inlet->setData( m_Buffer->getTriggeringData() );
+		if ( m_Buffer->isBatchDelivery() || !m_Inlet->getCurrentBatch().empty() )
+		{
+			m_Inlet->setBatch( m_Buffer->getTriggeringBatch() );
+		}
+	}
+
+	void BasicInletIO::setFrameSource( Outlet *source )
+	{
+		m_FrameSource = source;
+		m_FrameSourceKey = -1;
 	}
 
 	void BasicInletIO::processBufferedData( const bool enableTriggering )
@@ -272,7 +325,8 @@ namespace _2Real
 		Handleable< OutletIO, app::OutletHandle >( *this ),
 		m_Outlet( new Outlet( owner, name, type, initialValue ) ),
 		m_AppEvent( new CallbackEvent< app::AppData const& >() ),
-		m_InletEvent( new CallbackEvent< TimestampedData const& >() )
+		m_InletEvent( new CallbackEvent< TimestampedData const& >() ),
+		m_IsParallelFanOut( 0 )
 	{
 	}
 
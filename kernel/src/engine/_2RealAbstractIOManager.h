@@ -20,6 +20,7 @@
 
 #include "helpers/_2RealEvent.h"
 #include "helpers/_2RealPoco.h"
+#include "helpers/_2RealAtomic.h"
 #include "helpers/_2RealNonCopyable.h"
 #include "helpers/_2RealHandleable.h"
 #include "app/_2RealInletHandle.h"
@@ -57,6 +58,7 @@ namespace _2Real
 	class Outlet;
 	class TimestampedData;
 	class AbstractUberBlock;
+	struct ImageFormat;
 	class AnyOptionSet;
 	class TypeDescriptor;
 	class AbstractUpdatePolicy;
@@ -131,6 +133,11 @@ namespace _2Real
 		std::string const&					getName() const;
 		TimestampedData const&				getData() const;
 		void								setBufferSize( const unsigned int size );
+		void								setOverflowPolicy( OverflowPolicy const& p );
+		unsigned long						getOverflowCount() const;
+		void								setBatchDelivery( const bool enabled );
+		void								setImageFormat( ImageFormat const& format );
+		void								clearImageFormat();
 		void								setUpdatePolicy( InletPolicy const& p );
 		void								receiveData( Any const& dataAsAny );
 		void								receiveData( std::string const& dataAsString );
@@ -138,6 +145,8 @@ namespace _2Real
 		void								setInitialValueToString( std::string const& dataAsString );
 		void								syncInletData();
 		void								processBufferedData( const bool enableTriggering );
+		// frame mode: if set, syncInletData reads the outlet directly & ignores the buffer
+		void								setFrameSource( Outlet *source );
 		void								clearBufferedData();
 
 		const std::string					getBufferSizeAsString() const;
@@ -149,6 +158,8 @@ namespace _2Real
 
 		BasicInlet							*m_Inlet;
 		BasicInletBuffer					*m_Buffer;
+		Outlet								*m_FrameSource;
+		long								m_FrameSourceKey;		// key of the outlet data that was read last
 
 	};
 
@@ -206,6 +217,7 @@ namespace _2Real
 		Outlet													*m_Outlet;
 		CallbackEvent< app::AppData const& >					*m_AppEvent;
 		CallbackEvent< TimestampedData const& >					*m_InletEvent;
+		AtomicLong												m_IsParallelFanOut;		// 1 -> linked inlets receive in parallel, on the block's thread pool
 
 	};
 
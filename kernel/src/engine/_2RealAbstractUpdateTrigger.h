@@ -19,7 +19,7 @@
 
 #pragma once
 
-#include "helpers/_2RealPoco.h"
+#include "helpers/_2RealAtomic.h"
 
 namespace _2Real
 {
@@ -29,17 +29,22 @@ namespace _2Real
 
 	public:
 
-		UpdateCondition( const bool fulfilled ) : m_IsFulfilled( fulfilled ) {}
+		UpdateCondition( const bool fulfilled ) : m_IsFulfilled( fulfilled ? 1 : 0 ) {}
 		virtual ~UpdateCondition() {}
 
-		bool isFulfilled() const { Poco::ScopedLock< Poco::FastMutex > lock( m_Access ); return m_IsFulfilled; }
-		void set( const bool fulfilled ) { Poco::ScopedLock< Poco::FastMutex > lock( m_Access ); m_IsFulfilled = fulfilled; }
+		bool isFulfilled() const { return ( m_IsFulfilled.load() == 1 ); }
+
+		// both return true only for the thread that actually changed the state,
+		// which allows the state manager to keep count of the fulfilled conditions
+		bool tryFulfill() { return m_IsFulfilled.compareAndSwap( 0, 1 ); }
+		bool tryReset() { return m_IsFulfilled.compareAndSwap( 1, 0 ); }
+
+		// once detached, the condition can't be fulfilled any more; returns true if it was fulfilled before
+		bool detach() { return ( m_IsFulfilled.exchange( 2 ) == 1 ); }
 
 	protected:
 
-		mutable Poco::FastMutex		m_Access;
-		bool						m_IsFulfilled;
-		bool						m_IsOr;
+		AtomicLong					m_IsFulfilled;
 
 	};
 
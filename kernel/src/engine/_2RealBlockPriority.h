@@ -0,0 +1,56 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+
+namespace _2Real
+{
+	// scheduling class of a block: ready blocks are updated earliest deadline first, a request's deadline being
+	// the time it was scheduled plus the block's relative deadline. unless set explicitly, the relative deadline
+	// follows from the priority; the priority also raises or lowers the os priority of the worker while it updates the block
+	class BlockPriority
+	{
+
+	public:
+
+		enum Priority
+		{
+			PRIO_LOW		= 0,		// analysis & other background work
+			PRIO_NORMAL		= 1,
+			PRIO_HIGH		= 2			// output critical blocks, e.g. display or audio rendering
+		};
+
+		// relative deadline in us
+		static long getDefaultDeadline( Priority const& p )
+		{
+			if ( p == PRIO_HIGH )				return 2000;
+			else if ( p == PRIO_NORMAL )		return 20000;
+			else								return 100000;
+		}
+
+		static const std::string getPriorityAsString( Priority const& p )
+		{
+			if ( p == PRIO_HIGH )				return "high";
+			else if ( p == PRIO_NORMAL )		return "normal";
+			else								return "low";
+		}
+
+	};
+}
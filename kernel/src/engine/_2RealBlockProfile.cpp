@@ -0,0 +1,164 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#include "engine/_2RealBlockProfile.h"
+
+namespace _2Real
+{
+
+	// trigger times are stored in an AtomicLong ( 32 bit on windows ), so they wrap after ~18 minutes;
+	// latencies are way below that
+	static const Timer::Time TimeMask = 0x3fffffff;
+
+	void BlockProfile::Statistic::record( const long value )
+	{
+		count.increment();
+		total.add( value );
+
+		long curr = max.load();
+		while ( value > curr && !max.compareAndSwap( curr, value ) )
+		{
+			curr = max.load();
+		}
+	}
+
+	void BlockProfile::Statistic::reset()
+	{
+		count.store( 0 );
+		total.store( 0 );
+		max.store( 0 );
+	}
+
+	long BlockProfile::Statistic::average() const
+	{
+		const long n = count.load();
+		return ( n > 0 ? static_cast< long >( total.load() / n ) : 0 );
+	}
+
+	BlockProfile::BlockProfile() :
+		m_DroppedItems( 0 ),
+		m_TriggerTime( 0 ),
+		m_RateTime( Timer::now() ),
+		m_RateCount( 0 ),
+		m_Rate( 0.0 )
+	{
+	}
+
+	long BlockProfile::wrapTime( const Timer::Time t )
+	{
+		return static_cast< long >( t & TimeMask ) + 1;
+	}
+
+	void BlockProfile::recordQueueWait( const long micros )
+	{
+		m_QueueWait.record( micros );
+	}
+
+	void BlockProfile::recordUpdate( const long micros )
+	{
+		m_Update.record( micros );
+
+		unsigned int bucket = 0;
+		while ( bucket < app::BlockMetrics::HistogramBuckets - 1 && ( 1L << bucket ) <= micros )
+		{
+			++bucket;
+		}
+		m_Histogram[ bucket ].increment();
+	}
+
+	void BlockProfile::recordPublish( const long micros )
+	{
+		m_Publish.record( micros );
+	}
+
+	void BlockProfile::recordTrigger()
+	{
+		if ( m_TriggerTime.load() == 0 )
+		{
+			m_TriggerTime.compareAndSwap( 0, wrapTime( Timer::now() ) );
+		}
+	}
+
+	void BlockProfile::recordUpdateStart( const Timer::Time now )
+	{
+		const long triggered = m_TriggerTime.exchange( 0 );
+		if ( triggered != 0 )
+		{
+			m_TriggerLatency.record( static_cast< long >( ( wrapTime( now ) - triggered ) & TimeMask ) );
+		}
+	}
+
+	void BlockProfile::clearTrigger()
+	{
+		m_TriggerTime.store( 0 );
+	}
+
+	AtomicLong & BlockProfile::getDroppedItemCounter()
+	{
+		return m_DroppedItems;
+	}
+
+	void BlockProfile::getMetrics( app::BlockMetrics &metrics )
+	{
+		metrics.updates = static_cast< unsigned long >( m_Update.count.load() );
+		metrics.averageUpdateTime = m_Update.average();
+		metrics.maxUpdateTime = m_Update.max.load();
+		metrics.averageQueueWait = m_QueueWait.average();
+		metrics.maxQueueWait = m_QueueWait.max.load();
+		metrics.averageTriggerLatency = m_TriggerLatency.average();
+		metrics.maxTriggerLatency = m_TriggerLatency.max.load();
+		metrics.averagePublishTime = m_Publish.average();
+		metrics.maxPublishTime = m_Publish.max.load();
+		metrics.droppedInletItems = static_cast< unsigned long >( m_DroppedItems.load() );
+		for ( unsigned int i=0; i<app::BlockMetrics::HistogramBuckets; ++i )
+		{
+			metrics.updateTimeHistogram[ i ] = static_cast< unsigned long >( m_Histogram[ i ].load() );
+		}
+
+		// the rate window only moves on if at least a second has passed, so frequent queries don't make it jitter
+		Poco::ScopedLock< Poco::FastMutex > lock( m_RateAccess );
+		const Timer::Time now = Timer::now();
+		const Timer::Time elapsed = now - m_RateTime;
+		if ( elapsed >= 1000000 )
+		{
+			const unsigned long count = metrics.updates;
+			m_Rate = ( count >= m_RateCount ? count - m_RateCount : count ) * 1000000.0 / elapsed;
+			m_RateCount = count;
+			m_RateTime = now;
+		}
+		metrics.updatesPerSecond = m_Rate;
+	}
+
+	void BlockProfile::reset()
+	{
+		m_Update.reset();
+		m_QueueWait.reset();
+		m_TriggerLatency.reset();
+		m_Publish.reset();
+		m_DroppedItems.store( 0 );
+		for ( unsigned int i=0; i<app::BlockMetrics::HistogramBuckets; ++i )
+		{
+			m_Histogram[ i ].store( 0 );
+		}
+
+		Poco::ScopedLock< Poco::FastMutex > lock( m_RateAccess );
+		m_RateTime = Timer::now();
+		m_RateCount = 0;
+		m_Rate = 0.0;
+	}
+
+}
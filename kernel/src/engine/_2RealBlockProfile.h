@@ -0,0 +1,83 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#pragma once
+
+#include "engine/_2RealTimer.h"
+#include "app/_2RealBlockMetrics.h"
+#include "helpers/_2RealAtomic.h"
+#include "helpers/_2RealNonCopyable.h"
+#include "helpers/_2RealPoco.h"
+
+namespace _2Real
+{
+
+	// profiling counters of one block; recording is lock free ( a few atomic adds ),
+	// only taking a snapshot locks. times are in microseconds
+	class BlockProfile : private NonCopyable< BlockProfile >
+	{
+
+	public:
+
+		BlockProfile();
+
+		void				recordQueueWait( const long micros );
+		void				recordUpdate( const long micros );
+		void				recordPublish( const long micros );
+		// the first trigger after an update is remembered, the next update's start measures the latency
+		void				recordTrigger();
+		void				recordUpdateStart( const Timer::Time now );
+		void				clearTrigger();
+
+		AtomicLong &		getDroppedItemCounter();
+
+		void				getMetrics( app::BlockMetrics &metrics );
+		void				reset();
+
+	private:
+
+		struct Statistic
+		{
+			Statistic() : count( 0 ), total( 0 ), max( 0 ) {}
+
+			void record( const long value );
+			void reset();
+			long average() const;
+
+			AtomicLong		count;
+			AtomicInt64		total;			// a long of microseconds overflows after ~36 minutes
+			AtomicLong		max;
+		};
+
+		static long			wrapTime( const Timer::Time t );
+
+		Statistic			m_Update;
+		Statistic			m_QueueWait;
+		Statistic			m_TriggerLatency;
+		Statistic			m_Publish;
+		AtomicLong			m_Histogram[ app::BlockMetrics::HistogramBuckets ];
+		AtomicLong			m_DroppedItems;
+		AtomicLong			m_TriggerTime;			// wrapped, 0: no pending trigger
+
+		Poco::FastMutex		m_RateAccess;
+		Timer::Time			m_RateTime;
+		unsigned long		m_RateCount;
+		double				m_Rate;
+
+	};
+
+}
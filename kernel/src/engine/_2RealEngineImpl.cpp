@@ -24,6 +24,9 @@
 #include "engine/_2RealLogger.h"
 #include "engine/_2RealSystem.h"
 #include "engine/_2RealFunctionBlock.h"
+#include "engine/_2RealFrameGroup.h"
+#include "engine/_2RealFusedLink.h"
+#include "engine/_2RealOutlet.h"
 #include "helpers/_2RealCallback.h"
 #include "helpers/_2RealEvent.h"
 #include "helpers/_2RealSingletonHolder.h"
@@ -38,6 +41,7 @@
 
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 #ifdef _2REAL_WINDOWS
 	#ifndef _DEBUG
@@ -74,9 +78,10 @@ namespace _2Real
 	EngineImpl::EngineImpl() :
 		m_Logger( new Logger( "EngineLog.txt" ) ),
 		m_Timer( new Timer( *m_Logger ) ),
-		m_ThreadPool( new ThreadPool( *this, 3, 0, "2Real threadpool" ) ),
+		m_ThreadPool( new ThreadPool( *this, 0, 0, "2Real threadpool" ) ),
 		m_BundleManager( new BundleManager( *this ) ),
-		m_System( new System( *m_Logger ) )
+		m_System( new System( *m_Logger ) ),
+		m_NextFrameGroupId( 0 )
 	{
 		m_Timestamp.update();
 
@@ -87,14 +92,19 @@ namespace _2Real
 	{
 		try
 		{
-			m_Logger->addLine( "ENGINE SHUTDOWN" );
+			_2REAL_LOG( *m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_ENGINE, "ENGINE SHUTDOWN" );
 			clearFully();
+			for ( ThreadPoolIterator it = m_ThreadPools.begin(); it != m_ThreadPools.end(); ++it )
+			{
+				delete it->second;
+			}
+			m_ThreadPools.clear();
 			delete m_System;
 			delete m_BundleManager;
 			delete m_ThreadPool;
+			delete m_Timer;
 			m_Logger->stop();
 			delete m_Logger;
-			delete m_Timer;
 		}
 		catch ( std::exception &e )
 		{
@@ -104,6 +114,8 @@ namespace _2Real
 
 	void EngineImpl::clearFully()
 	{
+		destroyFrameGroups();
+		unfuseLinearChains();
 		for ( EngineImpl::LinkIterator it = m_Links.begin(); it != m_Links.end(); ++it )
 		{
 			( *it )->deactivate();
@@ -116,6 +128,8 @@ namespace _2Real
 
 	void EngineImpl::clearBlockInstances()
 	{
+		destroyFrameGroups();
+		unfuseLinearChains();
 		for ( EngineImpl::LinkIterator it = m_Links.begin(); it != m_Links.end(); ++it )
 		{
 			( *it )->deactivate();
@@ -132,6 +146,8 @@ namespace _2Real
 
 	void EngineImpl::removeBlock( FunctionBlock< app::BlockHandle > &block, const long timeout )
 	{
+		destroyFrameGroupsFor( block );
+		destroyFusedLinksFor( block );
 		Bundle &b = m_BundleManager->findBundleByName( block.getBundleName() );
 		b.removeBlockInstance( block );
 		for ( LinkIterator it = m_Links.begin(); it != m_Links.end(); )
@@ -194,6 +210,88 @@ namespace _2Real
 		return *m_ThreadPool;
 	}
 
+	ThreadPool & EngineImpl::getThreadPool( string const& name )
+	{
+		if ( name.empty() ) return *m_ThreadPool;
+
+		ThreadPoolIterator it = m_ThreadPools.find( name );
+		if ( it == m_ThreadPools.end() )
+		{
+			throw NotFoundException( "thread pool " + name + " not found" );
+		}
+		return *( it->second );
+	}
+
+	void EngineImpl::createThreadPool( string const& name, CpuSet const& cpus, const unsigned int numThreads )
+	{
+		if ( name.empty() || m_ThreadPools.find( name ) != m_ThreadPools.end() )
+		{
+			throw Exception( "thread pool name " + name + " is empty or already in use" );
+		}
+
+		const unsigned int numCpus = std::max< unsigned int >( Poco::Environment::processorCount(), 1 );
+		for ( CpuSetConstIterator it = cpus.begin(); it != cpus.end(); ++it )
+		{
+			if ( *it >= numCpus )
+			{
+				ostringstream msg;
+				msg << "thread pool " << name << ": cpu " << *it << " does not exist, there are " << numCpus;
+				throw Exception( msg.str() );
+			}
+		}
+
+		ThreadPool *pool = new ThreadPool( *this, numThreads, 0, name, cpus );
+		pool->setMetricsLogging( m_ThreadPool->isMetricsLoggingEnabled() );
+		m_ThreadPools[ name ] = pool;
+	}
+
+	void EngineImpl::destroyThreadPool( string const& name )
+	{
+		ThreadPoolIterator it = m_ThreadPools.find( name );
+		if ( it == m_ThreadPools.end() )
+		{
+			throw NotFoundException( "thread pool " + name + " not found" );
+		}
+		else if ( it->second->getNumberOfBlocks() > 0 )
+		{
+			throw Exception( "thread pool " + name + " is still used by some blocks" );
+		}
+
+		delete it->second;
+		m_ThreadPools.erase( it );
+	}
+
+	void EngineImpl::setThreadPool( FunctionBlock< app::BlockHandle > &block, string const& name )
+	{
+		ThreadPool &pool = getThreadPool( name );
+
+		if ( block.isRunning() )
+		{
+			throw Exception( "block " + block.getName() + " is running, stop it first" );
+		}
+
+		for ( FrameGroupConstIterator it = m_FrameGroups.begin(); it != m_FrameGroups.end(); ++it )
+		{
+			if ( it->second->containsBlock( block ) )
+			{
+				throw Exception( "block " + block.getName() + " belongs to a frame group, destroy the group first" );
+			}
+		}
+
+		// a fused successor runs on its predecessor's worker, so fusion must not cross pools
+		if ( &block.getThreadPool() != &pool ) destroyFusedLinksFor( block );
+		block.setThreadPool( pool );
+	}
+
+	void EngineImpl::setMetricsLogging( const bool enabled )
+	{
+		m_ThreadPool->setMetricsLogging( enabled );
+		for ( ThreadPoolIterator it = m_ThreadPools.begin(); it != m_ThreadPools.end(); ++it )
+		{
+			it->second->setMetricsLogging( enabled );
+		}
+	}
+
 	void EngineImpl::setBaseDirectory( string const& directory )
 	{
 		m_BundleManager->setBaseDirectory( directory );
@@ -301,6 +399,8 @@ namespace _2Real
 
 	void EngineImpl::clearLinksFor( BasicInletIO &inlet )
 	{
+		destroyFrameGroupsFor( inlet );
+		destroyFusedLinksFor( inlet );
 		for ( LinkIterator it = m_Links.begin(); it != m_Links.end(); )
 		{
 			if ( ( *it )->isInletInvolved( inlet ) )
@@ -323,6 +423,8 @@ namespace _2Real
 			LinkIterator it = m_Links.find( link );
 			if ( it == m_Links.end() )
 			{
+				destroyFrameGroupsFor( inlet );
+				destroyFusedLinksFor( inlet );
 				link->activate();
 				m_Links.insert( link );
 				return *link;
@@ -341,12 +443,30 @@ namespace _2Real
 
 	std::pair< IOLink, IOLink > EngineImpl::createLinkWithConversion( BasicInletIO &inlet, OutletIO &outlet )
 	{
+		if ( inlet.info().type.isSameType( outlet.m_Outlet->getTypeDescriptor() ) )
+		{
+			// images carry their depth & channel order at runtime: if the initial value of the inlet
+			// has a format, the inlet buffer converts everything it receives to it
+			Any initialValue = inlet.getBuffer().getInitialValue();
+			if ( initialValue.isDatatype< Image >() && !inlet.getBuffer().hasImageFormat() )
+			{
+				Image const& init = initialValue.extract< Image >();
+				if ( init.getWidth() > 0 && init.getHeight() > 0 )
+				{
+					inlet.setImageFormat( ImageFormat( init.getImageType(), init.getChannelOrder(), 0. ) );
+				}
+			}
+			return std::make_pair( createLink( inlet, outlet ), IOLink() );
+		}
+
 		if ( IOLink::canAutoConvert( inlet, outlet ) )
 		{
 			IOLink *link = IOLink::linkWithAutoConversion( inlet, outlet );
 			LinkIterator it = m_Links.find( link );
 			if ( it == m_Links.end() )
 			{
+				destroyFrameGroupsFor( inlet );
+				destroyFusedLinksFor( inlet );
 				link->activate();
 				m_Links.insert( link );
 				return std::make_pair( *link, IOLink() );
@@ -397,4 +517,206 @@ namespace _2Real
 	{
 	}
 
+	unsigned int EngineImpl::createFrameGroup( std::vector< app::BlockHandle > const& blocks, const double framesPerSecond )
+	{
+		BlockInstances instances = getCurrentBlockInstances();
+		FrameGroup::Blocks grouped;
+
+		for ( std::vector< app::BlockHandle >::const_iterator hIt = blocks.begin(); hIt != blocks.end(); ++hIt )
+		{
+			FunctionBlock< app::BlockHandle > *block = nullptr;
+			for ( BlockInstanceIterator bIt = instances.begin(); bIt != instances.end(); ++bIt )
+			{
+				if ( ( *bIt )->getHandle() == *hIt )
+				{
+					block = *bIt;
+					break;
+				}
+			}
+
+			if ( block == nullptr )
+			{
+				throw NotFoundException( "frame group: block not found" );
+			}
+			else if ( block->isRunning() )
+			{
+				throw Exception( "frame group: block " + block->getName() + " is running, stop it first" );
+			}
+
+			for ( FrameGroupConstIterator it = m_FrameGroups.begin(); it != m_FrameGroups.end(); ++it )
+			{
+				if ( it->second->containsBlock( *block ) )
+				{
+					throw Exception( "frame group: block " + block->getName() + " already belongs to a frame group" );
+				}
+			}
+
+			if ( std::find( grouped.begin(), grouped.end(), block ) == grouped.end() )
+			{
+				grouped.push_back( block );
+			}
+		}
+
+		// inside the group, the frame takes care of the ordering
+		for ( FrameGroup::BlockIterator it = grouped.begin(); it != grouped.end(); ++it )
+		{
+			destroyFusedLinksFor( **it );
+		}
+
+		FrameGroup *group = new FrameGroup( grouped, m_Links, framesPerSecond );
+		const unsigned int id = m_NextFrameGroupId++;
+		m_FrameGroups[ id ] = group;
+		return id;
+	}
+
+	void EngineImpl::destroyFrameGroup( const unsigned int id )
+	{
+		FrameGroupIterator it = m_FrameGroups.find( id );
+		if ( it == m_FrameGroups.end() )
+		{
+			ostringstream msg;
+			msg << "frame group " << id << " not found";
+			throw NotFoundException( msg.str() );
+		}
+
+		delete it->second;
+		m_FrameGroups.erase( it );
+	}
+
+	void EngineImpl::destroyFrameGroups()
+	{
+		for ( FrameGroupIterator it = m_FrameGroups.begin(); it != m_FrameGroups.end(); ++it )
+		{
+			delete it->second;
+		}
+		m_FrameGroups.clear();
+	}
+
+	void EngineImpl::destroyFrameGroupsFor( AbstractUberBlock const& block )
+	{
+		for ( FrameGroupIterator it = m_FrameGroups.begin(); it != m_FrameGroups.end(); )
+		{
+			if ( it->second->containsBlock( block ) )
+			{
+				delete it->second;
+				m_FrameGroups.erase( it++ );
+			}
+			else ++it;
+		}
+	}
+
+	void EngineImpl::destroyFrameGroupsFor( BasicInletIO const& inlet )
+	{
+		for ( FrameGroupIterator it = m_FrameGroups.begin(); it != m_FrameGroups.end(); )
+		{
+			if ( it->second->containsInlet( inlet ) )
+			{
+				delete it->second;
+				m_FrameGroups.erase( it++ );
+			}
+			else ++it;
+		}
+	}
+
+	unsigned int EngineImpl::fuseLinearChains()
+	{
+		BlockInstances instances = getCurrentBlockInstances();
+		unsigned int count = 0;
+
+		for ( LinkIterator lIt = m_Links.begin(); lIt != m_Links.end(); ++lIt )
+		{
+			IOLink &link = **lIt;
+			AbstractUberBlock const& src = link.getOutletIO().m_Outlet->getOwningUberBlock();
+
+			FunctionBlock< app::BlockHandle > *upstream = nullptr;
+			FunctionBlock< app::BlockHandle > *downstream = nullptr;
+			for ( BlockInstanceIterator bIt = instances.begin(); bIt != instances.end(); ++bIt )
+			{
+				if ( *bIt == &src ) upstream = *bIt;
+				if ( link.getInletIO().belongsToBlock( *bIt ) ) downstream = *bIt;
+			}
+
+			// context blocks, running & grouped blocks are left alone
+			if ( upstream == nullptr || downstream == nullptr ) continue;
+			if ( upstream->isRunning() || downstream->isRunning() ) continue;
+			if ( &upstream->getThreadPool() != &downstream->getThreadPool() ) continue;
+
+			bool isGrouped = false;
+			for ( FrameGroupConstIterator gIt = m_FrameGroups.begin(); gIt != m_FrameGroups.end(); ++gIt )
+			{
+				if ( gIt->second->containsBlock( *upstream ) || gIt->second->containsBlock( *downstream ) ) isGrouped = true;
+			}
+			if ( isGrouped ) continue;
+
+			// the downstream block has a single linked inlet, so it can have one fused predecessor at most
+			if ( findFusedPredecessor( *downstream ) != nullptr ) continue;
+			if ( !FusedLink::isFusable( link, m_Links, *downstream ) ) continue;
+
+			// no cycles: the downstream block must not be ahead of the upstream block in its chain
+			bool isCycle = false;
+			for ( FusedLink *pred = findFusedPredecessor( *upstream ); pred != nullptr; pred = findFusedPredecessor( pred->getUpstream() ) )
+			{
+				if ( pred->isUpstream( *downstream ) )
+				{
+					isCycle = true;
+					break;
+				}
+			}
+			if ( isCycle ) continue;
+
+			m_FusedLinks.push_back( new FusedLink( link, *upstream, *downstream ) );
+			++count;
+		}
+
+		ostringstream msg;
+		msg << "fused " << count << " links, " << m_FusedLinks.size() << " in total";
+		_2REAL_LOG( *m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_SCHEDULER, msg.str() );
+
+		return count;
+	}
+
+	void EngineImpl::unfuseLinearChains()
+	{
+		for ( FusedLinkIterator it = m_FusedLinks.begin(); it != m_FusedLinks.end(); ++it )
+		{
+			delete *it;
+		}
+		m_FusedLinks.clear();
+	}
+
+	void EngineImpl::destroyFusedLinksFor( AbstractUberBlock const& block )
+	{
+		for ( FusedLinkIterator it = m_FusedLinks.begin(); it != m_FusedLinks.end(); )
+		{
+			if ( ( *it )->isBlockInvolved( block ) )
+			{
+				delete *it;
+				it = m_FusedLinks.erase( it );
+			}
+			else ++it;
+		}
+	}
+
+	void EngineImpl::destroyFusedLinksFor( BasicInletIO const& inlet )
+	{
+		for ( FusedLinkIterator it = m_FusedLinks.begin(); it != m_FusedLinks.end(); )
+		{
+			if ( ( *it )->isInletInvolved( inlet ) )
+			{
+				delete *it;
+				it = m_FusedLinks.erase( it );
+			}
+			else ++it;
+		}
+	}
+
+	FusedLink * EngineImpl::findFusedPredecessor( AbstractUberBlock const& block ) const
+	{
+		for ( FusedLinkConstIterator it = m_FusedLinks.begin(); it != m_FusedLinks.end(); ++it )
+		{
+			if ( ( *it )->isDownstream( block ) ) return *it;
+		}
+		return nullptr;
+	}
+
 }
\ No newline at end of file
@@ -23,11 +23,13 @@
 #include "engine/_2RealLink.h"
 #include "helpers/_2RealEvent.h"
 #include "helpers/_2RealPoco.h"
+#include "helpers/_2RealThreadAffinity.h"
 #include "app/_2RealBlockHandle.h"
 #include "app/_2RealContextBlockHandle.h"
 #include "_2RealSystemState.h"			// MOVE TO APP FOLDER
 
 #include <set>
+#include <map>
 #include <string>
 
 namespace _2Real
@@ -49,6 +51,8 @@ namespace _2Real
 	class AbstractInletIO;
 	class OutletIO;
 	class Bundle;
+	class FrameGroup;
+	class FusedLink;
 
 	template< typename T >
 	class FunctionBlock;
@@ -85,11 +89,25 @@ namespace _2Real
 		typedef std::set< Bundle * >::iterator											BundleIterator;
 		typedef std::set< Bundle * >::const_iterator									BundleConstIterator;
 
+		typedef std::map< unsigned int, FrameGroup * >									FrameGroups;
+		typedef std::map< unsigned int, FrameGroup * >::iterator						FrameGroupIterator;
+		typedef std::map< unsigned int, FrameGroup * >::const_iterator					FrameGroupConstIterator;
+
+		typedef std::list< FusedLink * >												FusedLinks;
+		typedef std::list< FusedLink * >::iterator										FusedLinkIterator;
+		typedef std::list< FusedLink * >::const_iterator								FusedLinkConstIterator;
+
+		typedef std::map< std::string, ThreadPool * >									ThreadPools;
+		typedef std::map< std::string, ThreadPool * >::iterator							ThreadPoolIterator;
+		typedef std::map< std::string, ThreadPool * >::const_iterator					ThreadPoolConstIterator;
+
 		static EngineImpl & instance();
 
 		Timer&							getTimer();
 		Logger&							getLogger();
 		ThreadPool &					getThreadPool();
+		// named pools, the empty name stands for the default pool
+		ThreadPool &					getThreadPool( std::string const& name );
 
 		const long						getElapsedTime() const;
 
@@ -118,6 +136,21 @@ namespace _2Real
 		void							destroyLink( BasicInletIO &inlet, OutletIO &outlet );
 		void							clearLinksFor( BasicInletIO &inlet );
 
+		// frame mode, see FrameGroup
+		unsigned int					createFrameGroup( std::vector< app::BlockHandle > const& blocks, const double framesPerSecond );
+		void							destroyFrameGroup( const unsigned int id );
+
+		// fusion of linear chains, see FusedLink; returns the number of links that were fused
+		unsigned int					fuseLinearChains();
+		void							unfuseLinearChains();
+
+		// additional thread pools, optionally pinned to a cpu set; a pool can't be destroyed while blocks use it
+		void							createThreadPool( std::string const& name, CpuSet const& cpus, const unsigned int numThreads );
+		void							destroyThreadPool( std::string const& name );
+		// moves a stopped block to another pool, dissolving its fused links; grouped blocks can't be moved
+		void							setThreadPool( FunctionBlock< app::BlockHandle > &block, std::string const& name );
+		void							setMetricsLogging( const bool enabled );
+
 		void							setBaseDirectory( std::string const& directory );
 		//app::BundleHandle &				loadLibrary( std::string const& libraryPath );
 		//app::BundleHandle &				findBundleByName( std::string const& name ) const;
@@ -133,6 +166,15 @@ namespace _2Real
 		EngineImpl();
 		~EngineImpl();
 
+		// groups must be dissolved before any of their blocks or the links between them go away
+		void							destroyFrameGroups();
+		void							destroyFrameGroupsFor( AbstractUberBlock const& block );
+		void							destroyFrameGroupsFor( BasicInletIO const& inlet );
+		// same for fused links
+		void							destroyFusedLinksFor( AbstractUberBlock const& block );
+		void							destroyFusedLinksFor( BasicInletIO const& inlet );
+		FusedLink *						findFusedPredecessor( AbstractUberBlock const& block ) const;
+
 		// whatever you do. do not change the ordering of member variables here!
 		// ( unless you absolutely have to, in which case, good luck )
 
@@ -150,6 +192,11 @@ namespace _2Real
 		CallbackEvent< BlockException const& >						m_BlockExceptionEvent;
 		CallbackEvent< ContextBlockException const& >				m_ContextBlockExceptionEvent;
 
+		FrameGroups													m_FrameGroups;
+		unsigned int												m_NextFrameGroupId;
+		FusedLinks													m_FusedLinks;
+		ThreadPools													m_ThreadPools;
+
 	};
 
 }
\ No newline at end of file
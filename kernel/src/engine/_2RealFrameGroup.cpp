@@ -0,0 +1,263 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#include "engine/_2RealFrameGroup.h"
+#include "engine/_2RealFunctionBlock.h"
+#include "engine/_2RealFunctionBlockStateManager.h"
+#include "engine/_2RealAbstractIOManager.h"
+#include "engine/_2RealOutlet.h"
+#include "engine/_2RealTimer.h"
+#include "engine/_2RealThreadPool.h"
+#include "engine/_2RealLogger.h"
+#include "helpers/_2RealCallback.h"
+#include "helpers/_2RealException.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace _2Real
+{
+
+	FrameGroup::FrameGroup( Blocks const& blocks, EngineImpl::Links const& links, const double framesPerSecond ) :
+		m_Timer( EngineImpl::instance().getTimer() ),
+		m_Logger( EngineImpl::instance().getLogger() ),
+		m_Blocks( blocks ),
+		m_IsFrameRunning( false ),
+		m_FrameFinished( false ),
+		m_PendingStages( 0 ),
+		m_FrameCount( 0 ),
+		m_SkippedFrames( 0 )
+	{
+		if ( framesPerSecond <= 0. )
+		{
+			throw Exception( "frame group: frame rate must be > 0" );
+		}
+
+		const unsigned int numBlocks = m_Blocks.size();
+		std::vector< std::vector< unsigned int > > successors( numBlocks );
+		std::vector< unsigned int > numPredecessors( numBlocks, 0 );
+
+		for ( EngineImpl::LinkConstIterator it = links.begin(); it != links.end(); ++it )
+		{
+			IOLink &link = **it;
+			const unsigned int src = indexOf( link.getOutletIO().m_Outlet->getOwningUberBlock() );
+			const unsigned int dst = indexOf( link.getInletIO() );
+			if ( src == numBlocks || dst == numBlocks )
+			{
+				continue;
+			}
+
+			if ( src == dst )
+			{
+				throw Exception( "frame group: block " + m_Blocks[ src ]->getName() + " is linked to itself" );
+			}
+
+			if ( std::find( successors[ src ].begin(), successors[ src ].end(), dst ) == successors[ src ].end() )
+			{
+				successors[ src ].push_back( dst );
+				++numPredecessors[ dst ];
+			}
+
+			// auto converted links & inlets with options still go through the buffer, so the conversion / check happens
+			BasicInletIO &inlet = link.getInletIO();
+			if ( inlet.info().options.isEmpty() && inlet.info().type.isSameType( link.getOutletIO().m_Outlet->getTypeDescriptor() ) )
+			{
+				m_DirectLinks.push_back( &link );
+			}
+		}
+
+		// kahn's algorithm
+		std::vector< unsigned int > order;
+		std::vector< unsigned int > remaining( numPredecessors );
+		for ( unsigned int i = 0; i<numBlocks; ++i )
+		{
+			if ( remaining[ i ] == 0 ) order.push_back( i );
+		}
+		for ( unsigned int i = 0; i<order.size(); ++i )
+		{
+			std::vector< unsigned int > const& next = successors[ order[ i ] ];
+			for ( unsigned int j = 0; j<next.size(); ++j )
+			{
+				if ( --remaining[ next[ j ] ] == 0 ) order.push_back( next[ j ] );
+			}
+		}
+
+		if ( order.size() != numBlocks )
+		{
+			throw Exception( "frame group: the links between the blocks contain a cycle" );
+		}
+
+		std::vector< unsigned int > position( numBlocks );
+		for ( unsigned int i = 0; i<numBlocks; ++i )
+		{
+			position[ order[ i ] ] = i;
+		}
+
+		for ( unsigned int i = 0; i<numBlocks; ++i )
+		{
+			const unsigned int index = order[ i ];
+			Stage *stage = new Stage( *m_Blocks[ index ]->m_StateManager );
+			stage->numPredecessors = numPredecessors[ index ];
+			for ( unsigned int j = 0; j<successors[ index ].size(); ++j )
+			{
+				stage->successors.push_back( position[ successors[ index ][ j ] ] );
+			}
+			m_Stages.push_back( stage );
+		}
+
+		for ( unsigned int i = 0; i<m_Stages.size(); ++i )
+		{
+			m_Stages[ i ]->block.setFrameGroup( this, i );
+		}
+
+		for ( DirectLinkIterator it = m_DirectLinks.begin(); it != m_DirectLinks.end(); ++it )
+		{
+			( *it )->deactivate();
+			( *it )->getInletIO().setFrameSource( ( *it )->getOutletIO().m_Outlet );
+		}
+
+		m_FrameFinished.set();
+
+		long period = static_cast< long >( 1000000. / framesPerSecond + 0.5 );
+		if ( period < 1 ) period = 1;
+		AbstractCallback< long > *callback = new MemberCallback< FrameGroup, long >( *this, &FrameGroup::tick );
+		m_Timer.registerToTimerSignal( *callback, period );
+
+		std::ostringstream msg;
+		msg << "created frame group: " << numBlocks << " blocks, " << m_DirectLinks.size() << " direct links, " << period << " us per frame";
+		_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_SCHEDULER, msg.str() );
+	}
+
+	FrameGroup::~FrameGroup()
+	{
+		AbstractCallback< long > *callback = new MemberCallback< FrameGroup, long >( *this, &FrameGroup::tick );
+		m_Timer.unregisterFromTimerSignal( *callback );
+
+		// no more ticks from here on, so at most the current frame is still running
+		m_FrameFinished.wait();
+		Poco::ScopedLock< Poco::FastMutex > lock( m_FrameAccess );		// the last stage might not have released it yet
+
+		for ( DirectLinkIterator it = m_DirectLinks.begin(); it != m_DirectLinks.end(); ++it )
+		{
+			( *it )->getInletIO().setFrameSource( nullptr );
+			( *it )->activate();
+		}
+
+		for ( StageIterator it = m_Stages.begin(); it != m_Stages.end(); ++it )
+		{
+			( *it )->block.setFrameGroup( nullptr, 0 );
+			delete *it;
+		}
+
+		_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_SCHEDULER, "destroyed frame group" );
+	}
+
+	unsigned int FrameGroup::indexOf( AbstractUberBlock const& block ) const
+	{
+		for ( unsigned int i = 0; i<m_Blocks.size(); ++i )
+		{
+			if ( m_Blocks[ i ] == &block ) return i;
+		}
+		return m_Blocks.size();
+	}
+
+	unsigned int FrameGroup::indexOf( BasicInletIO const& inlet ) const
+	{
+		for ( unsigned int i = 0; i<m_Blocks.size(); ++i )
+		{
+			if ( inlet.belongsToBlock( m_Blocks[ i ] ) ) return i;
+		}
+		return m_Blocks.size();
+	}
+
+	bool FrameGroup::containsBlock( AbstractUberBlock const& block ) const
+	{
+		return ( indexOf( block ) != m_Blocks.size() );
+	}
+
+	bool FrameGroup::containsInlet( BasicInletIO const& inlet ) const
+	{
+		return ( indexOf( inlet ) != m_Blocks.size() );
+	}
+
+	unsigned long FrameGroup::getFrameCount() const
+	{
+		return static_cast< unsigned long >( m_FrameCount.load() );
+	}
+
+	unsigned long FrameGroup::getSkippedFrames() const
+	{
+		return static_cast< unsigned long >( m_SkippedFrames.load() );
+	}
+
+	void FrameGroup::tick( long &missed )
+	{
+		// called by the timer thread
+		if ( missed > 0 ) m_SkippedFrames.add( missed );
+
+		{
+			Poco::ScopedLock< Poco::FastMutex > lock( m_FrameAccess );
+			if ( m_IsFrameRunning )
+			{
+				m_SkippedFrames.increment();
+				return;
+			}
+
+			m_IsFrameRunning = true;
+			m_FrameFinished.reset();
+		}
+
+		for ( StageIterator it = m_Stages.begin(); it != m_Stages.end(); ++it )
+		{
+			( *it )->pendingPredecessors.store( ( *it )->numPredecessors );
+		}
+		m_PendingStages.store( m_Stages.size() );
+
+		for ( StageIterator it = m_Stages.begin(); it != m_Stages.end(); ++it )
+		{
+			if ( ( *it )->numPredecessors == 0 ) scheduleStage( **it );
+		}
+	}
+
+	void FrameGroup::finishStage( const unsigned int index )
+	{
+		// called by the worker that just updated the stage's block
+		Stage &stage = *m_Stages[ index ];
+		for ( unsigned int i = 0; i<stage.successors.size(); ++i )
+		{
+			Stage &next = *m_Stages[ stage.successors[ i ] ];
+			if ( next.pendingPredecessors.decrement() == 0 ) scheduleStage( next );
+		}
+
+		if ( m_PendingStages.decrement() == 0 )
+		{
+			m_FrameCount.increment();
+
+			Poco::ScopedLock< Poco::FastMutex > lock( m_FrameAccess );
+			m_IsFrameRunning = false;
+			m_FrameFinished.set();
+		}
+	}
+
+	void FrameGroup::scheduleStage( Stage &stage )
+	{
+		// each block runs in its own pool; from a worker of that pool, this goes to the worker's own queue
+		ThreadExecRequest *req = new ThreadExecRequest( stage.block, &FunctionBlockStateManager::updateFunctionBlockInFrame );
+		stage.block.getThreadPool().scheduleRequest( *req );
+	}
+
+}
@@ -0,0 +1,106 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#pragma once
+
+#include "engine/_2RealEngineImpl.h"
+#include "helpers/_2RealNonCopyable.h"
+#include "helpers/_2RealAtomic.h"
+#include "helpers/_2RealPoco.h"
+
+#include <vector>
+
+namespace _2Real
+{
+
+	class Timer;
+	class Logger;
+	class AbstractUberBlock;
+	class BasicInletIO;
+	class FunctionBlockStateManager;
+
+	// frame mode: a set of blocks that is updated by a single clock instead of by triggers.
+	// the order of updates follows the links between the blocks; on every tick, blocks without
+	// in-group predecessors are scheduled at once ( independent branches run in parallel ), a block
+	// is scheduled as soon as all its in-group predecessors have finished ( by the worker that finished
+	// the last of them, so dependent stages run back to back ).
+	// links inside the group bypass the inlet buffers: an inlet reads the outlet of its predecessor
+	// directly, links from & to other blocks are not affected.
+	// the blocks must be set up, but not started; a tick that arrives while the previous frame is
+	// still running is skipped.
+	class FrameGroup : private NonCopyable< FrameGroup >
+	{
+
+	public:
+
+		typedef std::vector< FunctionBlock< app::BlockHandle > * >					Blocks;
+		typedef std::vector< FunctionBlock< app::BlockHandle > * >::iterator			BlockIterator;
+		typedef std::vector< FunctionBlock< app::BlockHandle > * >::const_iterator	BlockConstIterator;
+
+		// throws if the links between the blocks contain a cycle
+		FrameGroup( Blocks const& blocks, EngineImpl::Links const& links, const double framesPerSecond );
+		// blocks until the current frame ( if any ) has finished
+		~FrameGroup();
+
+		bool				containsBlock( AbstractUberBlock const& block ) const;
+		bool				containsInlet( BasicInletIO const& inlet ) const;
+		unsigned long		getFrameCount() const;
+		unsigned long		getSkippedFrames() const;
+
+		void				tick( long &missed );
+		void				finishStage( const unsigned int index );
+
+	private:
+
+		struct Stage
+		{
+			Stage( FunctionBlockStateManager &mgr ) : block( mgr ), numPredecessors( 0 ), pendingPredecessors( 0 ) {}
+
+			FunctionBlockStateManager			&block;
+			std::vector< unsigned int >			successors;
+			unsigned int						numPredecessors;
+			AtomicLong							pendingPredecessors;
+		};
+
+		typedef std::vector< Stage * >						Stages;
+		typedef std::vector< Stage * >::iterator			StageIterator;
+		typedef std::vector< Stage * >::const_iterator		StageConstIterator;
+
+		typedef std::vector< IOLink * >						DirectLinks;
+		typedef std::vector< IOLink * >::iterator			DirectLinkIterator;
+
+		unsigned int		indexOf( AbstractUberBlock const& block ) const;		// m_Blocks.size() if not found
+		unsigned int		indexOf( BasicInletIO const& inlet ) const;
+		void				scheduleStage( Stage &stage );
+
+		Timer								&m_Timer;
+		Logger								&m_Logger;
+
+		Blocks								m_Blocks;
+		Stages								m_Stages;			// topologically sorted
+		DirectLinks							m_DirectLinks;		// deactivated while the group exists; the engine dissolves the group before destroying any of them
+
+		Poco::FastMutex						m_FrameAccess;
+		bool								m_IsFrameRunning;
+		Poco::Event							m_FrameFinished;		// manual reset, set while no frame is running
+		AtomicLong							m_PendingStages;
+		AtomicLong							m_FrameCount;
+		AtomicLong							m_SkippedFrames;
+
+	};
+
+}
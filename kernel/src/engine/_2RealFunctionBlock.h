@@ -24,6 +24,7 @@
 #include "engine/_2RealFunctionBlockStateManager.h"
 #include "engine/_2RealFunctionBlockUpdatePolicy.h"
 #include "engine/_2RealBundle.h"
+#include "engine/_2RealThreadPool.h"
 #include "app/_2RealBlockHandle.h"
 #include "app/_2RealContextBlockHandle.h"
 #include "app/_2RealBlockInfo.h"
@@ -34,6 +35,8 @@ namespace _2Real
 {
 
 	class AnyOptionSet;
+	class FrameGroup;
+	class FusedLink;
 
 	template< typename THandle >
 	class FunctionBlock : public AbstractUberBlock, private Handleable< FunctionBlock< THandle >, THandle >
@@ -54,6 +57,15 @@ namespace _2Real
 
 		std::string const&			getBundleName() const;
 		const std::string			getUpdateRateAsString() const;
+		unsigned long				getSkippedDeadlines() const;
+		void						getMetrics( app::BlockMetrics &metrics ) const;
+		void						resetMetrics();
+		void						setPriority( const BlockPriority::Priority priority );
+		BlockPriority::Priority		getPriority() const;
+		void						setDeadline( const long microseconds );
+		void						setThreadPool( std::string const& name );
+		void						setThreadPool( ThreadPool &threads );
+		ThreadPool &				getThreadPool() const;
 		bool						isRunning() const;
 
 		app::BlockInfo const&		getBlockInfo();
@@ -92,6 +104,9 @@ namespace _2Real
 
 	private:
 
+		friend class FrameGroup;
+		friend class FusedLink;
+
 		EngineImpl					&m_Engine;
 		Bundle						const& m_Bundle;
 		bundle::Block				*m_Block;
@@ -127,11 +142,14 @@ namespace _2Real
 
 		m_IOManager->m_StateManager = m_StateManager;
 		m_IOManager->m_UpdatePolicy = m_UpdatePolicy;
+
+		m_Engine.getThreadPool().registerBlock( *m_StateManager );
 	}
 
 	template< typename THandle >
 	FunctionBlock< THandle >::~FunctionBlock()
 	{
+		m_StateManager->getThreadPool().unregisterBlock( *m_StateManager );
 		delete m_UpdatePolicy;
 		delete m_IOManager;
 		delete m_StateManager;
@@ -144,6 +162,54 @@ namespace _2Real
 		return m_Bundle.getName();
 	}
 
+	template< typename THandle >
+	void FunctionBlock< THandle >::getMetrics( app::BlockMetrics &metrics ) const
+	{
+		m_StateManager->getMetrics( metrics );
+	}
+
+	template< typename THandle >
+	void FunctionBlock< THandle >::resetMetrics()
+	{
+		m_StateManager->getProfile().reset();
+	}
+
+	template< typename THandle >
+	void FunctionBlock< THandle >::setPriority( const BlockPriority::Priority priority )
+	{
+		m_StateManager->setPriority( priority );
+	}
+
+	template< typename THandle >
+	BlockPriority::Priority FunctionBlock< THandle >::getPriority() const
+	{
+		return m_StateManager->getPriority();
+	}
+
+	template< typename THandle >
+	void FunctionBlock< THandle >::setDeadline( const long microseconds )
+	{
+		m_StateManager->setDeadline( microseconds );
+	}
+
+	template< typename THandle >
+	void FunctionBlock< THandle >::setThreadPool( std::string const& name )
+	{
+		m_Engine.setThreadPool( *this, name );
+	}
+
+	template< typename THandle >
+	void FunctionBlock< THandle >::setThreadPool( ThreadPool &threads )
+	{
+		m_StateManager->setThreadPool( threads );
+	}
+
+	template< typename THandle >
+	ThreadPool & FunctionBlock< THandle >::getThreadPool() const
+	{
+		return m_StateManager->getThreadPool();
+	}
+
 	template< typename THandle >
 	bool FunctionBlock< THandle >::isRunning() const
 	{
@@ -158,6 +224,12 @@ namespace _2Real
 		return str.str();
 	}
 
+	template< typename THandle >
+	unsigned long FunctionBlock< THandle >::getSkippedDeadlines() const
+	{
+		return m_UpdatePolicy->getSkippedDeadlines();
+	}
+
 	template< typename THandle >
 	void FunctionBlock< THandle >::addInlet( std::string const& name, TypeDescriptor const& type, Any const& initialValue, AnyOptionSet const& options, InletPolicy const& p, const bool isMulti )
 	{
@@ -23,12 +23,13 @@
 #include "engine/_2RealInlet.h"
 #include "engine/_2RealOutlet.h"
 #include "engine/_2RealInletBuffer.h"
+#include "engine/_2RealFunctionBlockStateManager.h"
+#include "engine/_2RealThreadPool.h"
 #include "app/_2RealAppData.h"
 #include "app/_2RealInletHandle.h"
 #include "app/_2RealOutletHandle.h"
 #include "bundle/_2RealInletHandle.h"
 #include "bundle/_2RealOutletHandle.h"
-#include "helpers/_2RealStringHelpers.h"
 
 #include <sstream>
 
@@ -78,6 +79,11 @@ namespace _2Real
 		return m_BundleOutletHandles;
 	}
 
+	AbstractParallelExecutor & FunctionBlockIOManager::getParallelExecutor() const
+	{
+		return m_StateManager->getThreadPool();
+	}
+
 	void FunctionBlockIOManager::registerToNewData( AbstractCallback< list< app::AppData > const& > &cb )
 	{
 		m_AppEvent.addListener( cb );
@@ -108,64 +114,70 @@ namespace _2Real
 		return getOutletIO( name ).m_Outlet->getHandle();
 	}
 
-	AbstractInletIO & FunctionBlockIOManager::getInletIO( string const& name )
+	unsigned int FunctionBlockIOManager::getInletIndex( string const& name ) const
 	{
-		for ( InletIterator it = m_Inlets.begin(); it != m_Inlets.end(); ++it )
+		const unsigned int index = m_InletIndex.find( name );
+		if ( index == NameIndex::NotFound )
 		{
-			if ( toLower( ( *it )->info().baseName ) == toLower( name ) )
-			{
-				return **it;
-			}
+			ostringstream msg;
+			msg << "inlet " << name << " not found in " << m_Owner.getFullName();
+			throw NotFoundException( msg.str() );
 		}
-
-		ostringstream msg;
-		msg << "inlet " << name<< " not found in" << m_Owner.getFullName();
-		throw NotFoundException( msg.str() );
+		return index;
 	}
 
-	OutletIO & FunctionBlockIOManager::getOutletIO( string const& name )
+	unsigned int FunctionBlockIOManager::getOutletIndex( string const& name ) const
 	{
-		for ( OutletIterator it = m_Outlets.begin(); it != m_Outlets.end(); ++it )
+		const unsigned int index = m_OutletIndex.find( name );
+		if ( index == NameIndex::NotFound )
 		{
-			if ( toLower( ( *it )->m_Outlet->getName() ) == toLower( name ) )
-			{
-				return **it;
-			}
+			ostringstream msg;
+			msg << "outlet " << name << " not found in " << m_Owner.getFullName();
+			throw NotFoundException( msg.str() );
 		}
-
-		ostringstream msg;
-		msg << "outlet " << name<< " not found in" << m_Owner.getFullName();
-		throw NotFoundException( msg.str() );
+		return index;
 	}
 
-	AbstractInletIO const& FunctionBlockIOManager::getInletIO( string const& name ) const
+	bundle::InletHandle & FunctionBlockIOManager::getBundleInletHandle( const unsigned int index ) const
 	{
-		for ( InletConstIterator it = m_Inlets.begin(); it != m_Inlets.end(); ++it )
+		if ( index >= m_Inlets.size() )
 		{
-			if ( toLower( ( *it )->info().baseName ) == toLower( name ) )
-			{
-				return **it;
-			}
+			ostringstream msg;
+			msg << "inlet index " << index << " out of range in " << m_Owner.getFullName();
+			throw NotFoundException( msg.str() );
 		}
-
-		ostringstream msg;
-		msg << "inlet " << name<< " not found in" << m_Owner.getFullName();
-		throw NotFoundException( msg.str() );
+		return m_Inlets[ index ]->getBundleInletHandle();
 	}
 
-	OutletIO const& FunctionBlockIOManager::getOutletIO( string const& name ) const
+	bundle::OutletHandle & FunctionBlockIOManager::getBundleOutletHandle( const unsigned int index ) const
 	{
-		for ( OutletConstIterator it = m_Outlets.begin(); it != m_Outlets.end(); ++it )
+		if ( index >= m_Outlets.size() )
 		{
-			if ( toLower( ( *it )->m_Outlet->getName() ) == toLower( name ) )
-			{
-				return **it;
-			}
+			ostringstream msg;
+			msg << "outlet index " << index << " out of range in " << m_Owner.getFullName();
+			throw NotFoundException( msg.str() );
 		}
+		return m_Outlets[ index ]->m_Outlet->getHandle();
+	}
 
-		ostringstream msg;
-		msg << "outlet " << name<< " not found in" << m_Owner.getFullName();
-		throw NotFoundException( msg.str() );
+	AbstractInletIO & FunctionBlockIOManager::getInletIO( string const& name )
+	{
+		return *m_Inlets[ getInletIndex( name ) ];
+	}
+
+	OutletIO & FunctionBlockIOManager::getOutletIO( string const& name )
+	{
+		return *m_Outlets[ getOutletIndex( name ) ];
+	}
+
+	AbstractInletIO const& FunctionBlockIOManager::getInletIO( string const& name ) const
+	{
+		return *m_Inlets[ getInletIndex( name ) ];
+	}
+
+	OutletIO const& FunctionBlockIOManager::getOutletIO( string const& name ) const
+	{
+		return *m_Outlets[ getOutletIndex( name ) ];
 	}
 
 	void FunctionBlockIOManager::addBasicInlet( AbstractInletIO::InletInfo const& info )
@@ -173,6 +185,7 @@ namespace _2Real
 		BasicInletIO *io = new BasicInletIO( m_Owner, *m_UpdatePolicy, info );
 		io->syncInletData();
 		m_UpdatePolicy->addInlet( *io, info.policy );
+		m_InletIndex.insert( info.baseName, static_cast< unsigned int >( m_Inlets.size() ) );
 		m_Inlets.push_back( io );
 		m_AppInletHandles.push_back( io->getHandle() );
 		m_BundleInletHandles.push_back( io->getBundleInletHandle() );
@@ -181,6 +194,7 @@ namespace _2Real
 	void FunctionBlockIOManager::addMultiInlet( AbstractInletIO::InletInfo const& info )
 	{
 		MultiInletIO *io = new MultiInletIO( m_Owner, *m_UpdatePolicy, info );
+		m_InletIndex.insert( info.baseName, static_cast< unsigned int >( m_Inlets.size() ) );
 		m_Inlets.push_back( io );
 		m_AppInletHandles.push_back( io->getHandle() );
 		m_BundleInletHandles.push_back( io->getBundleInletHandle() );
@@ -190,6 +204,7 @@ namespace _2Real
 	{
 		OutletIO *io = new OutletIO( m_Owner, name, type, initialValue );
 		io->m_Outlet->synchronize();
+		m_OutletIndex.insert( name, static_cast< unsigned int >( m_Outlets.size() ) );
 		m_Outlets.push_back( io );
 		m_AppOutletHandles.push_back( io->getHandle() );
 		m_BundleOutletHandles.push_back( io->m_Outlet->getHandle() );
@@ -220,7 +235,14 @@ namespace _2Real
 			if ( !wasDiscarded )
 			{
 				TimestampedData lastData = outlet.getData();
-				( *it )->m_InletEvent->notify( lastData );
+				if ( ( *it )->m_IsParallelFanOut.load() )
+				{
+					( *it )->m_InletEvent->notify( lastData, m_StateManager->getThreadPool() );
+				}
+				else
+				{
+					( *it )->m_InletEvent->notify( lastData );
+				}
 				app::AppData out = app::AppData( lastData, outlet.getTypename(), outlet.getLongTypename(), outlet.getName() );
 				( *it )->m_AppEvent->notify( out );
 				data.push_back( out );
@@ -22,6 +22,7 @@
 #include "helpers/_2RealHandleable.h"
 #include "app/_2RealCallbacks.h"
 #include "bundle/_2RealBlockHandle.h"
+#include "helpers/_2RealNameIndex.h"
 
 namespace _2Real
 {
@@ -41,12 +42,15 @@ namespace _2Real
 	class FunctionBlockStateManager;
 	class FunctionBlockUpdatePolicy;
 	class TypeDescriptor;
+	class FusedLink;
+	class AbstractParallelExecutor;
 
 	class FunctionBlockIOManager : private AbstractIOManager, private Handleable< FunctionBlockIOManager, bundle::BlockHandle >
 	{
 
 		template< typename T >
 		friend class FunctionBlock;
+		friend class FusedLink;
 
 	public:
 
@@ -71,6 +75,13 @@ namespace _2Real
 		bundle::InletHandle &			getBundleInletHandle( std::string const& name ) const;
 		bundle::OutletHandle &			getBundleOutletHandle( std::string const& name ) const;
 
+		// inlets & outlets are numbered in the order they were added; names are resolved through a
+		// case insensitive index built when the block is created, indices are a plain array access
+		unsigned int					getInletIndex( std::string const& name ) const;
+		unsigned int					getOutletIndex( std::string const& name ) const;
+		bundle::InletHandle &			getBundleInletHandle( const unsigned int index ) const;
+		bundle::OutletHandle &			getBundleOutletHandle( const unsigned int index ) const;
+
 		AppInletHandles const&			getAppInletHandles() const;
 		AppOutletHandles const&			getAppOutletHandles() const;
 		BundleInletHandles const&		getBundleInletHandles() const;
@@ -81,6 +92,9 @@ namespace _2Real
 		void							updateInletBuffers( const bool enableTriggering );
 		void							clearInletBuffers();
 
+		// the thread pool the block is updated by
+		AbstractParallelExecutor &		getParallelExecutor() const;
+
 		/* moved to public 13/05/2013 - using this function might cause sync issues?? */
 
 		AbstractInletIO &				getInletIO( std::string const& name );
@@ -97,6 +111,8 @@ namespace _2Real
 		mutable Poco::FastMutex			m_OutletAccess;
 		InletVector						m_Inlets;
 		OutletVector					m_Outlets;
+		NameIndex						m_InletIndex;
+		NameIndex						m_OutletIndex;
 
 		//AbstractInletIO &				getInletIO( std::string const& name );
 		//OutletIO &						getOutletIO( std::string const& name );
@@ -22,6 +22,9 @@
 #include "engine/_2RealEngineImpl.h"
 #include "engine/_2RealThreadPool.h"
 #include "engine/_2RealLogger.h"
+#include "engine/_2RealFrameGroup.h"
+#include "engine/_2RealOutlet.h"
+#include "engine/_2RealTracer.h"
 #include "../_2RealBlock.h"
 
 #include <iostream>
@@ -34,19 +37,27 @@ namespace _2Real
 	FunctionBlockStateManager::FunctionBlockStateManager( AbstractUberBlock &owner ) :
 		AbstractStateManager( owner ),
 		m_CurrentState( new FunctionBlockStateCreated() ),
-		m_IsTriggeringEnabled( false ),
+		m_IsTriggeringEnabled( 0 ),
+		m_FrameGroup( nullptr ),
+		m_FrameStage( 0 ),
+		m_Priority( BlockPriority::PRIO_NORMAL ),
+		m_Deadline( 0 ),
 		m_IsFlaggedForHalting( false ),
 		m_IsFlaggedForShutdown( false ),
 		m_IOManager( nullptr ),
 		m_UpdatePolicy( nullptr ),
-		m_Threads( EngineImpl::instance().getThreadPool() ),
+		m_Threads( &EngineImpl::instance().getThreadPool() ),
 		m_Logger( EngineImpl::instance().getLogger() ),
 		m_TimeTrigger( nullptr ),
-		m_Thread( nullptr ),
+		m_GroupTriggerCount( 0 ),
+		m_SingleTriggerCount( 0 ),
+		m_HasTimeTrigger( 0 ),
+		m_FulfilledGroupTriggers( 0 ),
+		m_FulfilledSingleTriggers( 0 ),
+		m_FulfilledTimeTriggers( 0 ),
 		m_HasException( false ),
 		m_Exception( "" )
 	{
-		m_Thread = m_Threads.requestUniqueThread();
 	}
 
 	FunctionBlockStateManager::~FunctionBlockStateManager()
@@ -62,7 +73,7 @@ namespace _2Real
 		std::cout << getName() << " EXCEPTION: " << e.message() << std::endl;
 		std::cout << "-------------------------------------------------------------------" << std::endl;
 
-		m_Logger.addLine( std::string( getName() + " state: error\n\t" + e.message() ) );
+		_2REAL_LOG( m_Logger, LogLevel::LOG_ERROR, LogCategory::LOG_BLOCKS, getName() + " state: error\n\t" + e.message() );
 
 		m_HasException = true;
 		m_Exception = e;
@@ -90,7 +101,7 @@ namespace _2Real
 		ThreadExecRequest *req = new ThreadExecRequest( *this, &FunctionBlockStateManager::setupFunctionBlock );
 		Poco::Event *ev = new Poco::Event();
 		req->event = ev;
-		m_Threads.scheduleRequest( *req, m_Thread );
+		m_Threads->scheduleRequest( *req );
 		ev->wait();
 		delete ev;
 		// blocking request /////////////////////////////////////
@@ -112,7 +123,7 @@ namespace _2Real
 			// state change /////////////////////////////////////////
 			delete m_CurrentState;
 			m_CurrentState = new FunctionBlockStateInitialized();
-			m_Logger.addLine( string( getName() + " state: initialized" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " state: initialized" );
 			m_StateAccess.unlock();
 			// state change /////////////////////////////////////////
 		}
@@ -121,6 +132,7 @@ namespace _2Real
 	void FunctionBlockStateManager::setupFunctionBlock()
 	{
 		// called by pooled thread
+		_2REAL_TRACE_SCOPE( "setup", "blocks", *this );
 
 		try
 		{
@@ -129,7 +141,7 @@ namespace _2Real
 
 			bundle::BlockHandle &h = m_IOManager->getHandle();
 			m_FunctionBlock->setup( h );
-			m_Logger.addLine( std::string( getName() + " carried out setup" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " carried out setup" );
 		}
 		catch ( Exception &e )
 		{
@@ -141,13 +153,19 @@ namespace _2Real
 	{
 		m_StateAccess.lock();
 
+		if ( m_FrameGroup != nullptr )
+		{
+			m_StateAccess.unlock();
+			throw Exception( getName() + " belongs to a frame group & can't be started" );
+		}
+
 		// initialized: ok
 		// else: throw exception
 		m_CurrentState->start( *this );
 
 		// state change /////////////////////////////////////////
 		delete m_CurrentState;
-		m_Logger.addLine( string( getName() + " new state: updating" ) );
+		_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " new state: updating" );
 		m_CurrentState = new FunctionBlockStateUpdating();
 		// state change /////////////////////////////////////////
 
@@ -156,31 +174,43 @@ namespace _2Real
 		m_StopEvent.reset();
 		m_UpdatePolicy->syncChanges();
 
-		// enable triggers /////////////////////////////////////////
-		m_EnabledAccess.lock();
-		m_IsTriggeringEnabled = true;
-		m_EnabledAccess.unlock();
-		// enable triggers /////////////////////////////////////////
-
-		setTriggers( false );
+		m_Profile.clearTrigger();
+		enableTriggering();
 		m_IOManager->updateInletBuffers( true );
 	}
 
 	void FunctionBlockStateManager::updateFunctionBlock()
 	{
+		bool wasUpdated = false;
 		try
 		{
+			_2REAL_TRACE_SCOPE( "update", "blocks", *this );
+
+			Timer::Time t0 = Timer::now();
+			m_Profile.recordUpdateStart( t0 );
 			m_IOManager->updateInletData();
+
+			Timer::Time t1 = Timer::now();
 			m_FunctionBlock->update();
-			m_IOManager->updateOutletData();
+			Timer::Time t2 = Timer::now();
+			{
+				_2REAL_TRACE_SCOPE( "outlet notify", "outlets", *this );
+				m_IOManager->updateOutletData();
+			}
+			m_Profile.recordUpdate( static_cast< long >( t2 - t1 ) );
+			m_Profile.recordPublish( static_cast< long >( Timer::now() - t2 ) );
+			wasUpdated = true;
 
-			m_Logger.addLine( std::string( getName() + " carried out update" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_DEBUG, LogCategory::LOG_BLOCKS, getName() + " carried out update" );
 		}
 		catch ( Exception &e )
 		{
 			handleStateChangeException( e );
 		}
 
+		// a fused chain runs as a whole before the head can be triggered again
+		if ( wasUpdated ) updateFusedSuccessors();
+
 		Poco::ScopedLock< Poco::FastMutex > lock( m_ExceptionAccess );
 
 		if ( m_IsFlaggedForShutdown.isSet() )
@@ -189,7 +219,7 @@ namespace _2Real
 
 			delete m_CurrentState;
 			m_CurrentState = new FunctionBlockStateStopped();
-			m_Logger.addLine( std::string( getName() + " new state: stopped ( finished update cycle )" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " new state: stopped ( finished update cycle )" );
 
 			m_StopEvent.set();
 			m_ShutdownEvent.set();
@@ -214,7 +244,7 @@ namespace _2Real
 
 			delete m_CurrentState;
 			m_CurrentState = new FunctionBlockStateInitialized();
-			m_Logger.addLine( std::string( getName() + " new state: initialized ( finished update cycle )" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " new state: initialized ( finished update cycle )" );
 
 			m_StopEvent.set();
 			m_IsFlaggedForHalting.unset();
@@ -225,12 +255,7 @@ namespace _2Real
 		{
 			m_UpdatePolicy->syncChanges();
 
-			m_EnabledAccess.lock();
-			m_IsTriggeringEnabled = true;
-			m_EnabledAccess.unlock();
-
-			setTriggers( false );
-
+			enableTriggering();
 			m_IOManager->updateInletBuffers( true );
 		}
 	}
@@ -244,7 +269,7 @@ namespace _2Real
 		m_CurrentState->start( *this );
 
 		// without enabling triggers update inlet data //////////
-		setTriggers( false );
+		resetTriggers();
 		m_IOManager->updateInletBuffers( false );
 		/////////////////////////////////////////////////////////
 
@@ -252,7 +277,7 @@ namespace _2Real
 		ThreadExecRequest *req = new ThreadExecRequest( *this, &FunctionBlockStateManager::singleStepFunctionBlock );
 		Poco::Event *ev = new Poco::Event();
 		req->event = ev;
-		m_Threads.scheduleRequest( *req, m_Thread );
+		m_Threads->scheduleRequest( *req );
 		ev->wait();
 		delete ev;
 		// blocking request /////////////////////////////////////
@@ -275,17 +300,179 @@ namespace _2Real
 
 	void FunctionBlockStateManager::singleStepFunctionBlock()
 	{
+		_2REAL_TRACE_SCOPE( "singlestep", "blocks", *this );
+
 		try
 		{
 			m_IOManager->updateInletData();
 			m_FunctionBlock->update();
 			m_IOManager->updateOutletData();
 
-			m_Logger.addLine( std::string( getName() + " carried out singlestep" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_DEBUG, LogCategory::LOG_BLOCKS, getName() + " carried out singlestep" );
 		}
 		catch ( Exception &e )
 		{
 			handleStateChangeException( e );
+			return;
+		}
+
+		// the links to fused successors are deactivated, so they are driven from here as after an update
+		updateFusedSuccessors();
+	}
+
+	void FunctionBlockStateManager::setFrameGroup( FrameGroup *group, const unsigned int stage )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_StateAccess );
+		m_FrameGroup = group;
+		m_FrameStage = stage;
+	}
+
+	void FunctionBlockStateManager::updateFunctionBlockInFrame()
+	{
+		// called by pooled thread, scheduled by the frame group
+
+		m_StateAccess.lock();
+
+		FrameGroup *group = m_FrameGroup;
+		const unsigned int stage = m_FrameStage;
+
+		// blocks that were stopped or are in error state are skipped, but the frame goes on
+		if ( *m_CurrentState == AbstractFunctionBlockState::INITIALIZED )
+		{
+			try
+			{
+				// same as a single step, but without blocking: inlets linked inside the group read their source directly
+				_2REAL_TRACE_SCOPE( "frame update", "blocks", *this );
+
+				resetTriggers();
+				m_IOManager->updateInletBuffers( false );
+				m_IOManager->updateInletData();
+
+				Timer::Time t1 = Timer::now();
+				m_FunctionBlock->update();
+				Timer::Time t2 = Timer::now();
+				{
+					_2REAL_TRACE_SCOPE( "outlet notify", "outlets", *this );
+					m_IOManager->updateOutletData();
+				}
+				m_Profile.recordUpdate( static_cast< long >( t2 - t1 ) );
+				m_Profile.recordPublish( static_cast< long >( Timer::now() - t2 ) );
+
+				_2REAL_LOG( m_Logger, LogLevel::LOG_DEBUG, LogCategory::LOG_BLOCKS, getName() + " carried out frame update" );
+			}
+			catch ( Exception &e )
+			{
+				handleStateChangeException( e );
+			}
+
+			if ( m_HasException )
+			{
+				delete m_CurrentState;
+				m_CurrentState = new FunctionBlockStateError();
+				m_StateAccess.unlock();
+
+				m_Owner.handleException( m_Exception );
+			}
+			else m_StateAccess.unlock();
+		}
+		else m_StateAccess.unlock();
+
+		if ( group != nullptr ) group->finishStage( stage );
+	}
+
+	BlockProfile & FunctionBlockStateManager::getProfile()
+	{
+		return m_Profile;
+	}
+
+	void FunctionBlockStateManager::getMetrics( app::BlockMetrics &metrics )
+	{
+		m_Profile.getMetrics( metrics );
+		metrics.skippedDeadlines = m_UpdatePolicy->getSkippedDeadlines();
+	}
+
+	void FunctionBlockStateManager::setThreadPool( ThreadPool &threads )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_StateAccess );
+
+		if ( *m_CurrentState == AbstractFunctionBlockState::UPDATING )
+		{
+			throw Exception( "can't move " + getName() + " to thread pool " + threads.getName() + " while it is running" );
+		}
+
+		if ( m_Threads == &threads ) return;
+
+		m_Threads->unregisterBlock( *this );
+		m_Threads = &threads;
+		m_Threads->registerBlock( *this );
+	}
+
+	ThreadPool & FunctionBlockStateManager::getThreadPool()
+	{
+		return *m_Threads;
+	}
+
+	void FunctionBlockStateManager::setPriority( const BlockPriority::Priority priority )
+	{
+		m_Priority.store( priority );
+	}
+
+	BlockPriority::Priority FunctionBlockStateManager::getPriority() const
+	{
+		return static_cast< BlockPriority::Priority >( m_Priority.load() );
+	}
+
+	void FunctionBlockStateManager::setDeadline( const long microseconds )
+	{
+		m_Deadline.store( microseconds > 0 ? microseconds : 0 );
+	}
+
+	long FunctionBlockStateManager::getDeadline() const
+	{
+		long deadline = m_Deadline.load();
+		return ( deadline > 0 ? deadline : BlockPriority::getDefaultDeadline( getPriority() ) );
+	}
+
+	void FunctionBlockStateManager::addFusedSuccessor( Outlet &outlet, FunctionBlockStateManager &successor )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_FusionAccess );
+		m_FusedSuccessors.push_back( FusedSuccessor( outlet, successor ) );
+	}
+
+	void FunctionBlockStateManager::removeFusedSuccessor( FunctionBlockStateManager &successor )
+	{
+		// waits for the successors that are being updated right now
+		Poco::ScopedLock< Poco::FastMutex > lock( m_FusionAccess );
+		for ( FusedSuccessorIterator it = m_FusedSuccessors.begin(); it != m_FusedSuccessors.end(); ++it )
+		{
+			if ( it->block == &successor )
+			{
+				m_FusedSuccessors.erase( it );
+				break;
+			}
+		}
+	}
+
+	void FunctionBlockStateManager::updateFusedSuccessors()
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_FusionAccess );
+		for ( FusedSuccessorIterator it = m_FusedSuccessors.begin(); it != m_FusedSuccessors.end(); ++it )
+		{
+			// nothing was published on the outlet ( discarded update )
+			const long key = it->outlet->getUpdateKey();
+			if ( key == it->lastKey ) continue;
+			it->lastKey = key;
+
+			// same protocol as a trigger: a successor that is not started or still busy is skipped
+			if ( it->block->m_IsTriggeringEnabled.compareAndSwap( 1, 0 ) )
+			{
+				_2REAL_LOG( m_Logger, LogLevel::LOG_DEBUG, LogCategory::LOG_SCHEDULER, it->block->getName() + " updated by fused predecessor " + getName() );
+
+				// parameter inlets: takes over what the application set since the last update, as a single step does
+				it->block->resetTriggers();
+				it->block->m_IOManager->updateInletBuffers( false );
+				it->block->updateFunctionBlock();
+			}
 		}
 	}
 
@@ -297,7 +484,7 @@ namespace _2Real
 			// state change /////////////////////////////////////////
 			delete m_CurrentState;
 			m_CurrentState = new FunctionBlockStateStopped();
-			m_Logger.addLine( std::string( getName() + " state: stopped ( framework stop )" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " state: stopped ( framework stop )" );
 			// state change /////////////////////////////////////////
 
 			m_StopEvent.set();
@@ -306,7 +493,7 @@ namespace _2Real
 		else
 		{
 			m_IsFlaggedForShutdown.set();
-			m_Logger.addLine( std::string( getName() + " flagged for shutdown" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " flagged for shutdown" );
 		}
 
 		m_StateAccess.unlock();
@@ -321,7 +508,7 @@ namespace _2Real
 			// state change /////////////////////////////////////////
 			delete m_CurrentState;
 			m_CurrentState = new FunctionBlockStateInitialized();
-			m_Logger.addLine( std::string( getName() + " state: initialized ( user stop )" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " state: initialized ( user stop )" );
 			// state change /////////////////////////////////////////
 
 			m_StopEvent.set();
@@ -329,7 +516,7 @@ namespace _2Real
 		else
 		{
 			m_IsFlaggedForHalting.set();
-			m_Logger.addLine( std::string( getName() + " flagged for halting" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " flagged for halting" );
 		}
 
 		m_StateAccess.unlock();
@@ -346,7 +533,7 @@ namespace _2Real
 			ThreadExecRequest *req = new ThreadExecRequest( *this, &FunctionBlockStateManager::shutdownFunctionBlock );
 			Poco::Event *ev = new Poco::Event();
 			req->event = ev;
-			m_Threads.scheduleRequest( *req, m_Thread );
+			m_Threads->scheduleRequest( *req );
 			ev->wait();
 			delete ev;
 			// blocking request /////////////////////////////////////
@@ -366,7 +553,7 @@ namespace _2Real
 				// state change /////////////////////////////////////////
 				delete m_CurrentState;
 				m_CurrentState = new FunctionBlockStateShutDown();
-				m_Logger.addLine( std::string( getName() + " state: shut down" ) );
+				_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " state: shut down" );
 				// state change /////////////////////////////////////////
 
 				m_StateAccess.unlock();
@@ -386,10 +573,12 @@ namespace _2Real
 
 	void FunctionBlockStateManager::shutdownFunctionBlock()
 	{
+		_2REAL_TRACE_SCOPE( "shutdown", "blocks", *this );
+
 		try
 		{
 			m_FunctionBlock->shutdown();
-			m_Logger.addLine( std::string( getName() + " carried out shutdown" ) );
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_BLOCKS, getName() + " carried out shutdown" );
 		}
 		catch ( Exception &e )
 		{
@@ -399,146 +588,125 @@ namespace _2Real
 
 	void FunctionBlockStateManager::tryTriggerInlet( AbstractInletBasedTrigger &trigger )
 	{
-		m_EnabledAccess.lock();
+		// called once per trigger, when its condition changes from unfulfilled to fulfilled
+		if ( trigger.isOr() )	m_FulfilledSingleTriggers.increment();
+		else					m_FulfilledGroupTriggers.increment();
 
-		if ( m_IsTriggeringEnabled )
-		{
-			m_TriggerAccess.lock();
-
-			// check inlet triggers /////////////////////////////////////////
-			bool groupWeightResult = true;
-			bool singleWeightResult = false;
-
-			for ( InletTriggerIterator it = m_SingleInletTriggers.begin(); it != m_SingleInletTriggers.end(); ++it )	singleWeightResult |= ( *it )->isFulfilled();
-			for ( InletTriggerIterator it = m_GroupInletTriggers.begin(); it != m_GroupInletTriggers.end(); ++it )		groupWeightResult &= ( *it )->isFulfilled();
-			groupWeightResult &= !m_GroupInletTriggers.empty();
+		m_Profile.recordTrigger();
 
-			bool triggersOk = ( groupWeightResult || singleWeightResult );
-			// check inlet triggers /////////////////////////////////////////
-
-			if ( m_TimeTrigger != nullptr )
-			{
-				triggersOk &= m_TimeTrigger->isFulfilled();
-			}
-
-			m_TriggerAccess.unlock();
-
-			// schedule request /////////////////////////////////////////
-			if ( triggersOk )
-			{
-				m_IsTriggeringEnabled = false;
-				m_Logger.addLine( std::string( getName() + " inlet fulfilled trigger conditions" ) );
-
-				ThreadExecRequest *req = new ThreadExecRequest( *this, &FunctionBlockStateManager::updateFunctionBlock );
-				m_Threads.scheduleRequest( *req, m_Thread );
-
-				m_Logger.addLine( std::string( getName() + " scheduled update request" ) );
-			}
-			// schedule request /////////////////////////////////////////
-			else
-			{
-				//m_Logger.addLine( std::string( getName() + " recvd inlet trigger but no update" ) );
-			}
-		}
-		else
-		{
-			//m_Logger.addLine( std::string( getName() + " recvd inlet trigger while disabled" ) );
-		}
-
-		m_EnabledAccess.unlock();
+		tryScheduleUpdate( " inlet" );
 	}
 
 	void FunctionBlockStateManager::tryTriggerTime( TimeBasedTrigger &trigger )
 	{
-		m_EnabledAccess.lock();
-
-		if ( m_IsTriggeringEnabled )
-		{
-			m_TriggerAccess.lock();
+		m_FulfilledTimeTriggers.increment();
+		m_Profile.recordTrigger();
+		tryScheduleUpdate( " time" );
+	}
 
-			bool triggersOk = true;
-			if ( !( m_SingleInletTriggers.empty() && m_GroupInletTriggers.empty() ) )
-			{
-				// check inlet triggers /////////////////////////////////////////
-				bool groupWeightResult = true;
-				bool singleWeightResult = false;
+	bool FunctionBlockStateManager::areTriggersFulfilled() const
+	{
+		const long groupCount = m_GroupTriggerCount.load();
+		const long singleCount = m_SingleTriggerCount.load();
+		const bool hasTimeTrigger = ( m_HasTimeTrigger.load() != 0 );
+		const bool hasInletTriggers = ( groupCount > 0 || singleCount > 0 );
 
-				for ( InletTriggerIterator it = m_SingleInletTriggers.begin(); it != m_SingleInletTriggers.end(); ++it )	singleWeightResult |= ( *it )->isFulfilled();
-				for ( InletTriggerIterator it = m_GroupInletTriggers.begin(); it != m_GroupInletTriggers.end(); ++it )		groupWeightResult &= ( *it )->isFulfilled();
-				groupWeightResult &= !m_GroupInletTriggers.empty();
+		if ( !( hasInletTriggers || hasTimeTrigger ) )
+		{
+			return false;
+		}
 
-				triggersOk = ( groupWeightResult || singleWeightResult );
-				// check inlet triggers /////////////////////////////////////////
-			}
+		bool inletsOk = !hasInletTriggers;
+		inletsOk |= ( m_FulfilledSingleTriggers.load() > 0 );
+		inletsOk |= ( groupCount > 0 && m_FulfilledGroupTriggers.load() >= groupCount );
 
-			// time need not be checked, as this is the time trigger anyway
+		bool timeOk = ( !hasTimeTrigger || m_FulfilledTimeTriggers.load() > 0 );
 
-			m_TriggerAccess.unlock();
+		return ( inletsOk && timeOk );
+	}
 
-			// schedule request /////////////////////////////////////////
-			if ( triggersOk )
-			{
-				m_IsTriggeringEnabled = false;
-				m_Logger.addLine( std::string( getName() + " time fulfilled trigger conditions" ) );
+	void FunctionBlockStateManager::tryScheduleUpdate( std::string const& source )
+	{
+		if ( areTriggersFulfilled() && m_IsTriggeringEnabled.compareAndSwap( 1, 0 ) )
+		{
+			_2REAL_LOG( m_Logger, LogLevel::LOG_DEBUG, LogCategory::LOG_SCHEDULER, getName() + source + " fulfilled trigger conditions" );
+			_2REAL_TRACE_INSTANT( "trigger", "scheduler", getName() );
 
-				ThreadExecRequest *req = new ThreadExecRequest( *this, &FunctionBlockStateManager::updateFunctionBlock );
-				m_Threads.scheduleRequest( *req, m_Thread );
+			ThreadExecRequest *req = new ThreadExecRequest( *this, &FunctionBlockStateManager::updateFunctionBlock );
+			m_Threads->scheduleRequest( *req );
 
-				m_Logger.addLine( std::string( getName() + " scheduled update request" ) );
-			}
-			// schedule request /////////////////////////////////////////
-			else
-			{
-				//m_Logger.addLine( std::string( getName() + " recvd time trigger but no update" ) );
-			}
+			_2REAL_LOG( m_Logger, LogLevel::LOG_DEBUG, LogCategory::LOG_SCHEDULER, getName() + " scheduled update request" );
 		}
-		else
-		{
-			//m_Logger.addLine( std::string( getName() + " recvd time trigger while disabled" ) );
-		}
-
-		m_EnabledAccess.unlock();
 	}
 
 	void FunctionBlockStateManager::addTrigger( AbstractInletBasedTrigger &trigger, const bool isOr )
-	{
-		Poco::ScopedLock< Poco::FastMutex > lock( m_TriggerAccess );
-		if ( isOr )		m_SingleInletTriggers.insert( &trigger );
-		else			m_GroupInletTriggers.insert( &trigger );
-	}
-
-	void FunctionBlockStateManager::removeTrigger( AbstractInletBasedTrigger &trigger, const bool isOr )
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_TriggerAccess );
 		if ( isOr )
 		{
-			InletTriggerIterator it = m_SingleInletTriggers.find( &trigger );
-			if ( it != m_SingleInletTriggers.end() )	m_SingleInletTriggers.erase( it );
+			if ( m_SingleInletTriggers.insert( &trigger ).second )		m_SingleTriggerCount.increment();
 		}
 		else
 		{
-			InletTriggerIterator it = m_GroupInletTriggers.find( &trigger );
-			if ( it != m_GroupInletTriggers.end() )		m_GroupInletTriggers.erase( it );
+			if ( m_GroupInletTriggers.insert( &trigger ).second )		m_GroupTriggerCount.increment();
 		}
 	}
 
+	void FunctionBlockStateManager::removeTrigger( AbstractInletBasedTrigger &trigger, const bool isOr )
+	{
+		m_TriggerAccess.lock();
+
+		InletTriggers &triggers = ( isOr ? m_SingleInletTriggers : m_GroupInletTriggers );
+		InletTriggerIterator it = triggers.find( &trigger );
+		if ( it != triggers.end() )
+		{
+			triggers.erase( it );
+
+			AtomicLong &count = ( isOr ? m_SingleTriggerCount : m_GroupTriggerCount );
+			AtomicLong &fulfilled = ( isOr ? m_FulfilledSingleTriggers : m_FulfilledGroupTriggers );
+			count.decrement();
+			if ( trigger.detach() )		fulfilled.decrement();
+		}
+
+		m_TriggerAccess.unlock();
+
+		// this has to be done, otherwise removing a basic inlet from a multiinlet might lead to a deadlock
+		// ( the remaining group triggers might be fulfilled now ); if the block was shutdown already, nothing happens
+		tryScheduleUpdate( " inlet" );
+	}
+
 	void FunctionBlockStateManager::addTrigger( TimeBasedTrigger &trigger )
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_TriggerAccess );
 		m_TimeTrigger = &trigger;
+		m_HasTimeTrigger.store( 1 );
 	}
 
 	void FunctionBlockStateManager::removeTrigger( TimeBasedTrigger &trigger )
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_TriggerAccess );
-		m_TimeTrigger = nullptr;
+		if ( m_TimeTrigger == &trigger )
+		{
+			m_TimeTrigger = nullptr;
+			m_HasTimeTrigger.store( 0 );
+			if ( trigger.detach() )		m_FulfilledTimeTriggers.decrement();
+		}
 	}
 
-	void FunctionBlockStateManager::setTriggers( const bool fulfilled )
+	void FunctionBlockStateManager::resetTriggers()
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_TriggerAccess );
-		for ( InletTriggerIterator it = m_SingleInletTriggers.begin(); it != m_SingleInletTriggers.end(); ++it )	( *it )->set( fulfilled );
-		for ( InletTriggerIterator it = m_GroupInletTriggers.begin(); it != m_GroupInletTriggers.end(); ++it )		( *it )->set( fulfilled );
-		if ( m_TimeTrigger != nullptr )																				m_TimeTrigger->set( fulfilled );
+		for ( InletTriggerIterator it = m_SingleInletTriggers.begin(); it != m_SingleInletTriggers.end(); ++it )	if ( ( *it )->tryReset() ) m_FulfilledSingleTriggers.decrement();
+		for ( InletTriggerIterator it = m_GroupInletTriggers.begin(); it != m_GroupInletTriggers.end(); ++it )		if ( ( *it )->tryReset() ) m_FulfilledGroupTriggers.decrement();
+		if ( m_TimeTrigger != nullptr && m_TimeTrigger->tryReset() )												m_FulfilledTimeTriggers.decrement();
+	}
+
+	void FunctionBlockStateManager::enableTriggering()
+	{
+		resetTriggers();
+		m_IsTriggeringEnabled.store( 1 );
+
+		// a trigger might have been fulfilled while triggering was disabled
+		tryScheduleUpdate( "" );
 	}
-}
+}
\ No newline at end of file
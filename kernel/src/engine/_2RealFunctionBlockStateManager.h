@@ -19,10 +19,15 @@
 #pragma once
 
 #include "engine/_2RealAbstractStateManager.h"
+#include "engine/_2RealBlockProfile.h"
+#include "engine/_2RealBlockPriority.h"
 #include "helpers/_2RealSynchronizedBool.h"
+#include "helpers/_2RealAtomic.h"
 #include "helpers/_2RealPoco.h"
 #include "helpers/_2RealException.h"
 
+#include <vector>
+
 namespace _2Real
 {
 	namespace bundle
@@ -36,18 +41,29 @@ namespace _2Real
 	class FunctionBlockUpdatePolicy;
 	class AbstractFunctionBlockState;
 	class FunctionBlockIOManager;
-	class PooledThread;
 	class FunctionBlockStateManager;
+	class FrameGroup;
+	class Outlet;
+	class ParallelJob;
 
 	typedef void ( FunctionBlockStateManager::*FunctionToExecute )();
 
+	// either a block function or a helper for a parallel job ( block == nullptr )
 	struct ThreadExecRequest
 	{
-		ThreadExecRequest( FunctionBlockStateManager &mgr, FunctionToExecute func ) : block( mgr ), function( func ), event( nullptr ) {}
+		ThreadExecRequest( FunctionBlockStateManager &mgr, FunctionToExecute func ) :
+			block( &mgr ), function( func ), job( nullptr ), event( nullptr ), scheduled( 0 ), deadline( 0 ), priority( BlockPriority::PRIO_NORMAL ) {}
+
+		explicit ThreadExecRequest( ParallelJob &j ) :
+			block( nullptr ), function( nullptr ), job( &j ), event( nullptr ), scheduled( 0 ), deadline( 0 ), priority( BlockPriority::PRIO_NORMAL ) {}
 
-		FunctionBlockStateManager	&block;
+		FunctionBlockStateManager	*block;
 		FunctionToExecute			function;
+		ParallelJob					*job;
 		Poco::Event					*event;
+		Timer::Time					scheduled;		// set by the thread pool, for profiling
+		Timer::Time					deadline;		// set by the thread pool: scheduled + the block's relative deadline
+		BlockPriority::Priority		priority;
 	};
 
 	class FunctionBlockStateManager : public AbstractStateManager
@@ -70,6 +86,27 @@ namespace _2Real
 		void setupFunctionBlock();
 		void shutdownFunctionBlock();
 
+		// frame mode: the group schedules the updates, a grouped block can't be started
+		void setFrameGroup( FrameGroup *group, const unsigned int stage );
+		void updateFunctionBlockInFrame();
+
+		// fused links: the successor is updated by this block's worker, right after this block, see FusedLink
+		void addFusedSuccessor( Outlet &outlet, FunctionBlockStateManager &successor );
+		void removeFusedSuccessor( FunctionBlockStateManager &successor );
+
+		BlockProfile & getProfile();
+		void getMetrics( app::BlockMetrics &metrics );
+
+		// the pool that executes the block's requests; the block must not be running
+		void setThreadPool( ThreadPool &threads );
+		ThreadPool & getThreadPool();
+
+		// see BlockPriority; a relative deadline <= 0 means the priority's default
+		void setPriority( const BlockPriority::Priority priority );
+		BlockPriority::Priority getPriority() const;
+		void setDeadline( const long microseconds );
+		long getDeadline() const;
+
 		bool isRunning() const;
 
 		void tryTriggerInlet( AbstractInletBasedTrigger &trigger );
@@ -86,24 +123,59 @@ namespace _2Real
 		friend class FunctionBlock;
 
 		void handleStateChangeException( Exception &e );
-		void setTriggers( const bool fulfilled );
+		void resetTriggers();
+		void enableTriggering();
+		bool areTriggersFulfilled() const;
+		void tryScheduleUpdate( std::string const& source );
+		void updateFusedSuccessors();
+
+		struct FusedSuccessor
+		{
+			FusedSuccessor( Outlet &o, FunctionBlockStateManager &b ) : outlet( &o ), block( &b ), lastKey( -1 ) {}
 
-		ThreadPool							&m_Threads;
+			Outlet						*outlet;
+			FunctionBlockStateManager	*block;
+			long						lastKey;		// key of the outlet data the successor was last updated for
+		};
+
+		typedef std::vector< FusedSuccessor >					FusedSuccessors;
+		typedef std::vector< FusedSuccessor >::iterator			FusedSuccessorIterator;
+
+		ThreadPool							*m_Threads;
 		Logger								&m_Logger;
 		FunctionBlockIOManager				*m_IOManager;
 		FunctionBlockUpdatePolicy			*m_UpdatePolicy;
 		bundle::Block						*m_FunctionBlock;
 
+		// guards adding & removing triggers only; a notification just adjusts the counters below, so the
+		// evaluation is O(1) no matter how many inlets the block has:
+		// fulfilled = ( any single inlet trigger || all group triggers ) && time trigger
 		mutable Poco::FastMutex				m_TriggerAccess;
 		InletTriggers						m_GroupInletTriggers;
 		InletTriggers						m_SingleInletTriggers;
 		TimeBasedTrigger					*m_TimeTrigger;
 
+		AtomicLong							m_GroupTriggerCount;
+		AtomicLong							m_SingleTriggerCount;
+		AtomicLong							m_HasTimeTrigger;
+		AtomicLong							m_FulfilledGroupTriggers;
+		AtomicLong							m_FulfilledSingleTriggers;
+		AtomicLong							m_FulfilledTimeTriggers;
+
 		mutable Poco::FastMutex				m_StateAccess;
 		AbstractFunctionBlockState			*m_CurrentState;
 
-		mutable Poco::FastMutex				m_EnabledAccess;
-		bool								m_IsTriggeringEnabled;
+		AtomicLong							m_IsTriggeringEnabled;		// whoever swaps this from 1 to 0 schedules the update
+
+		FrameGroup							*m_FrameGroup;				// guarded by m_StateAccess
+		unsigned int						m_FrameStage;
+
+		BlockProfile						m_Profile;
+		AtomicLong							m_Priority;
+		AtomicLong							m_Deadline;					// relative, us; 0 -> default of the priority
+
+		Poco::FastMutex						m_FusionAccess;				// held while the successors are updated
+		FusedSuccessors						m_FusedSuccessors;
 
 		SynchronizedBool					m_IsFlaggedForHalting;			// if set, block will stop after current update cycle
 		SynchronizedBool					m_IsFlaggedForShutdown;			// if set, block will shut itself doen after current update cycle
@@ -111,8 +183,6 @@ namespace _2Real
 		Poco::Event							m_StopEvent;
 		Poco::Event							m_ShutdownEvent;
 
-		PooledThread						*m_Thread;
-
 		Poco::FastMutex						m_ExceptionAccess;
 		bool								m_HasException;
 		Exception							m_Exception;
@@ -29,6 +29,7 @@ using std::make_pair;
 using std::greater;
 
 #include <assert.h>
+#include <algorithm>
 
 namespace _2Real
 {
@@ -40,7 +41,8 @@ namespace _2Real
 		m_InletPoliciesChanged( false ),
 		m_TimeTrigger( nullptr ),
 		m_UpdateTime( -1 ),
-		m_UpdateRate( 0.0 )
+		m_UpdateRate( 0.0 ),
+		m_SkippedDeadlines( 0 )
 	{
 	}
 
@@ -66,6 +68,7 @@ namespace _2Real
 #endif
 
 		BasicInletBuffer *buffer = inletIO.getBufferPtr();
+		buffer->setDroppedItemCounter( &m_StateManager->getProfile().getDroppedItemCounter() );
 
 		AbstractInletTriggerCtor *c;
 		AbstractInletBasedTrigger *t;
@@ -120,7 +123,7 @@ namespace _2Real
 			safeDelete( m_TimeTrigger );
 			if ( m_UpdateTime > 0 )
 			{
-				m_TimeTrigger = new TimeBasedTrigger( *m_StateManager, m_UpdateTime );
+				m_TimeTrigger = new TimeBasedTrigger( *m_StateManager, m_UpdateTime, m_SkippedDeadlines );
 			}
 
 			m_TimeChanged = false;
@@ -163,13 +166,20 @@ namespace _2Real
 		{
 			m_UpdateTime = -1;
 			m_UpdateRate = 0.0;
+			return;
 		}
 
+		// rates above 1 kHz are fine, the timer's resolution is 1 us
 		double micros = 1000000/rate;
-		m_UpdateTime = static_cast< long >(micros);
+		m_UpdateTime = std::max< long >( static_cast< long >( micros + 0.5 ), 1 );
 		m_UpdateRate = rate;
 	}
 
+	unsigned long FunctionBlockUpdatePolicy::getSkippedDeadlines() const
+	{
+		return static_cast< unsigned long >( m_SkippedDeadlines.load() );
+	}
+
 	void FunctionBlockUpdatePolicy::setInletPolicy( BasicInletIO &io, InletPolicy const& p )
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
@@ -70,6 +70,9 @@ namespace _2Real
 		void setNewUpdateRate( const double rate );
 		double getUpdateRate() const;
 
+		// number of update deadlines that passed without an update, since the block was created
+		unsigned long getSkippedDeadlines() const;
+
 		void setInletPolicy( BasicInletIO &io, InletPolicy const& p );
 
 	private:
@@ -106,6 +109,7 @@ namespace _2Real
 		TimeBasedTrigger				*m_TimeTrigger;
 		long							m_UpdateTime;
 		double							m_UpdateRate;
+		AtomicLong						m_SkippedDeadlines;
 		InletPolicyMap					m_InletPolicies;
 
 	};
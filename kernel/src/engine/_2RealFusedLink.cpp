@@ -0,0 +1,123 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#include "engine/_2RealFusedLink.h"
+#include "engine/_2RealFunctionBlock.h"
+#include "engine/_2RealFunctionBlockIOManager.h"
+#include "engine/_2RealFunctionBlockStateManager.h"
+#include "engine/_2RealFunctionBlockUpdatePolicy.h"
+#include "engine/_2RealAbstractIOManager.h"
+#include "engine/_2RealInletBuffer.h"
+#include "engine/_2RealOutlet.h"
+
+namespace _2Real
+{
+
+	FusedLink::FusedLink( IOLink &link, FunctionBlock< app::BlockHandle > &upstream, FunctionBlock< app::BlockHandle > &downstream ) :
+		m_Link( link ),
+		m_Upstream( upstream ),
+		m_Downstream( downstream )
+	{
+		m_Link.deactivate();
+		m_Link.getInletIO().setFrameSource( m_Link.getOutletIO().m_Outlet );
+		m_Upstream.m_StateManager->addFusedSuccessor( *m_Link.getOutletIO().m_Outlet, *m_Downstream.m_StateManager );
+	}
+
+	FusedLink::~FusedLink()
+	{
+		m_Upstream.m_StateManager->removeFusedSuccessor( *m_Downstream.m_StateManager );
+		m_Link.getInletIO().setFrameSource( nullptr );
+		m_Link.activate();
+	}
+
+	bool FusedLink::isFusable( IOLink &link, EngineImpl::Links const& links, FunctionBlock< app::BlockHandle > const& downstream )
+	{
+		BasicInletIO &inlet = link.getInletIO();
+		OutletIO const& outlet = link.getOutletIO();
+
+		if ( &outlet.m_Outlet->getOwningUberBlock() == &downstream ) return false;
+
+		// the inlet must be the only linked inlet of the downstream block; the others are parameters,
+		// set by the application & not gating the update ( unfused, an and-newer-data parameter would )
+		FunctionBlockIOManager::InletVector const& inlets = downstream.m_IOManager->m_Inlets;
+		bool isDownstreamInlet = false;
+		for ( FunctionBlockIOManager::InletVector::const_iterator it = inlets.begin(); it != inlets.end(); ++it )
+		{
+			if ( *it == &inlet )
+			{
+				isDownstreamInlet = true;
+				continue;
+			}
+
+			for ( unsigned int i=0; i<( *it )->getSize(); ++i )
+			{
+				BasicInletIO &other = ( **it )[ i ];
+				if ( other.info().policy.getPolicy() == InletPolicy::AND_NEWER_DATA ) return false;
+				for ( EngineImpl::LinkConstIterator l = links.begin(); l != links.end(); ++l )
+				{
+					if ( &( *l )->getInletIO() == &other ) return false;
+				}
+			}
+		}
+		if ( !isDownstreamInlet ) return false;
+
+		// ... which must be driven by data only ...
+		const InletPolicy::Policy policy = inlet.info().policy.getPolicy();
+		if ( policy != InletPolicy::OR_NEWER_DATA && policy != InletPolicy::AND_NEWER_DATA ) return false;
+		if ( downstream.m_UpdatePolicy->getUpdateRate() > 0. ) return false;
+
+		// ... & take the data as it is
+		if ( !inlet.info().options.isEmpty() ) return false;
+		if ( !inlet.info().type.isSameType( outlet.m_Outlet->getTypeDescriptor() ) ) return false;
+		if ( inlet.getBuffer().isBatchDelivery() ) return false;
+
+		// a single outlet feeding a single inlet
+		unsigned int inletLinks = 0, outletLinks = 0;
+		for ( EngineImpl::LinkConstIterator it = links.begin(); it != links.end(); ++it )
+		{
+			if ( &( *it )->getInletIO() == &inlet ) ++inletLinks;
+			if ( &( *it )->getOutletIO() == &outlet ) ++outletLinks;
+		}
+		return ( inletLinks == 1 && outletLinks == 1 );
+	}
+
+	bool FusedLink::isBlockInvolved( AbstractUberBlock const& block ) const
+	{
+		return ( isUpstream( block ) || isDownstream( block ) );
+	}
+
+	bool FusedLink::isInletInvolved( BasicInletIO const& inlet ) const
+	{
+		return ( &m_Link.getInletIO() == &inlet );
+	}
+
+	bool FusedLink::isUpstream( AbstractUberBlock const& block ) const
+	{
+		return ( &m_Upstream == &block );
+	}
+
+	AbstractUberBlock const& FusedLink::getUpstream() const
+	{
+		return m_Upstream;
+	}
+
+	bool FusedLink::isDownstream( AbstractUberBlock const& block ) const
+	{
+		return ( &m_Downstream == &block );
+	}
+
+}
@@ -0,0 +1,63 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#pragma once
+
+#include "engine/_2RealEngineImpl.h"
+#include "helpers/_2RealNonCopyable.h"
+
+namespace _2Real
+{
+
+	class Outlet;
+	class BasicInletIO;
+	class AbstractUberBlock;
+
+	// fusion of a linear chain: a link from an outlet to the only linked inlet of a purely data driven block
+	// ( newer data policy, no update rate ). other inlets of the block are parameters that the application sets;
+	// they are taken over right before each fused update, like in a single step. while fused, the link bypasses
+	// outlet event, inlet buffer, trigger & thread pool: the worker that updated the upstream block updates the
+	// downstream block right after it, which reads the outlet directly. a chain of fused links thus runs as one
+	// unit on one thread - also after a single step of its head. the downstream block still needs to be started -
+	// if it is not, it's skipped & picks up the newest data once it was started and the upstream block has updated again
+	class FusedLink : private NonCopyable< FusedLink >
+	{
+
+	public:
+
+		// the link must be fusable, see below
+		FusedLink( IOLink &link, FunctionBlock< app::BlockHandle > &upstream, FunctionBlock< app::BlockHandle > &downstream );
+		// reactivates the link; once this returns, the downstream block is not updated by the upstream block anymore
+		~FusedLink();
+
+		static bool		isFusable( IOLink &link, EngineImpl::Links const& links, FunctionBlock< app::BlockHandle > const& downstream );
+
+		bool			isBlockInvolved( AbstractUberBlock const& block ) const;
+		bool			isInletInvolved( BasicInletIO const& inlet ) const;
+		bool			isUpstream( AbstractUberBlock const& block ) const;
+		bool			isDownstream( AbstractUberBlock const& block ) const;
+		AbstractUberBlock const&	getUpstream() const;
+
+	private:
+
+		IOLink									&m_Link;
+		FunctionBlock< app::BlockHandle >		&m_Upstream;
+		FunctionBlock< app::BlockHandle >		&m_Downstream;
+
+	};
+
+}
@@ -32,7 +32,11 @@ namespace _2Real
 	}
 
 	BasicInlet::BasicInlet( AbstractUberBlock &owningBlock, string const& name ) :
-		AbstractInlet( owningBlock, name )
+		AbstractInlet( owningBlock, name ),
+		m_CurrentHashState( HASH_UNKNOWN ),
+		m_CurrentHash( 0 ),
+		m_LastHashState( HASH_UNKNOWN ),
+		m_LastHash( 0 )
 	{
 	}
 
@@ -46,17 +50,77 @@ namespace _2Real
 		return ( m_CurrentData.key != m_LastData.key );
 	}
 
+	// data published by outlets carries a version, so this is usually a compare of two longs;
+	// everything else ( values set by the app, initial values ) falls back to content hashes or,
+	// for inline & unhashable types, to comparing the values
 	bool BasicInlet::hasChanged() const
 	{
-		return ( !m_CurrentData.anyValue.isEqualTo( m_LastData.anyValue ) );
+		if ( m_CurrentData.version != 0 && m_LastData.version != 0 )
+		{
+			return ( m_CurrentData.version != m_LastData.version );
+		}
+
+		Any const& current = m_CurrentData.anyValue;
+		Any const& last = m_LastData.anyValue;
+		if ( !current.hasSameType( last ) )
+		{
+			return true;
+		}
+		else if ( current.sharesValueWith( last ) )
+		{
+			return false;
+		}
+
+		unsigned long long currentHash;
+		if ( getCurrentHash( currentHash ) )
+		{
+			if ( m_LastHashState == HASH_UNKNOWN )
+			{
+				m_LastHashState = ( last.hashContent( m_LastHash ) ? HASH_VALID : HASH_UNAVAILABLE );
+			}
+
+			if ( m_LastHashState == HASH_VALID ) return ( currentHash != m_LastHash );
+		}
+
+		return ( !current.isEqualTo( last ) );
+	}
+
+	bool BasicInlet::getCurrentHash( unsigned long long &hash ) const
+	{
+		if ( m_CurrentHashState == HASH_UNKNOWN )
+		{
+			m_CurrentHashState = ( m_CurrentData.anyValue.hashContent( m_CurrentHash ) ? HASH_VALID : HASH_UNAVAILABLE );
+		}
+
+		hash = m_CurrentHash;
+		return ( m_CurrentHashState == HASH_VALID );
 	}
 
 	void BasicInlet::setData( TimestampedData const& data )
 	{
+		if ( !data.anyValue.sharesValueWith( m_CurrentData.anyValue ) )
+		{
+			m_LastHashState = m_CurrentHashState;
+			m_LastHash = m_CurrentHash;
+			m_CurrentHashState = HASH_UNKNOWN;
+		}
+		else m_LastHashState = m_CurrentHashState;
+
 		m_LastData = m_CurrentData;
 		m_CurrentData = data;
 	}
 
+	TimestampedDataBatch const& BasicInlet::getCurrentBatch() const
+	{
+		return m_CurrentBatch;
+	}
+
+	void BasicInlet::setBatch( TimestampedDataBatch &batch )
+	{
+		m_CurrentBatch.swap( batch );
+		batch.clear();
+	}
+
 	MultiInlet::MultiInlet( AbstractUberBlock &owningBlock, string const& name ) :
 		AbstractInlet( owningBlock, name )
 	{
@@ -62,13 +62,26 @@ namespace _2Real
 
 		TimestampedData const&		getCurrentData() const;
 		void						setData( TimestampedData const& data );
+		TimestampedDataBatch const&	getCurrentBatch() const;
+		void						setBatch( TimestampedDataBatch &batch );		// swaps, batch receives the previous ( cleared ) one
 		bool						hasUpdated() const;
 		bool						hasChanged() const;
 
 	private:
 
+		bool						getCurrentHash( unsigned long long &hash ) const;
+
 		TimestampedData				m_LastData;
 		TimestampedData				m_CurrentData;
+		TimestampedDataBatch		m_CurrentBatch;
+
+		// content hashes for data without a version, computed on demand & handed on from current to last;
+		// only touched by the updating thread, like the data itself
+		enum HashState { HASH_UNKNOWN, HASH_VALID, HASH_UNAVAILABLE };
+		mutable HashState			m_CurrentHashState;
+		mutable unsigned long long	m_CurrentHash;
+		mutable HashState			m_LastHashState;
+		mutable unsigned long long	m_LastHash;
 
 	};
 
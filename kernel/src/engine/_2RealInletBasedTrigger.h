@@ -47,10 +47,11 @@ namespace _2Real
 
 	public:
 
-		AbstractInletBasedTrigger( BasicInletBuffer &buffer, AbstractStateManager &mgr ) :
+		AbstractInletBasedTrigger( BasicInletBuffer &buffer, AbstractStateManager &mgr, const bool isOr ) :
 			m_Condition( false ),
 			m_Buffer( buffer ),
 			m_UpdateManager( mgr ),
+			m_IsOr( isOr ),
 			m_LastData( Any(), 0 )			// default data has timestamp 0 and thus will not fulfill the newer cond
 		{
 		}
@@ -76,13 +77,16 @@ namespace _2Real
 		}
 
 		bool isFulfilled() const { return m_Condition.isFulfilled(); }
-		void set( const bool fulfilled ) { m_Condition.set( fulfilled ); }
+		bool tryReset() { return m_Condition.tryReset(); }
+		bool detach() { return m_Condition.detach(); }
+		bool isOr() const { return m_IsOr; }
 
 	protected:
 
 		UpdateCondition			m_Condition;
 		BasicInletBuffer		&m_Buffer;
 		AbstractStateManager	&m_UpdateManager;
+		bool					m_IsOr;
 		TimestampedData			m_LastData;
 
 	};
@@ -94,8 +98,7 @@ namespace _2Real
 	public:
 
 		InletBasedTrigger( BasicInletBuffer &buffer, AbstractStateManager &mgr, const bool isOr ) :
-			AbstractInletBasedTrigger( buffer, mgr ),
-			m_IsOr( isOr )
+			AbstractInletBasedTrigger( buffer, mgr, isOr )
 		{
 			mgr.addTrigger( *this, isOr );
 			AbstractCallback< TimestampedData const& > *cb =
@@ -109,17 +112,12 @@ namespace _2Real
 			AbstractCallback< TimestampedData const& > *cb =
 				new MemberCallback< InletBasedTrigger< TCond >, TimestampedData const& >( *this, &InletBasedTrigger< TCond >::tryTriggerUpdate );
 			m_Buffer.removeTrigger( *cb );
-
-			// this has to be done, otherwise removing a basic inlet from a multiinlet might lead to a deadlock
-			// if the block owning the inlet was shutdown already, nothing should happen
-			m_UpdateManager.tryTriggerInlet( *this );
 		}
 
 		void tryTriggerUpdate( TimestampedData const& data )
 		{
-			if ( !m_Condition.isFulfilled() && m_ConditionCheck( data, m_LastData ) )
+			if ( !m_Condition.isFulfilled() && m_ConditionCheck( data, m_LastData ) && m_Condition.tryFulfill() )
 			{
-				m_Condition.set( true );
 				m_Buffer.disableTriggering( data );
 				m_LastData = data;
 				m_UpdateManager.tryTriggerInlet( *this );
@@ -128,7 +126,6 @@ namespace _2Real
 
 	private:
 
-		bool				m_IsOr;
 		TCond				m_ConditionCheck;
 
 	};
@@ -18,6 +18,7 @@
 
 #include "engine/_2RealInletBuffer.h"
 #include "engine/_2RealEngineImpl.h"
+#include "engine/_2RealTracer.h"
 
 #include <assert.h>
 #include <sstream>
@@ -296,39 +297,6 @@ namespace _2Real
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	RemoveOldest::RemoveOldest( const unsigned int max ) :
-		m_Max( max )
-	{
-	}
-
-	bool RemoveOldest::insertData( TimestampedData const& data, AbstractInletBuffer::DataBuffer &buffer )
-	{
-		Poco::ScopedLock< Poco::FastMutex > lock( m_Mutex );
-
-		while ( buffer.size() >= m_Max && !buffer.empty() )
-		{
-			// TODO: some sort of overflow cb for the app i guess
-			buffer.pop_front();
-		}
-
-		buffer.push_back( data );
-		return true;
-	}
-
-	void RemoveOldest::setMaxSize( const unsigned int max )
-	{
-		Poco::ScopedLock< Poco::FastMutex > lock( m_Mutex );
-		m_Max = max;
-	}
-
-	unsigned int RemoveOldest::getMaxSize() const
-	{
-		Poco::ScopedLock< Poco::FastMutex > lock( m_Mutex );
-		return m_Max;
-	}
-
-	////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
 	AbstractInletBuffer::AbstractInletBuffer( AnyOptionSet const& options ) :
 		m_Engine( EngineImpl::instance() ),
 		m_Options( options )
@@ -339,22 +307,36 @@ namespace _2Real
 
 	BasicInletBuffer::BasicInletBuffer( Any const& initialValue, AnyOptionSet const& options ) :
 		AbstractInletBuffer( options ),
-		m_InsertionPolicy( new RemoveOldest( 1 ) ),
-		m_NotifyOnReceive( true ),
 		m_Counter( 0 ),
-		m_InitialValue( initialValue )
+		m_ReceivedDataItems( new DataBuffer( 1, TimestampedData() ) ),
+		m_IsBatchDelivery( 0 ),
+		m_NotifyOnReceive( 1 ),
+		m_InitialValue( initialValue ),
+		m_Descriptor( &initialValue.getTypeDescriptor() ),
+		m_ActiveProducers( 0 ),
+		m_ProducersBlocked( 0 ),
+		m_OverflowPolicy( OverflowPolicy::DROP_OLDEST ),
+		m_MaxBlockingTime( OverflowPolicy::DefaultMaxBlockingTime ),
+		m_OverflowCount( 0 ),
+		m_DroppedItems( nullptr ),
+		m_SpaceAvailable( true ),
+		m_ProducersLeft( true ),
+		m_IsTriggeringDataConverted( false ),
+		m_HasImageFormat( 0 ),
+		m_ImageFormat( ImageType::UNSIGNED_BYTE, ImageChannelOrder::RGBA, 0. )
 	{
 	}
 
 	BasicInletBuffer::~BasicInletBuffer()
 	{
-		delete m_InsertionPolicy;
+		delete m_ReceivedDataItems;
 	}
 
 	void BasicInletBuffer::setInitialValue( Any const& initialValue )
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_InitialDataAccess );
 		m_InitialValue = initialValue;
+		m_Descriptor = &initialValue.getTypeDescriptor();
 	}
 
 	void BasicInletBuffer::setInitialValueToString( std::string const& dataAsString )
@@ -400,24 +382,23 @@ namespace _2Real
 
 	void BasicInletBuffer::receiveData( TimestampedData const& data )
 	{
+		_2REAL_TRACE_INSTANT( "receive", "inlets", m_TraceName );
+
 		// perform conversion, if necessary //////////////////////////////////////////////////////
-		m_InitialDataAccess.lock();
-		const Type tDst= m_InitialValue.getType();
-		const TypeCategory cDst = m_InitialValue.getTypeCategory();
-		m_InitialDataAccess.unlock();
+		// descriptors are interned, so the usual case is a pointer compare
+		TypeDescriptor const& tDst = *m_Descriptor;
+		TypeDescriptor const& tSrc = data.anyValue.getTypeDescriptor();
 
 		TimestampedData received;
-		const Type tSrc = data.anyValue.getType();
-		if ( !( tSrc == tDst ) )
+		if ( !tSrc.isSameType( tDst ) && !( tSrc.m_Type == tDst.m_Type ) )
 		{
-			const TypeCategory cSrc = data.anyValue.getTypeCategory();
-			if ( cSrc == TypeCategory::ARITHMETHIC && cDst == TypeCategory::ARITHMETHIC )
+			if ( tSrc.m_TypeCategory == TypeCategory::ARITHMETHIC && tDst.m_TypeCategory == TypeCategory::ARITHMETHIC )
 			{
-				Any converted = arithmethicConversion( data.anyValue, tDst );
-				received = TimestampedData( converted, data.timestamp, ++m_Counter );
+				Any converted = arithmethicConversion( data.anyValue, tDst.m_Type );
+				received = TimestampedData( converted, data.timestamp, m_Counter.increment(), data.version );		// same source value -> same converted value
 			}
 		}
-		else received = TimestampedData( data.anyValue, data.timestamp, ++m_Counter );
+		else received = TimestampedData( data.anyValue, data.timestamp, m_Counter.increment(), data.version );
 		/////////////////////////////////////////////////////////////////////////////////////////
 
 		// perform option check, if necessary ///////////////////////////////////////////////////
@@ -434,14 +415,174 @@ namespace _2Real
 
 		// m_Notify -> true: processBufferedData was called, meaning an update cycle was finished OR start was called
 		// otherwise: move data into buffer
-		m_NotificationAccess.lock();
-		if ( m_NotifyOnReceive )		m_TriggeringEvent.notify( received );
-		else
+		if ( m_NotifyOnReceive.load() )
 		{
+			Poco::ScopedLock< Poco::FastMutex > lock( m_NotificationAccess );
+			if ( m_NotifyOnReceive.load() )
+			{
+				if ( !m_IsBatchDelivery.load() )
+				{
+					m_TriggeringEvent.notify( received );
+					return;
+				}
+				else if ( notifyBatch( received ) ) return;
+				// the batch is full: the item goes to the ring, which applies the overflow policy
+			}
+		}
+
+		bufferData( received );
+
+		// processBufferedData might have run between the check above and the insertion,
+		// in which case nobody would look at the buffered data before the next update cycle
+		if ( m_NotifyOnReceive.load() )
+		{
+			Poco::ScopedLock< Poco::FastMutex > lock( m_NotificationAccess );
+			notifyBufferedData();
+		}
+	}
+
+	void BasicInletBuffer::bufferData( TimestampedData const& data )
+	{
+		// register as producer, unless the ring is about to be replaced
+		while ( true )
+		{
+			m_ActiveProducers.increment();
+			if ( !m_ProducersBlocked.load() ) break;
+			leaveProducers();
 			Poco::ScopedLock< Poco::FastMutex > lock( m_BufferAccess );
-			m_InsertionPolicy->insertData( received, m_ReceivedDataItems );
 		}
-		m_NotificationAccess.unlock();
+
+		DataBuffer &buffer = *m_ReceivedDataItems;
+		switch ( m_OverflowPolicy )
+		{
+		case OverflowPolicy::DROP_NEWEST:
+			if ( !buffer.tryPush( data ) ) countOverflow();
+			break;
+		case OverflowPolicy::BLOCK_PRODUCER:
+			if ( !buffer.tryPush( data ) )
+			{
+				Poco::Timestamp start;
+				while ( true )
+				{
+					const long remaining = m_MaxBlockingTime - static_cast< long >( start.elapsed() / 1000 );
+					if ( remaining <= 0 )
+					{
+						countOverflow();
+						break;
+					}
+
+					m_SpaceAvailable.tryWait( remaining );
+					if ( m_ProducersBlocked.load() )
+					{
+						// the ring is about to be replaced: give up, and pass the wake up on to the next blocked sender
+						countOverflow();
+						m_SpaceAvailable.set();
+						break;
+					}
+					else if ( buffer.tryPush( data ) )
+					{
+						// more slots might have been freed, pass the wake up on to the next blocked sender
+						m_SpaceAvailable.set();
+						break;
+					}
+				}
+			}
+			break;
+		default:
+			while ( !buffer.tryPush( data ) )
+			{
+				if ( buffer.tryDrop() ) countOverflow();
+			}
+			break;
+		}
+
+		leaveProducers();
+	}
+
+	// m_NotificationAccess must be locked
+	void BasicInletBuffer::notifyBufferedData()
+	{
+		TimestampedData d;
+		if ( m_IsBatchDelivery.load() )
+		{
+			// drain as much as fits into the batch, then evaluate the trigger condition once;
+			// whatever doesn't fit stays in the ring, so the ring's overflow policy applies to it
+			bool received = false;
+			while ( canAddToBatch() && m_ReceivedDataItems->tryPop( d ) )
+			{
+				addToBatch( d );
+				received = true;
+			}
+
+			if ( received && m_NotifyOnReceive.load() )
+			{
+				m_TriggeringEvent.notify( m_PendingBatch.back() );
+			}
+		}
+		else
+		{
+			while ( m_NotifyOnReceive.load() && m_ReceivedDataItems->tryPop( d ) )
+			{
+				m_TriggeringEvent.notify( d );
+			}
+		}
+
+		if ( m_OverflowPolicy == OverflowPolicy::BLOCK_PRODUCER ) m_SpaceAvailable.set();
+	}
+
+	// m_NotificationAccess must be locked; false if the batch is full & the item must be buffered instead
+	bool BasicInletBuffer::notifyBatch( TimestampedData const& data )
+	{
+		if ( !canAddToBatch() ) return false;
+
+		addToBatch( data );
+		m_TriggeringEvent.notify( m_PendingBatch.back() );
+		return true;
+	}
+
+	// m_NotificationAccess must be locked. the batch holds at most buffer size items; when it is full,
+	// drop oldest makes room by discarding the batch's oldest item, the other policies leave the item in the ring
+	bool BasicInletBuffer::canAddToBatch() const
+	{
+		return ( m_PendingBatch.size() < m_ReceivedDataItems->getMaxSize() || m_OverflowPolicy == OverflowPolicy::DROP_OLDEST );
+	}
+
+	// m_NotificationAccess must be locked
+	void BasicInletBuffer::addToBatch( TimestampedData const& data )
+	{
+		if ( m_PendingBatch.size() >= m_ReceivedDataItems->getMaxSize() )
+		{
+			m_PendingBatch.erase( m_PendingBatch.begin() );
+			countOverflow();
+		}
+		m_PendingBatch.push_back( data );
+	}
+
+	// m_BufferAccess must be locked. senders waiting for space are woken & give up
+	void BasicInletBuffer::blockProducers()
+	{
+		m_ProducersBlocked.store( 1 );
+		m_SpaceAvailable.set();
+		while ( m_ActiveProducers.load() > 0 )
+		{
+			// a set left over from an earlier block only causes another check
+			m_ProducersLeft.wait();
+		}
+	}
+
+	void BasicInletBuffer::unblockProducers()
+	{
+		m_ProducersBlocked.store( 0 );
+	}
+
+	// the flag is read after the decrement & stored before blockProducers reads the count,
+	// so either the last producer signals or blockProducers sees that there are none left
+	void BasicInletBuffer::leaveProducers()
+	{
+		if ( m_ActiveProducers.decrement() == 0 && m_ProducersBlocked.load() )
+		{
+			m_ProducersLeft.set();
+		}
 	}
 
 	TimestampedData const& BasicInletBuffer::getTriggeringData() const
@@ -454,11 +595,14 @@ namespace _2Real
 	// meaning the triggering data will stay on default
 	void BasicInletBuffer::clearBufferedData()
 	{
-		m_BufferAccess.lock();
-		m_ReceivedDataItems.clear();
-		m_BufferAccess.unlock();
+		m_NotificationAccess.lock();
+		while ( m_ReceivedDataItems->tryDrop() ) {}
+		m_PendingBatch.clear();
+		m_TriggeringBatch.clear();
+		m_NotificationAccess.unlock();
 
 		m_TriggeringData = m_InitialValue;
+		m_IsTriggeringDataConverted = false;
 	}
 
 	// called right after block update; re-enables triggering, then tries to fulfill the trigger cond with buffered data / last data / default data
@@ -466,46 +610,184 @@ namespace _2Real
 	void BasicInletBuffer::processBufferedData( const bool enableTriggering )
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_NotificationAccess );
-		m_NotifyOnReceive = true;
+		m_NotifyOnReceive.store( 1 );
 
-		m_BufferAccess.lock();
-		for ( DataBufferIterator dIt = m_ReceivedDataItems.begin(); dIt != m_ReceivedDataItems.end(); /**/ )
-		{
-			TimestampedData d = *dIt;
-			m_TriggeringEvent.notify( d );
-
-			if ( !m_NotifyOnReceive )
-			{
-				dIt = m_ReceivedDataItems.erase( dIt );
-				break;
-			}
-			else
-			{
-				dIt = m_ReceivedDataItems.erase( dIt );
-			}
-		}
-		m_BufferAccess.unlock();
+		notifyBufferedData();
 
 		m_TriggeringEvent.notify( m_TriggeringData );
 
 		// should be false only in singlestep
-		if ( !enableTriggering ) m_NotifyOnReceive = false;
+		if ( !enableTriggering ) m_NotifyOnReceive.store( 0 );
 	}
 
+	// called by the trigger, from within a notification ( m_NotificationAccess is locked )
 	void BasicInletBuffer::disableTriggering( TimestampedData const& data )
 	{
-		m_NotifyOnReceive = false;
+		m_NotifyOnReceive.store( 0 );
 		m_TriggeringData = data;
+		m_IsTriggeringDataConverted = false;
+
+		// the pending items go with the triggering data; the vectors are swapped, so their capacity is reused
+		if ( m_IsBatchDelivery.load() )
+		{
+			m_TriggeringBatch.swap( m_PendingBatch );
+			m_PendingBatch.clear();
+		}
+	}
+
+	void BasicInletBuffer::countOverflow()
+	{
+		m_OverflowCount.increment();
+		if ( m_DroppedItems != nullptr ) m_DroppedItems->increment();
+	}
+
+	void BasicInletBuffer::setDroppedItemCounter( AtomicLong *counter )
+	{
+		m_DroppedItems = counter;
+	}
+
+	void BasicInletBuffer::setTraceName( std::string const& name )
+	{
+		m_TraceName = name;
+	}
+
+	long BasicInletBuffer::nextKey()
+	{
+		return m_Counter.increment();
+	}
+
+	void BasicInletBuffer::setBatchDelivery( const bool enabled )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_NotificationAccess );
+		m_IsBatchDelivery.store( enabled ? 1 : 0 );
+		m_PendingBatch.clear();
+	}
+
+	bool BasicInletBuffer::isBatchDelivery() const
+	{
+		return ( m_IsBatchDelivery.load() != 0 );
+	}
+
+	void BasicInletBuffer::setImageFormat( ImageFormat const& format )
+	{
+		if ( !m_Descriptor->isSameType( *getTypeDescriptor< Image >() ) )
+		{
+			throw InvalidTypeException( "only image inlets can have an image format" );
+		}
+
+		Poco::ScopedLock< Poco::FastMutex > lock( m_ImageFormatAccess );
+		m_ImageFormat = format;
+		m_HasImageFormat.store( 1 );
+	}
+
+	void BasicInletBuffer::clearImageFormat()
+	{
+		m_HasImageFormat.store( 0 );
+	}
+
+	bool BasicInletBuffer::hasImageFormat() const
+	{
+		return ( m_HasImageFormat.load() != 0 );
+	}
+
+	// the converted image gets the version of the source: same source, same result
+	TimestampedData BasicInletBuffer::applyImageFormat( TimestampedData const& data ) const
+	{
+		if ( !m_HasImageFormat.load() || !data.anyValue.isDatatype< Image >() )
+		{
+			return data;
+		}
+
+		m_ImageFormatAccess.lock();
+		ImageFormat format = m_ImageFormat;
+		m_ImageFormatAccess.unlock();
+
+		Image const& src = data.anyValue.extract< Image >();
+		if ( !ImageConversion::needsConversion( src, format.type, format.order ) && format.scale <= 0. )
+		{
+			return data;
+		}
+
+		Image dst;
+		if ( format.scale > 0. )	ImageConversion::convert( src, dst, format.type, format.order, format.scale );
+		else						ImageConversion::convert( src, dst, format.type, format.order );
+		return TimestampedData( Any( dst ), data.timestamp, data.key, data.version );
+	}
+
+	// triggering data & batch are converted when the block takes them, not on receiving: so items that
+	// are dropped ( options, overflow ) or superseded before an update are never converted. once per trigger,
+	// since they're handed to every update until the next trigger - and a scale must not be applied twice
+	void BasicInletBuffer::convertTriggeringData()
+	{
+		if ( m_IsTriggeringDataConverted ) return;
+		m_IsTriggeringDataConverted = true;
+		if ( !m_HasImageFormat.load() ) return;
+
+		m_TriggeringData = applyImageFormat( m_TriggeringData );
+		for ( TimestampedDataBatch::iterator it = m_TriggeringBatch.begin(); it != m_TriggeringBatch.end(); ++it )
+		{
+			*it = applyImageFormat( *it );
+		}
+	}
+
+	// only touched between triggering & processBufferedData, i.e. while the block is updating
+	TimestampedDataBatch & BasicInletBuffer::getTriggeringBatch()
+	{
+		return m_TriggeringBatch;
 	}
 
 	void BasicInletBuffer::setBufferSize( const unsigned int size )
 	{
-		m_InsertionPolicy->setMaxSize( size );
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BufferAccess );
+
+		if ( size == m_ReceivedDataItems->getMaxSize() ) return;
+
+		blockProducers();
+
+		m_NotificationAccess.lock();
+		DataBuffer *buffer = new DataBuffer( size, TimestampedData() );
+		TimestampedData d;
+		while ( m_ReceivedDataItems->tryPop( d ) )
+		{
+			while ( !buffer->tryPush( d ) )
+			{
+				if ( buffer->tryDrop() ) countOverflow();
+			}
+		}
+		delete m_ReceivedDataItems;
+		m_ReceivedDataItems = buffer;
+		m_NotificationAccess.unlock();
+
+		unblockProducers();
 	}
 
 	unsigned int BasicInletBuffer::getBufferSize() const
 	{
-		return m_InsertionPolicy->getMaxSize();
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BufferAccess );
+		return m_ReceivedDataItems->getMaxSize();
+	}
+
+	void BasicInletBuffer::setOverflowPolicy( OverflowPolicy const& policy )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BufferAccess );
+
+		if ( policy.getPolicy() == OverflowPolicy::INVALID ) throw Exception( "invalid overflow policy" );
+
+		blockProducers();
+		m_OverflowPolicy = policy.getPolicy();
+		m_MaxBlockingTime = policy.getMaxBlockingTime();
+		unblockProducers();
+	}
+
+	OverflowPolicy BasicInletBuffer::getOverflowPolicy() const
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BufferAccess );
+		return OverflowPolicy( m_OverflowPolicy, m_MaxBlockingTime );
+	}
+
+	unsigned long BasicInletBuffer::getOverflowCount() const
+	{
+		return static_cast< unsigned long >( m_OverflowCount.load() );
 	}
 
 	void BasicInletBuffer::setTrigger( AbstractCallback< TimestampedData const& > &callback )
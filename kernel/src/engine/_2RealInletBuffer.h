@@ -19,11 +19,13 @@
 #pragma once
 
 #include "engine/_2RealTimestampedData.h"
+#include "engine/_2RealOverflowPolicy.h"
 #include "helpers/_2RealEvent.h"
 #include "helpers/_2RealPoco.h"
 #include "helpers/_2RealOptions.h"
-
-#include <list>
+#include "helpers/_2RealAtomic.h"
+#include "helpers/_2RealRingBuffer.h"
+#include "datatypes/_2RealImageConversion.h"
 
 namespace _2Real
 {
@@ -31,35 +33,6 @@ namespace _2Real
 	template< typename T >
 	class AbstractCallback;
 
-	class AbstractInsertionPolicy
-	{
-
-	public:
-
-		virtual bool insertData( TimestampedData const& data, std::list< TimestampedData > &buffer ) = 0;
-		virtual ~AbstractInsertionPolicy() {};
-		virtual void setMaxSize( const unsigned int max ) = 0;
-		virtual unsigned int getMaxSize() const = 0;
-
-	};
-
-	class RemoveOldest : public AbstractInsertionPolicy
-	{
-
-	public:
-
-		RemoveOldest( const unsigned int max );
-		bool insertData( TimestampedData const& data, std::list< TimestampedData > &buffer );
-		void setMaxSize( const unsigned int max );
-		unsigned int getMaxSize() const;
-
-	private:
-
-		mutable Poco::FastMutex		m_Mutex;
-		unsigned int				m_Max;
-
-	};
-
 	class EngineImpl;
 	class BasicInletBuffer;
 
@@ -68,9 +41,6 @@ namespace _2Real
 
 	public:
 
-		typedef std::list< TimestampedData >			DataBuffer;
-		typedef std::list< TimestampedData >::iterator	DataBufferIterator;
-
 		AbstractInletBuffer( AnyOptionSet const& options );
 		virtual ~AbstractInletBuffer() {}
 
@@ -84,6 +54,8 @@ namespace _2Real
 
 	};
 
+	// data received while the block is busy is stored in a bounded, preallocated ring;
+	// senders only take a lock if the data can be handed to the triggers right away
 	class BasicInletBuffer : public AbstractInletBuffer
 	{
 
@@ -107,6 +79,32 @@ namespace _2Real
 		TimestampedData const& getTriggeringData() const;
 		void setBufferSize( const unsigned int size );
 		unsigned int getBufferSize() const;
+		void setOverflowPolicy( OverflowPolicy const& policy );
+		OverflowPolicy getOverflowPolicy() const;
+		unsigned long getOverflowCount() const;
+		// block wide counter that overflows are added to as well ( profiling ), set once before any data arrives
+		void setDroppedItemCounter( AtomicLong *counter );
+		// subject of the 'receive' events in the timeline, see Tracer
+		void setTraceName( std::string const& name );
+
+		// batched delivery: instead of one item per update, the trigger condition is evaluated once for everything
+		// that was buffered, and the block receives all these items ( the newest one is the triggering data )
+		void setBatchDelivery( const bool enabled );
+		bool isBatchDelivery() const;
+
+		// image inlets only: received images are converted to the format on the receiving block's thread,
+		// when they are taken for an update ( convertTriggeringData )
+		void setImageFormat( ImageFormat const& format );
+		void clearImageFormat();
+		bool hasImageFormat() const;
+		// returns the data itself if there's no format or the image has it already
+		TimestampedData applyImageFormat( TimestampedData const& data ) const;
+		// only while triggering is disabled, i.e. right before the block's update
+		void convertTriggeringData();
+		TimestampedDataBatch & getTriggeringBatch();
+
+		// key for data that bypasses the buffer ( frame mode )
+		long nextKey();
 
 		// direct linking is based on basic buffers
 		void receiveData( TimestampedData const& data );
@@ -118,17 +116,49 @@ namespace _2Real
 
 	private:
 
-		unsigned long									m_Counter;
-		DataBuffer										m_ReceivedDataItems;	// holds all received data items
+		typedef RingBuffer< TimestampedData >			DataBuffer;
+
+		void bufferData( TimestampedData const& data );
+		void notifyBufferedData();
+		bool notifyBatch( TimestampedData const& data );
+		bool canAddToBatch() const;
+		void addToBatch( TimestampedData const& data );
+		void blockProducers();
+		void unblockProducers();
+		void leaveProducers();
+		void countOverflow();
+
+		AtomicLong										m_Counter;
+		DataBuffer										*m_ReceivedDataItems;	// holds all received data items
 		TimestampedData									m_TriggeringData;		// holds the data item which first triggered the update condition
+		AtomicLong										m_IsBatchDelivery;
+		TimestampedDataBatch							m_PendingBatch;			// batched delivery: items that did not fulfill the trigger condition yet
+		TimestampedDataBatch							m_TriggeringBatch;		// batched delivery: items delivered with the triggering data
 		CallbackEvent< TimestampedData const& >			m_TriggeringEvent;
-		volatile bool									m_NotifyOnReceive;		// if true: try triggering
+		AtomicLong										m_NotifyOnReceive;		// if != 0: try triggering
 
 		Any												m_InitialValue;
+		TypeDescriptor									const *volatile m_Descriptor;	// type of the initial value, read w/o locking
 		mutable Poco::FastMutex							m_InitialDataAccess;
+		mutable Poco::FastMutex							m_NotificationAccess;	// taken by whoever notifies the triggers, or removes data from the ring
+
+		// senders register as active producers while they write to the ring,
+		// resizing / changing the policy wakes blocked senders & waits until there are none left
 		mutable Poco::FastMutex							m_BufferAccess;
-		mutable Poco::FastMutex							m_NotificationAccess;
-		AbstractInsertionPolicy							*m_InsertionPolicy;
+		AtomicLong										m_ActiveProducers;
+		AtomicLong										m_ProducersBlocked;
+		OverflowPolicy::Policy							m_OverflowPolicy;
+		long											m_MaxBlockingTime;
+		AtomicLong										m_OverflowCount;
+		AtomicLong										*m_DroppedItems;
+		std::string										m_TraceName;
+		Poco::Event										m_SpaceAvailable;
+		Poco::Event										m_ProducersLeft;		// set by the last producer while producers are blocked
+
+		bool											m_IsTriggeringDataConverted;
+		AtomicLong										m_HasImageFormat;
+		ImageFormat										m_ImageFormat;
+		mutable Poco::FastMutex							m_ImageFormatAccess;
 
 	};
 
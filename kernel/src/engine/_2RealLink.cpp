@@ -33,7 +33,7 @@ namespace _2Real
 {
 	IOLink * IOLink::link( BasicInletIO &inlet, OutletIO &outlet )
 	{
-		if ( inlet.info().type.m_LongTypename != outlet.m_Outlet->getLongTypename() )
+		if ( !inlet.info().type.isSameType( outlet.m_Outlet->getTypeDescriptor() ) )
 		{
 			return nullptr;
 		}
@@ -0,0 +1,74 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+
+namespace _2Real
+{
+	// severity of a log record; the engine's logger discards everything above its current level
+	class LogLevel
+	{
+
+	public:
+
+		enum Level
+		{
+			LOG_ERROR		= 0,
+			LOG_WARNING		= 1,
+			LOG_INFO		= 2,
+			LOG_DEBUG		= 3			// per update cycle messages, disabled by default
+		};
+
+		static const std::string getLevelAsString( Level const& l )
+		{
+			if ( l == LOG_ERROR )				return "error";
+			else if ( l == LOG_WARNING )		return "warning";
+			else if ( l == LOG_INFO )			return "info";
+			else								return "debug";
+		}
+
+	};
+
+	// subsystem a log record belongs to, categories can be enabled & disabled independently
+	class LogCategory
+	{
+
+	public:
+
+		enum Category
+		{
+			LOG_ENGINE		= 0x01,
+			LOG_BLOCKS		= 0x02,
+			LOG_SCHEDULER	= 0x04,
+			LOG_TIMER		= 0x08,
+			LOG_ALL			= 0xff
+		};
+
+		static const std::string getCategoryAsString( Category const& c )
+		{
+			if ( c == LOG_ENGINE )				return "engine";
+			else if ( c == LOG_BLOCKS )			return "blocks";
+			else if ( c == LOG_SCHEDULER )		return "scheduler";
+			else if ( c == LOG_TIMER )			return "timer";
+			else								return "all";
+		}
+
+	};
+}
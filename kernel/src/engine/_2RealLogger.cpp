@@ -1,7 +1,6 @@
 /*
 	CADET - Center for Advances in Digital Entertainment Technologies
 	Copyright 2011 Fachhochschule Salzburg GmbH
-
 		http://www.cadet.at
 
 	Licensed under the Apache License, Version 2.0 (the "License");
@@ -20,13 +19,20 @@
 #include "engine/_2RealLogger.h"
 #include "helpers/_2RealException.h"
 
+#include <cstring>
+
 namespace _2Real
 {
-	Logger::Logger( std::string const& logfile ) :
-		m_CurrLines( new LogMessages ),
-		m_WriteLines( new LogMessages ),
-		m_File( logfile ),
-		m_KeepRunning( true ),
+
+	Logger::Logger( std::string const& logfile, const unsigned int capacity ) :
+		m_Records( capacity, Record() ),
+		m_Dropped( 0 ),
+		m_IsWriterIdle( 0 ),
+		m_Level( LogLevel::LOG_INFO ),
+		m_Categories( LogCategory::LOG_ALL ),
+		m_File( logfile.c_str() ),
+		m_KeepRunning( 1 ),
+		m_WakeUp( true ),
 		m_StopEvent( true ),
 		m_StartEvent( true ),
 		m_Time()
@@ -45,42 +51,115 @@ namespace _2Real
 
 	Logger::~Logger()
 	{
+		stop();
 		m_File.close();
+	}
+
+	void Logger::setLevel( const LogLevel::Level level )
+	{
+		m_Level.store( level );
+	}
+
+	LogLevel::Level Logger::getLevel() const
+	{
+		return static_cast< LogLevel::Level >( m_Level.load() );
+	}
+
+	void Logger::setCategories( const unsigned int categories )
+	{
+		m_Categories.store( static_cast< long >( categories ) );
+	}
+
+	unsigned long Logger::getDroppedCount() const
+	{
+		return static_cast< unsigned long >( m_Dropped.load() );
+	}
 
-		delete m_CurrLines;
-		delete m_WriteLines;
+	void Logger::log( const LogLevel::Level level, const LogCategory::Category category, std::string const& message )
+	{
+		tryPush( level, category, message.c_str(), message.length() );
+	}
+
+	void Logger::log( const LogLevel::Level level, const LogCategory::Category category, const char *message )
+	{
+		tryPush( level, category, message, strlen( message ) );
 	}
 
 	void Logger::addLine( std::string const& line )
 	{
-		Poco::ScopedLock< Poco::FastMutex > lock(m_Access);
+		tryPush( LogLevel::LOG_INFO, LogCategory::LOG_ENGINE, line.c_str(), line.length() );
+	}
 
-		m_CurrLines->push_back( std::make_pair( (long)m_Time.elapsed(), line ) );
+	bool Logger::tryPush( const LogLevel::Level level, const LogCategory::Category category, const char *message, const size_t length )
+	{
+		Record record;
+		const size_t count = ( length < MaxMessageLength ? length : MaxMessageLength - 1 );
+		memcpy( record.message, message, count );
+		record.message[ count ] = '\0';
+		record.timestamp = static_cast< long >( m_Time.elapsed() );
+		record.level = level;
+		record.category = category;
+
+		if ( !m_Records.tryPush( record ) )
+		{
+			m_Dropped.increment();
+			return false;
+		}
+
+		// the first record wakes an idle writer, a ring that is filling up ends its batching early
+		if ( m_IsWriterIdle.load() != 0 && m_IsWriterIdle.compareAndSwap( 1, 0 ) )
+		{
+			m_WakeUp.set();
+		}
+		else if ( m_Records.getSize() == ( m_Records.getMaxSize() >> 1 ) )
+		{
+			m_WakeUp.set();
+		}
+
+		return true;
+	}
+
+	// writer thread only
+	void Logger::write( Record const& record )
+	{
+		m_File << record.timestamp << " " << LogLevel::getLevelAsString( record.level ) << " " << LogCategory::getCategoryAsString( record.category ) << " " << record.message << "\n";
 	}
 
 	void Logger::run()
 	{
 		m_StartEvent.set();
 
-		while (1)
+		Record record;
+		while ( true )
 		{
-			m_Access.lock();
-			if ( m_KeepRunning )
+			const bool keepRunning = ( m_KeepRunning.load() != 0 );
+
+			bool wrote = false;
+			while ( m_Records.tryPop( record ) )
 			{
-				std::swap( m_CurrLines, m_WriteLines );
-				m_Access.unlock();
-				for ( LogMessageIterator it = m_WriteLines->begin(); it != m_WriteLines->end(); ++it )
-				{
-					m_File << it->first << " " << it->second << "\n";
-					m_File.flush();
-				}
-				m_WriteLines->clear();
+				write( record );
+				wrote = true;
 			}
-			else
+			if ( wrote ) m_File.flush();
+
+			if ( !keepRunning )
 			{
-				m_Access.unlock();
 				break;
 			}
+
+			// no timeout while there's nothing to write: the flag is set before checking the ring, so a
+			// producer either sees it & wakes us, or pushed early enough for the ring not to be empty
+			m_IsWriterIdle.store( 1 );
+			if ( m_Records.isEmpty() ) m_WakeUp.wait();
+			m_IsWriterIdle.store( 0 );
+
+			if ( m_KeepRunning.load() != 0 ) m_WakeUp.tryWait( FlushInterval );
+		}
+
+		if ( m_Dropped.load() > 0 )
+		{
+			m_File << "logger dropped " << m_Dropped.load() << " records\n";
+			m_File.flush();
 		}
 
 		m_StopEvent.set();
@@ -88,11 +167,12 @@ namespace _2Real
 
 	void Logger::stop()
 	{
+		if ( m_KeepRunning.compareAndSwap( 1, 0 ) )
 		{
-			Poco::ScopedLock< Poco::FastMutex > lock(m_Access);
-			m_KeepRunning = false;
+			m_WakeUp.set();
+			m_StopEvent.wait();
+			m_Thread.join();
 		}
-
-		m_StopEvent.wait();
 	}
-}
\ No newline at end of file
+
+}
@@ -1,7 +1,6 @@
- /*
+/*
 	CADET - Center for Advances in Digital Entertainment Technologies
 	Copyright 2011 Fachhochschule Salzburg GmbH
-
 		http://www.cadet.at
 
 	Licensed under the Apache License, Version 2.0 (the "License");
@@ -19,40 +18,97 @@
 
 #pragma once
 
+#include "engine/_2RealLogLevel.h"
 #include "helpers/_2RealPoco.h"
+#include "helpers/_2RealAtomic.h"
+#include "helpers/_2RealRingBuffer.h"
 
-#include <list>
 #include <fstream>
 
+// compile time kill switch: log statements above this level are removed by the compiler,
+// defining _2REAL_NO_LOGGING removes all of them
+#ifndef _2REAL_LOG_MAX_LEVEL
+	#ifdef _2REAL_NO_LOGGING
+		#define _2REAL_LOG_MAX_LEVEL -1
+	#else
+		#define _2REAL_LOG_MAX_LEVEL _2Real::LogLevel::LOG_DEBUG
+	#endif
+#endif
+
+// the message is only evaluated if level & category are enabled, so disabled statements don't build any strings
+#define _2REAL_LOG( logger, level, category, message )																		\
+	if ( ( level ) > _2REAL_LOG_MAX_LEVEL || !( logger ).isEnabled( level, category ) ) {} else ( logger ).log( level, category, message )
+
 namespace _2Real
 {
+	// producers copy their message into a preallocated record ring ( no locks, no allocations ),
+	// a writer thread drains the ring & flushes the file once per batch; when the ring is full, records are dropped.
+	// an idle writer sleeps until the first record arrives, then waits up to FlushInterval for more to batch them
 	class Logger : public Poco::Runnable
 	{
 
 	public:
 
-		Logger( std::string const& logfile );
+		Logger( std::string const& logfile, const unsigned int capacity = 4096 );
+		// stops the writer, if that didn't happen yet
 		~Logger();
 
 		void run();
-		void addLine( std::string const& line );
+		// writes the pending records & ends the writer thread; may be called more than once
 		void stop();
 
+		bool isEnabled( const LogLevel::Level level, const LogCategory::Category category ) const
+		{
+			return ( level <= m_Level.load() ) && ( ( category & m_Categories.load() ) != 0 );
+		}
+
+		void				setLevel( const LogLevel::Level level );
+		LogLevel::Level		getLevel() const;
+		void				setCategories( const unsigned int categories );		// or'ed LogCategory::Category values
+
+		void				log( const LogLevel::Level level, const LogCategory::Category category, std::string const& message );
+		void				log( const LogLevel::Level level, const LogCategory::Category category, const char *message );
+
+		// unconditional info message, engine category
+		void				addLine( std::string const& line );
+
+		// number of records that were discarded because the ring was full
+		unsigned long		getDroppedCount() const;
+
 	private:
 
-		typedef std::list< std::pair< long, std::string > >					LogMessages;
-		typedef std::list< std::pair< long, std::string > >::iterator		LogMessageIterator;
-		typedef std::list< std::pair< long, std::string > >::const_iterator	LogMessageConstIterator;
+		enum
+		{
+			MaxMessageLength	= 232,
+			FlushInterval		= 50		// ms the writer collects records after the first one arrived
+		};
+
+		struct Record
+		{
+			long					timestamp;
+			LogLevel::Level			level;
+			LogCategory::Category	category;
+			char					message[ MaxMessageLength ];
+		};
+
+		bool tryPush( const LogLevel::Level level, const LogCategory::Category category, const char *message, const size_t length );
+		void write( Record const& record );
+
+		RingBuffer< Record >		m_Records;
+		AtomicLong					m_Dropped;
+		AtomicLong					m_IsWriterIdle;		// set while the writer waits for the first record
+
+		AtomicLong					m_Level;
+		AtomicLong					m_Categories;
 
-		mutable Poco::FastMutex		m_Access;
-		LogMessages					*m_CurrLines;
-		LogMessages					*m_WriteLines;
 		std::ofstream				m_File;
 		Poco::Thread				m_Thread;
-		bool						m_KeepRunning;
+		AtomicLong					m_KeepRunning;
+		Poco::Event					m_WakeUp;
 		Poco::Event					m_StopEvent;
 		Poco::Event					m_StartEvent;
 		Poco::Timestamp				m_Time;
 
 	};
-}
\ No newline at end of file
+
+}
@@ -19,12 +19,26 @@
 #include "engine/_2RealOutlet.h"
 #include "engine/_2RealAbstractUberBlock.h"
 #include "engine/_2RealEngineImpl.h"
+#include "helpers/_2RealAtomic.h"
 
 using std::string;
 using std::ostringstream;
 
 namespace _2Real
 {
+	namespace
+	{
+		// versions are unique across all outlets, b/c an inlet may be relinked to another outlet
+		AtomicLong s_LastVersion;
+
+		long nextVersion()
+		{
+			long version = s_LastVersion.increment();
+			while ( version == 0 ) version = s_LastVersion.increment();		// 0 means untracked; only after a wrap-around
+			return version;
+		}
+	}
+
 	Outlet::Outlet( AbstractUberBlock &owningBlock, string const& name, TypeDescriptor const& type, Any const& emptyData ) :
 		Parameter( type ),
 		NonCopyable< Outlet >(),
@@ -32,22 +46,34 @@ namespace _2Real
 		Handleable< Outlet, bundle::OutletHandle >( *this ),
 		m_Engine( EngineImpl::instance() ),
 		m_OwningUberBlock( owningBlock ),
-		m_DiscardCurrent( false )
+		m_DiscardCurrent( false ),
+		m_IsWritten( false ),
+		m_UpdateCount( 0 )
 	{
-		Parameter::m_Data = TimestampedData( emptyData, 0 );
-		Parameter::m_DataBuffer.cloneAnyFrom( Parameter::m_Data );
+		Parameter::m_Data = TimestampedData( emptyData, 0, -1, nextVersion() );
+		Parameter::m_DataBuffer = Parameter::m_Data;
 	}
 
+	// published values are never modified again: inlets, the app and the outlet itself share them.
+	// after publishing, the writeable data shares its value with the published data as well,
+	// and is only copied once the block actually writes to it ( see getWriteableData ).
+	// the version changes only if the block asked for the writeable data, a value republished
+	// without that keeps its version. this makes hasChanged a compare of two longs - at the price of
+	// reporting a change for values that were written, but happen to equal the previous one
 	bool Outlet::synchronize()
 	{
 		if ( !m_DiscardCurrent )
 		{
-			Parameter::m_DataBuffer = TimestampedData( Parameter::m_DataBuffer.anyValue, m_Engine.getElapsedTime() );
-			// shallow-copy written data into readable data
-			Parameter::synchronize();
-			// deep-copy readable data back into writeable data
-			// this way, outlet always holds the last written value
-			Parameter::m_DataBuffer.cloneAnyFrom( Parameter::m_Data );
+			const long version = m_IsWritten ? nextVersion() : Parameter::m_DataBuffer.version;
+			m_IsWritten = false;
+			Parameter::m_DataBuffer = TimestampedData( Parameter::m_DataBuffer.anyValue, m_Engine.getElapsedTime(), ++m_UpdateCount, version );
+
+			Poco::ScopedLock< Poco::FastMutex > lock( Parameter::m_DataAccess );
+			if ( !Parameter::m_Data.anyValue.sharesValueWith( Parameter::m_DataBuffer.anyValue ) )
+			{
+				m_Spare = Parameter::m_Data.anyValue;
+			}
+			Parameter::m_Data = Parameter::m_DataBuffer;
 			return false;
 		}
 		else
@@ -59,7 +85,23 @@ namespace _2Real
 
 	Any & Outlet::getWriteableData()
 	{
-		return Parameter::m_DataBuffer.anyValue;
+		m_IsWritten = true;
+
+		Any &data = Parameter::m_DataBuffer.anyValue;
+		if ( !data.isUnique() )
+		{
+			// the value is still shared with readers -> copy before writing, so that the outlet
+			// holds the last written value. reuse the spare value if nobody holds on to it anymore
+			if ( m_Spare.isUnique() && m_Spare.copyValueFrom( data ) )
+			{
+				data.swap( m_Spare );
+			}
+			else
+			{
+				data.cloneFrom( data );
+			}
+		}
+		return data;
 	}
 
 	void Outlet::discardCurrentUpdate()
@@ -67,6 +109,11 @@ namespace _2Real
 		m_DiscardCurrent = true;
 	}
 
+	long Outlet::getUpdateKey() const
+	{
+		return m_UpdateCount;
+	}
+
 	AbstractUberBlock & Outlet::getOwningUberBlock()
 	{
 		return m_OwningUberBlock;
@@ -47,17 +47,23 @@ namespace _2Real
 		using Parameter::getData;
 		using Parameter::getType;
 		using Parameter::getTypeCategory;
+		using Parameter::getTypeDescriptor;
 
 		bool			synchronize();
 		Any &			getWriteableData();
 		void			discardCurrentUpdate();
 		AbstractUberBlock & getOwningUberBlock();
+		// key of the data published by the last synchronize, only meaningful to the updating thread
+		long			getUpdateKey() const;
 
 	private:
 
 		EngineImpl				&m_Engine;
 		AbstractUberBlock		&m_OwningUberBlock;
 		bool					m_DiscardCurrent;
+		bool					m_IsWritten;		// getWriteableData was called since the last publish -> the next one gets a new version
+		Any						m_Spare;			// the value published before the current one, recycled once nobody reads it anymore
+		long					m_UpdateCount;		// key of the published data, tells consumers that read it directly whether it's new
 
 	};
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+
+namespace _2Real
+{
+	// what an inlet buffer does when data arrives while it is full
+	class OverflowPolicy
+	{
+
+	public:
+
+		enum Policy
+		{
+			DROP_OLDEST,		// make room by discarding the oldest buffered item
+			DROP_NEWEST,		// discard the received item
+			BLOCK_PRODUCER,		// the sender waits until the receiving block frees a slot ( or the max blocking time elapses, then the item is discarded )
+			INVALID
+		};
+
+		// how long a sender may be blocked by a full buffer, in milliseconds. the receiving block might
+		// never run again ( stopped, or all worker threads are blocked ), so there always is a limit
+		static const long DefaultMaxBlockingTime = 1000;
+
+		OverflowPolicy( Policy const& p, const long maxBlockingTime = DefaultMaxBlockingTime ) : m_Policy( p ), m_MaxBlockingTime( maxBlockingTime ) {}
+		Policy getPolicy() const { return m_Policy; }
+		// only relevant for BLOCK_PRODUCER
+		long getMaxBlockingTime() const { return m_MaxBlockingTime; }
+		bool operator==( OverflowPolicy const& rhs ) const { return m_Policy == rhs.m_Policy && m_MaxBlockingTime == rhs.m_MaxBlockingTime; }
+		bool operator!=( OverflowPolicy const& rhs ) const { return !( *this == rhs ); }
+
+		static const std::string getPolicyAsString( Policy const& p )
+		{
+			if ( p == DROP_OLDEST )				return "drop_oldest";
+			else if ( p == DROP_NEWEST )		return "drop_newest";
+			else if ( p == BLOCK_PRODUCER )		return "block_producer";
+			else								return "invalid";
+		}
+
+		static const Policy getPolicyFromString( std::string const& p )
+		{
+			if ( p == "drop_oldest" )			return DROP_OLDEST;
+			else if ( p == "drop_newest" )		return DROP_NEWEST;
+			else if ( p == "block_producer" )	return BLOCK_PRODUCER;
+			else								return INVALID;
+		}
+
+	private:
+
+		Policy		m_Policy;
+		long		m_MaxBlockingTime;
+
+	};
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include "helpers/_2RealPoco.h"
+#include "helpers/_2RealAtomic.h"
+#include "helpers/_2RealCallback.h"
+#include "helpers/_2RealException.h"
+
+namespace _2Real
+{
+
+	// one ThreadPool::parallelFor call: the caller & the helping workers grab indices until all are taken.
+	// shared by the caller and every helper request, the last one to release it deletes it -
+	// helper requests may well be executed only after the caller has returned
+	class ParallelJob
+	{
+
+	public:
+
+		ParallelJob( const unsigned int count, AbstractCallback< const unsigned int > &body, const long references ) :
+			m_Count( count ),
+			m_Body( &body ),
+			m_Next( 0 ),
+			m_Remaining( count ),
+			m_References( references ),
+			m_Finished( false ),
+			m_HasFailed( 0 ),
+			m_Exception( nullptr )
+		{
+		}
+
+		void work()
+		{
+			while ( true )
+			{
+				const long index = m_Next.increment() - 1;
+				if ( index >= static_cast< long >( m_Count ) ) return;
+
+				try
+				{
+					const unsigned int i = static_cast< unsigned int >( index );
+					m_Body->invoke( i );
+				}
+				catch ( Exception &e )
+				{
+					fail( e );
+				}
+				catch ( std::exception &e )
+				{
+					fail( Exception( e.what() ) );
+				}
+				catch ( ... )
+				{
+					fail( Exception( "unknown exception in parallel for" ) );
+				}
+
+				if ( m_Remaining.decrement() == 0 ) m_Finished.set();
+			}
+		}
+
+		// called by the caller only, after its own work(); rethrows the first exception of any index
+		void wait()
+		{
+			m_Finished.wait();
+			if ( m_Exception != nullptr ) m_Exception->rethrow();
+		}
+
+		void release()
+		{
+			if ( m_References.decrement() == 0 ) delete this;
+		}
+
+	private:
+
+		~ParallelJob()
+		{
+			delete m_Exception;
+		}
+
+		void fail( Exception const& e )
+		{
+			if ( m_HasFailed.compareAndSwap( 0, 1 ) ) m_Exception = e.clone();
+		}
+
+		const unsigned int							m_Count;
+		AbstractCallback< const unsigned int >		*m_Body;		// only valid until the caller returns, i.e. as long as indices are left
+		AtomicLong									m_Next;
+		AtomicLong									m_Remaining;
+		AtomicLong									m_References;
+		Poco::Event									m_Finished;
+		AtomicLong									m_HasFailed;
+		Exception									*m_Exception;	// written before m_Remaining reaches 0, read after
+
+	};
+
+}
@@ -53,6 +53,11 @@ namespace _2Real
 		return m_Descriptor.m_TypeCategory;
 	}
 
+	TypeDescriptor const& Parameter::getTypeDescriptor() const
+	{
+		return m_Descriptor;
+	}
+
 	void Parameter::setData( TimestampedData const& data )
 	{
 		Poco::ScopedLock< Poco::FastMutex > lock( m_DataAccess );
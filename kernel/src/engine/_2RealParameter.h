@@ -39,6 +39,7 @@ namespace _2Real
 		const std::string			getLongTypename() const;
 		Type const&					getType() const;
 		TypeCategory const&			getTypeCategory() const;
+		TypeDescriptor const&		getTypeDescriptor() const;
 
 		void						setData( TimestampedData const& data );
 		void						synchronize();		// syncs data & write data
@@ -28,9 +28,9 @@ namespace _2Real
 	{
 	}
 
+	// descriptors are interned, nothing to delete
 	InletMetadata::~InletMetadata()
 	{
-		delete type;
 	}
 
 	OutletMetadata::OutletMetadata( string const& n, TypeDescriptor const *const t, Any const& i ) :
@@ -40,6 +40,5 @@ namespace _2Real
 
 	OutletMetadata::~OutletMetadata()
 	{
-		delete type;
 	}
 }
\ No newline at end of file
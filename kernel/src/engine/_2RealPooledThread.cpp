@@ -20,113 +20,221 @@
 #include "engine/_2RealPooledThread.h"
 #include "engine/_2RealFunctionBlockStateManager.h"
 #include "engine/_2RealThreadPool.h"
+#include "engine/_2RealTracer.h"
+#include "engine/_2RealParallelJob.h"
+#include "helpers/_2RealBufferPool.h"
+#include "helpers/_2RealHelpers.h"
+#include "helpers/_2RealThreadAffinity.h"
+
+#include <algorithm>
 
 namespace _2Real
 {
 
-	PooledThread::PooledThread( ThreadPool &pool, unsigned int stackSize ) :
-		m_Request( nullptr ),
-		m_IsIdle( true ),
-		m_Thread( "idle thread" ),
-		m_ThreadPool( &pool ),
-		m_TargetReady( true ),
-		m_TargetCompleted( true ),
+	namespace
+	{
+		// heap order: a request with a later deadline is less urgent
+		struct LaterDeadline
+		{
+			bool operator()( ThreadExecRequest const* a, ThreadExecRequest const* b ) const
+			{
+				return a->deadline > b->deadline;
+			}
+		};
+
+		ThreadExecRequest * popMostUrgent( std::vector< ThreadExecRequest * > &queue )
+		{
+			if ( queue.empty() ) return nullptr;
+
+			std::pop_heap( queue.begin(), queue.end(), LaterDeadline() );
+			ThreadExecRequest *req = queue.back();
+			queue.pop_back();
+			return req;
+		}
+
+		// the worker running on this thread, set for the lifetime of PooledThread::run
+		_2REAL_THREAD_LOCAL PooledThread *tl_CurrentThread = nullptr;
+	}
+
+	PooledThread::PooledThread( ThreadPool &pool, const unsigned int index, std::string const& name, unsigned int stackSize ) :
+		m_ThreadPool( pool ),
+		m_Index( index ),
+		m_Name( name ),
+		m_Thread( name ),
+		m_OsPriority( BlockPriority::PRIO_NORMAL ),
+		m_IsStopped( false ),
+		m_WorkAvailable( true ),
 		m_ThreadStarted( true ),
 		m_ThreadStopped( true )
 	{
-		m_Thread.setStackSize(stackSize);
-		m_Thread.start(*this);
+		if ( stackSize > 0 ) m_Thread.setStackSize( stackSize );
+		m_Thread.start( *this );
 		m_ThreadStarted.wait();
 	}
 
-	const bool PooledThread::operator<(PooledThread const& rhs) const
+	PooledThread::~PooledThread()
 	{
-		return m_Thread.id() < rhs.m_Thread.id();
+		Poco::ScopedLock< Poco::FastMutex > lock( m_QueueAccess );
+		for ( RequestIterator it = m_LocalQueue.begin(); it != m_LocalQueue.end(); ++it )
+		{
+			if ( ( *it )->event != nullptr ) ( *it )->event->set();		// never leave a blocking request hanging
+			if ( ( *it )->job != nullptr ) ( *it )->job->release();
+			delete *it;
+		}
+		m_LocalQueue.clear();
 	}
 
-	const bool PooledThread::isIdle() const
+	const bool PooledThread::join()
 	{
-		Poco::ScopedLock< Poco::FastMutex > lock(m_Mutex);
-		return m_IsIdle;
+		m_IsStopped.set();
+		m_WorkAvailable.set();
+		return m_ThreadStopped.tryWait( 500 );
 	}
 
-	const bool PooledThread::join()
+	PooledThread * PooledThread::getCurrent( ThreadPool const& pool )
 	{
-		m_Mutex.lock();
-		if (m_IsIdle)
-		{
-			m_Request = nullptr;
-			m_IsIdle = false;
-			m_TargetCompleted.reset();
-			m_TargetReady.set();
-			m_Mutex.unlock();
-			return m_ThreadStopped.tryWait(500);
-		}
-		else
-		{
-			m_Mutex.unlock();
-			return false;
-		}
+		PooledThread *thread = tl_CurrentThread;
+		return ( thread != nullptr && &thread->m_ThreadPool == &pool ) ? thread : nullptr;
 	}
 
-	void PooledThread::run( Poco::Thread::Priority const& priority, ThreadExecRequest &request )
+	unsigned int PooledThread::getIndex() const
 	{
-		Poco::ScopedLock< Poco::FastMutex > lock( m_Mutex );
+		return m_Index;
+	}
 
-		m_Thread.setName( request.block.getName() );
-		m_Thread.setPriority( priority );
-		m_Request = &request;
+	void PooledThread::pushRequest( ThreadExecRequest &request )
+	{
+		m_QueueAccess.lock();
+		m_LocalQueue.push_back( &request );
+		std::push_heap( m_LocalQueue.begin(), m_LocalQueue.end(), LaterDeadline() );
+		m_QueueAccess.unlock();
 
-		m_TargetReady.set();
+		m_WorkAvailable.set();
 	}
 
-	void PooledThread::reactivate()
+	ThreadExecRequest * PooledThread::popRequest()
 	{
-		Poco::ScopedLock< Poco::FastMutex > lock(m_Mutex);
+		Poco::ScopedLock< Poco::FastMutex > lock( m_QueueAccess );
+		return popMostUrgent( m_LocalQueue );
+	}
 
-		m_IsIdle = false;
-		m_TargetCompleted.reset();
+	ThreadExecRequest * PooledThread::stealRequest()
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_QueueAccess );
+		return popMostUrgent( m_LocalQueue );
 	}
 
-	void PooledThread::run()
+	bool PooledThread::peekDeadline( Timer::Time &deadline ) const
 	{
-		m_ThreadStarted.set();
+		Poco::ScopedLock< Poco::FastMutex > lock( m_QueueAccess );
+		if ( m_LocalQueue.empty() ) return false;
 
-		while (true)
-		{
-			m_TargetReady.wait();
+		deadline = m_LocalQueue.front()->deadline;
+		return true;
+	}
 
-			m_Mutex.lock();
-			if ( m_Request )										// if the request is ever null & targetReady is signalled, the thread will kill itself
-			{
-				m_Mutex.unlock();
+	void PooledThread::wake()
+	{
+		m_WorkAvailable.set();
+	}
 
-				FunctionBlockStateManager &mgr = m_Request->block;
-				FunctionToExecute func = m_Request->function;
-				( mgr.*func )();									// function pointer syntax sucks :/
+	void PooledThread::run()
+	{
+		tl_CurrentThread = this;
+		Tracer::setThreadName( m_Name );
 
-				Poco::ScopedLock< Poco::FastMutex > lock(m_Mutex);
+		CpuSet const& cpus = m_ThreadPool.getCpus();
+		if ( !cpus.empty() && ThreadAffinity::pinCurrentThread( cpus ) )
+		{
+			BufferPool::setThreadNode( m_ThreadPool.getNumaNode() );
+		}
 
-				ThreadExecRequest *tmp = m_Request;
-				m_Request = nullptr;
-				m_IsIdle = true;
+		m_ThreadStarted.set();
 
-				m_TargetCompleted.set();
-				Poco::ThreadLocalStorage::clear();
-				m_Thread.setName( "unused thread" );
-				m_Thread.setPriority( Poco::Thread::PRIO_NORMAL );
+		while ( m_IsStopped.isUnset() )
+		{
+			ThreadExecRequest *req = popRequest();
+			if ( req == nullptr )
+			{
+				req = m_ThreadPool.stealRequest( *this );
+			}
 
-				if ( tmp->event != nullptr ) tmp->event->set();		// maybe i could do this immediately?
-				delete tmp;
+			if ( req == nullptr )
+			{
+				// announce that we're going to sleep, then look once more:
+				// a request scheduled in between either shows up here or wakes us up
+				m_ThreadPool.addIdleThread( *this );
+
+				req = popRequest();
+				if ( req == nullptr )
+				{
+					req = m_ThreadPool.stealRequest( *this );
+				}
+
+				if ( req == nullptr )
+				{
+					m_WorkAvailable.wait();
+				}
+
+				m_ThreadPool.removeIdleThread( *this );
 			}
-			else
+
+			if ( req != nullptr )
 			{
-				m_Mutex.unlock();
-				break;
+				execute( *req );
 			}
 		}
 
+		tl_CurrentThread = nullptr;
 		m_ThreadStopped.set();
 	}
 
+	void PooledThread::execute( ThreadExecRequest &request )
+	{
+		if ( request.job != nullptr )
+		{
+			// runs on behalf of a block that is already updating, so no profiling & no renaming
+			request.job->work();
+			request.job->release();
+			delete &request;
+			return;
+		}
+
+		m_Thread.setName( request.block->getName() );
+		setOsPriority( request.priority );
+
+		FunctionBlockStateManager &mgr = *request.block;
+		mgr.getProfile().recordQueueWait( static_cast< long >( Timer::now() - request.scheduled ) );
+		FunctionToExecute func = request.function;
+		( mgr.*func )();									// function pointer syntax sucks :/
+
+		Poco::ThreadLocalStorage::clear();
+		m_Thread.setName( m_Name );
+
+		if ( request.event != nullptr ) request.event->set();
+		delete &request;
+	}
+
+	void PooledThread::executeNested( ThreadExecRequest &request )
+	{
+		// the outer request keeps thread name, priority & thread local storage
+		FunctionBlockStateManager &mgr = *request.block;
+		FunctionToExecute func = request.function;
+		( mgr.*func )();
+
+		if ( request.event != nullptr ) request.event->set();
+		delete &request;
+	}
+
+	void PooledThread::setOsPriority( const BlockPriority::Priority priority )
+	{
+		// consecutive requests mostly have the same priority, so this rarely costs a system call
+		if ( priority == m_OsPriority ) return;
+
+		if ( priority == BlockPriority::PRIO_HIGH )				m_Thread.setPriority( Poco::Thread::PRIO_HIGH );
+		else if ( priority == BlockPriority::PRIO_LOW )			m_Thread.setPriority( Poco::Thread::PRIO_LOW );
+		else													m_Thread.setPriority( Poco::Thread::PRIO_NORMAL );
+		m_OsPriority = priority;
+	}
+
 }
\ No newline at end of file
@@ -20,48 +20,70 @@
 #pragma once
 
 #include "helpers/_2RealPoco.h"
+#include "helpers/_2RealSynchronizedBool.h"
+#include "engine/_2RealTimer.h"
+#include "engine/_2RealBlockPriority.h"
+
+#include <vector>
+#include <string>
 
 namespace _2Real
 {
 
 	class ThreadPool;
-	class FunctionBlockStateManager;
 	struct ThreadExecRequest;
 
+	// one worker of the thread pool; owns a local queue of requests, ordered earliest deadline first.
+	// the owner pops the most urgent request, idle workers steal the most urgent one as well
 	class PooledThread : public Poco::Runnable
 	{
 	
 	public:
 
-		enum Action
-		{
-			SETUP, UPDATE, SHUTDOWN
-		};
-
-		PooledThread( ThreadPool &pool, unsigned int stackSize = POCO_THREAD_STACK_SIZE );
+		PooledThread( ThreadPool &pool, const unsigned int index, std::string const& name, unsigned int stackSize = POCO_THREAD_STACK_SIZE );
+		~PooledThread();
 
-		const bool isIdle() const;
+		void run();
 		const bool join();
 
-		void run();
-		void run( Poco::Thread::Priority const& priority, ThreadExecRequest &request );
-		void reactivate();
+		void pushRequest( ThreadExecRequest &request );
+		ThreadExecRequest * popRequest();
+		ThreadExecRequest * stealRequest();
+		// deadline of the most urgent request, false if the queue is empty
+		bool peekDeadline( Timer::Time &deadline ) const;
+		void wake();
+		// runs a blocking request on the calling worker, nested in the request it is executing right now
+		void executeNested( ThreadExecRequest &request );
 
-		const bool operator<( PooledThread const& rhs ) const;
+		unsigned int getIndex() const;
+
+		// the worker of pool that runs the calling thread, nullptr if the caller is not one of its workers
+		static PooledThread * getCurrent( ThreadPool const& pool );
 
 	private:
 
-		ThreadExecRequest			*m_Request;
-		volatile bool				m_IsIdle;
+		// binary heap, the request with the earliest deadline on top
+		typedef std::vector< ThreadExecRequest * >							RequestQueue;
+		typedef std::vector< ThreadExecRequest * >::iterator				RequestIterator;
+		typedef std::vector< ThreadExecRequest * >::const_iterator			RequestConstIterator;
+
+		void execute( ThreadExecRequest &request );
+		void setOsPriority( const BlockPriority::Priority priority );
+
+		ThreadPool					&m_ThreadPool;
+		unsigned int				m_Index;
+		std::string					m_Name;
 		Poco::Thread				m_Thread;
 
-		ThreadPool					*m_ThreadPool;
+		RequestQueue				m_LocalQueue;
+		mutable Poco::FastMutex		m_QueueAccess;
+
+		BlockPriority::Priority		m_OsPriority;			// only touched by the worker itself
 
-		Poco::Event					m_TargetReady;
-		Poco::Event					m_TargetCompleted;
+		SynchronizedBool			m_IsStopped;
+		Poco::Event					m_WorkAvailable;
 		Poco::Event					m_ThreadStarted;
 		Poco::Event					m_ThreadStopped;
-		mutable Poco::FastMutex		m_Mutex;
 
 	};
 
@@ -60,7 +60,7 @@ namespace _2Real
 			}
 			else
 			{
-				m_Logger.addLine( string( "failed to shut down ").append( ( *it )->getFullName() ) );
+				_2REAL_LOG( m_Logger, LogLevel::LOG_WARNING, LogCategory::LOG_ENGINE, string( "failed to shut down ").append( ( *it )->getFullName() ) );
 			}
 
 			it = m_BlockInstances.erase( it );
@@ -88,7 +88,7 @@ namespace _2Real
 			}
 			else
 			{
-				m_Logger.addLine( string( "failed to shut down ").append( ( *it )->getFullName() ) );
+				_2REAL_LOG( m_Logger, LogLevel::LOG_WARNING, LogCategory::LOG_ENGINE, string( "failed to shut down ").append( ( *it )->getFullName() ) );
 			}
 
 			it = m_ContextBlocks.erase( it );
@@ -118,7 +118,7 @@ namespace _2Real
 			}
 			else
 			{
-				m_Logger.addLine( string( "failed to shut down ").append( ( *it )->getFullName() ) );
+				_2REAL_LOG( m_Logger, LogLevel::LOG_WARNING, LogCategory::LOG_ENGINE, string( "failed to shut down ").append( ( *it )->getFullName() ) );
 			}
 
 			it = m_BlockInstances.erase( it );
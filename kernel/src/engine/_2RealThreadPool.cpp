@@ -23,6 +23,7 @@
 #include "engine/_2RealEngineImpl.h"
 #include "engine/_2RealTimer.h"
 #include "engine/_2RealLogger.h"
+#include "engine/_2RealParallelJob.h"
 #include "helpers/_2RealCallback.h"
 #include "helpers/_2RealEvent.h"
 
@@ -33,33 +34,42 @@
 namespace _2Real
 {
 
-	ThreadPool::ThreadPool( EngineImpl &engine, const unsigned int capacity, const unsigned int stackSize, std::string const& name ) :
+	ThreadPool::ThreadPool( EngineImpl &engine, const unsigned int capacity, const unsigned int stackSize, std::string const& name, CpuSet const& cpus ) :
 		m_Timer( engine.getTimer() ),
 		m_Logger( engine.getLogger() ),
 		m_Name( name ),
 		m_StackSize( stackSize ),
-		m_Elapsed( 0 )
+		m_Cpus( cpus ),
+		m_NumaNode( ThreadAffinity::getNumaNode( cpus ) ),
+		m_NextThread( 0 ),
+		m_IsMetricsLoggingEnabled( 0 )
 	{
 		AbstractCallback< long > *callback = new MemberCallback< ThreadPool, long >( *this, &ThreadPool::update );
-		m_Timer.registerToTimerSignal( *callback );
+		m_Timer.registerToTimerSignal( *callback, UpdateInterval );
 
-		for ( unsigned int i=0; i<capacity; ++i )
+		unsigned int numThreads = capacity;
+		if ( numThreads == 0 && !m_Cpus.empty() )
 		{
-			PooledThread *thread = new PooledThread( *this, m_StackSize );
-			ThreadQueue q;
-			q.isReserved = false;
-			q.isUnique = false;
-			m_Threads[ thread ] = q;
+			numThreads = static_cast< unsigned int >( m_Cpus.size() );
+		}
+		else if ( numThreads == 0 )
+		{
+			numThreads = std::max< unsigned int >( Poco::Environment::processorCount(), 1 );
 		}
 
-		for ( unsigned int i=0; i<capacity; ++i )
+		m_Threads.reserve( numThreads );
+		m_IdleThreads.reserve( numThreads );
+		for ( unsigned int i=0; i<numThreads; ++i )
 		{
-			PooledThread *thread = new PooledThread( *this, m_StackSize );
-			ThreadQueue q;
-			q.isReserved = true;
-			q.isUnique = false;
-			m_Threads[ thread ] = q;
+			std::ostringstream threadName;
+			threadName << m_Name << " worker " << i;
+			m_Threads.push_back( new PooledThread( *this, i, threadName.str(), m_StackSize ) );
 		}
+
+		std::ostringstream msg;
+		msg << m_Name << ": started " << numThreads << " worker threads";
+		if ( !m_Cpus.empty() ) msg << ", pinned to " << m_Cpus.size() << " cpus on numa node " << m_NumaNode;
+		_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_SCHEDULER, msg.str() );
 	}
 
 	ThreadPool::~ThreadPool()
@@ -67,130 +77,221 @@ namespace _2Real
 		AbstractCallback< long > *callback = new MemberCallback< ThreadPool, long >( *this, &ThreadPool::update );
 		m_Timer.unregisterFromTimerSignal( *callback );
 
-		m_ThreadQueuesAccess.lock();
-		for ( ThreadQueueIterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+		m_IdleThreadsAccess.lock();
+		m_IdleThreads.clear();
+		m_IdleThreadsAccess.unlock();
+
+		for ( ThreadIterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
 		{
-			if ( ( it->first )->join() )
+			if ( ( *it )->join() )
 			{
-				delete it->first;
+				delete *it;
 			}
 		}
-		m_ThreadQueuesAccess.unlock();
+		m_Threads.clear();
+	}
 
-		m_RequestQueueAccess.lock();
-		for ( RequestIterator it = m_RequestQueue.begin(); it != m_RequestQueue.end(); ++it )
+	// called by the timer every UpdateInterval
+	void ThreadPool::update( long &missed )
+	{
+		if ( !m_IsMetricsLoggingEnabled.load() ) return;
+
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BlocksAccess );
+		for ( BlockIterator it = m_Blocks.begin(); it != m_Blocks.end(); ++it )
 		{
-			delete *it;
+			app::BlockMetrics m;
+			( *it )->getMetrics( m );
+
+			std::ostringstream msg;
+			msg << ( *it )->getName() << ": " << m.updates << " updates, " << m.updatesPerSecond << " / s"
+				<< " | update avg " << m.averageUpdateTime << " max " << m.maxUpdateTime
+				<< " | queue avg " << m.averageQueueWait << " max " << m.maxQueueWait
+				<< " | trigger latency avg " << m.averageTriggerLatency << " max " << m.maxTriggerLatency
+				<< " | publish avg " << m.averagePublishTime << " max " << m.maxPublishTime
+				<< " ( us ) | dropped " << m.droppedInletItems << " | skipped deadlines " << m.skippedDeadlines;
+			_2REAL_LOG( m_Logger, LogLevel::LOG_INFO, LogCategory::LOG_SCHEDULER, msg.str() );
 		}
-		m_RequestQueueAccess.unlock();
 	}
 
-	void ThreadPool::update(long &time)
+	void ThreadPool::registerBlock( FunctionBlockStateManager &block )
 	{
-		m_Elapsed += time;
-		if ( m_Elapsed >= 5000000 )
-		{
-		//	m_FinishedAccess.lock();
-		//	size_t finished = m_FinishedBuffer.size();
-		//	size_t received = m_FinishedBlocks.size();
-		//	m_FinishedAccess.unlock();
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BlocksAccess );
+		m_Blocks.push_back( &block );
+	}
 
-		//	m_ReadyAccess.lock();
-		//	size_t ready = m_ReadyBlocks.size();
-		//	m_ReadyAccess.unlock();
+	void ThreadPool::unregisterBlock( FunctionBlockStateManager &block )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BlocksAccess );
+		BlockIterator it = std::find( m_Blocks.begin(), m_Blocks.end(), &block );
+		if ( it != m_Blocks.end() ) m_Blocks.erase( it );
+	}
 
-		//	m_ExecutingAccess.lock();
-		//	size_t executing = m_ExecutingBlocks.size();
-		//	m_ExecutingAccess.unlock();
+	unsigned int ThreadPool::getNumberOfBlocks() const
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_BlocksAccess );
+		return static_cast< unsigned int >( m_Blocks.size() );
+	}
 
-		//	m_AbortedAccess.lock();
-		//	size_t aborted = m_AbortedBlocks.size();
-		//	m_AbortedAccess.unlock();
+	void ThreadPool::setMetricsLogging( const bool enabled )
+	{
+		m_IsMetricsLoggingEnabled.store( enabled ? 1 : 0 );
+	}
+
+	bool ThreadPool::isMetricsLoggingEnabled() const
+	{
+		return ( m_IsMetricsLoggingEnabled.load() != 0 );
+	}
 
-		//	size_t reallyRunning = executing - received - finished;
+	unsigned int ThreadPool::getNumberOfThreads() const
+	{
+		return static_cast< unsigned int >( m_Threads.size() );
+	}
 
-		//	std::ostringstream msg;
-		//	msg << std::endl;
-		//	msg << "-------------------------------------------------------------------------\n";
-		//	msg << "THREADPOOL: ready: " << ready << std::endl;
-		//	msg << "THREADPOOL: executing: " << reallyRunning << std::endl;
-		//	msg << "THREADPOOL: aborted: " << aborted << std::endl;
-		//	msg << "-------------------------------------------------------------------------";
-		//	m_Logger.addLine( msg.str() );
+	std::string const& ThreadPool::getName() const
+	{
+		return m_Name;
+	}
 
-			m_Elapsed = 0;
-		}
+	CpuSet const& ThreadPool::getCpus() const
+	{
+		return m_Cpus;
+	}
 
-		executeCleanUp();
+	unsigned int ThreadPool::getNumaNode() const
+	{
+		return m_NumaNode;
 	}
 
-	void ThreadPool::executeCleanUp()
+	PooledThread * ThreadPool::getCurrentThread() const
 	{
-		m_ThreadQueuesAccess.lock();
+		return PooledThread::getCurrent( *this );
+	}
 
-		for ( ThreadQueueIterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+	void ThreadPool::scheduleRequest( ThreadExecRequest &request )
+	{
+		request.scheduled = Timer::now();
+		if ( request.block != nullptr )
 		{
-			if ( ( it->first )->isIdle() )
-			{
-				if ( it->second.isUnique )
-				{
-					if ( !it->second.localQueue.empty() )
-					{
-						ThreadExecRequest *req = it->second.localQueue.front();
-						it->second.localQueue.pop_front();
-						it->first->reactivate();
-						it->first->run( Poco::Thread::PRIO_NORMAL, *req );
-					}
-				}
-				//else if ( it->second.isReserved && !it->second.localQueue.empty() )		// if reserved, favor own queue.. else, use common requests
-				//{
-				//	std::cout << "free reserved thread!" << std::endl;
-				//}
-				//else
-				//{
-				//	m_RequestQueueAccess.lock();
-				//	if ( m_RequestQueue.empty() )
-				//	{
-				//		m_RequestQueueAccess.unlock();
-				//		continue;															// thread queue acc. is unlocked outside of while loop
-				//	}
-				//	else
-				//	{
-				//		ThreadExecRequest *req = m_RequestQueue.front();
-				//		m_RequestQueue.pop_front();
-				//		m_RequestQueueAccess.unlock();
-
-				//		it->first->reactivate();
-				//		it->first->run( Poco::Thread::PRIO_NORMAL, *req );
-				//	}
-				//}
-			}
+			request.deadline = request.scheduled + request.block->getDeadline();
+			request.priority = request.block->getPriority();
+		}
+		else
+		{
+			request.deadline = request.scheduled;		// someone is waiting for a parallel job right now
+		}
+
+		PooledThread *thread = getCurrentThread();
+		if ( thread != nullptr && request.event != nullptr )
+		{
+			// a blocking request from a worker ( e.g. a block setting up another one ): queued, it would
+			// wait behind the very request the worker is stuck in, so it runs right here instead
+			thread->executeNested( request );
+			return;
+		}
+		else if ( thread == nullptr )
+		{
+			unsigned int index = m_NextThread++;
+			thread = m_Threads[ index % m_Threads.size() ];
 		}
-		m_ThreadQueuesAccess.unlock();
+
+		thread->pushRequest( request );
+		wakeIdleThread( *thread );
 	}
 
-	void ThreadPool::scheduleRequest( ThreadExecRequest &request, PooledThread *thread )
+	void ThreadPool::parallelFor( const unsigned int count, AbstractCallback< const unsigned int > &body )
 	{
-		if ( thread == nullptr )
+		// never ask for more helpers than there are idle workers: busy ones would only pick
+		// up their helper request after the caller has done all the work anyway
+		unsigned int helpers = 0;
+		if ( count > 1 )
 		{
-			Poco::ScopedLock< Poco::FastMutex > lock( m_RequestQueueAccess );
-			m_RequestQueue.push_back( &request );
+			Poco::ScopedLock< Poco::FastMutex > lock( m_IdleThreadsAccess );
+			helpers = std::min< unsigned int >( count - 1, static_cast< unsigned int >( m_IdleThreads.size() ) );
 		}
-		else
+
+		if ( helpers == 0 )
+		{
+			for ( unsigned int i=0; i<count; ++i ) body.invoke( i );
+			return;
+		}
+
+		ParallelJob *job = new ParallelJob( count, body, helpers + 1 );
+		for ( unsigned int i=0; i<helpers; ++i )
+		{
+			scheduleRequest( *new ThreadExecRequest( *job ) );
+		}
+
+		job->work();
+		try
+		{
+			job->wait();
+		}
+		catch ( ... )
+		{
+			job->release();
+			throw;
+		}
+		job->release();
+	}
+
+	void ThreadPool::wakeIdleThread( PooledThread &target )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_IdleThreadsAccess );
+
+		if ( m_IdleThreads.empty() ) return;
+
+		// the target was woken up by pushRequest already, only if it is busy someone else needs to steal
+		ThreadIterator it = std::find( m_IdleThreads.begin(), m_IdleThreads.end(), &target );
+		if ( it == m_IdleThreads.end() )
 		{
-			Poco::ScopedLock< Poco::FastMutex > lock( m_ThreadQueuesAccess );
-			ThreadQueueIterator it = m_Threads.find( thread );
-			it->second.localQueue.push_back( &request );
+			it = m_IdleThreads.end() - 1;
+			( *it )->wake();
 		}
+		m_IdleThreads.erase( it );
+	}
+
+	void ThreadPool::addIdleThread( PooledThread &thread )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_IdleThreadsAccess );
+		m_IdleThreads.push_back( &thread );
+	}
+
+	void ThreadPool::removeIdleThread( PooledThread &thread )
+	{
+		Poco::ScopedLock< Poco::FastMutex > lock( m_IdleThreadsAccess );
+		ThreadIterator it = std::find( m_IdleThreads.begin(), m_IdleThreads.end(), &thread );
+		if ( it != m_IdleThreads.end() ) m_IdleThreads.erase( it );
 	}
 
-	PooledThread * ThreadPool::requestUniqueThread()
+	ThreadExecRequest * ThreadPool::stealRequest( PooledThread const& thief )
 	{
-		PooledThread *thread = new PooledThread( *this, m_StackSize );
-		ThreadQueue q;
-		q.isReserved = false;
-		q.isUnique = true;
-		m_Threads[ thread ] = q;
-		return thread;
+		// first go for the most urgent request of all other workers
+		const size_t numThreads = m_Threads.size();
+		PooledThread *mostUrgent = nullptr;
+		Timer::Time earliest = 0;
+		for ( size_t i=1; i<numThreads; ++i )
+		{
+			PooledThread *victim = m_Threads[ ( thief.getIndex() + i ) % numThreads ];
+			Timer::Time deadline;
+			if ( victim->peekDeadline( deadline ) && ( mostUrgent == nullptr || deadline < earliest ) )
+			{
+				mostUrgent = victim;
+				earliest = deadline;
+			}
+		}
+
+		if ( mostUrgent == nullptr ) return nullptr;
+
+		ThreadExecRequest *req = mostUrgent->stealRequest();
+		if ( req != nullptr ) return req;
+
+		// someone else was faster; start with the thief's neighbour, so that not all idle workers hammer the same queue
+		for ( size_t i=1; i<numThreads; ++i )
+		{
+			PooledThread *victim = m_Threads[ ( thief.getIndex() + i ) % numThreads ];
+			ThreadExecRequest *req = victim->stealRequest();
+			if ( req != nullptr ) return req;
+		}
+		return nullptr;
 	}
 }
\ No newline at end of file
@@ -20,69 +20,100 @@
 #pragma once
 
 #include "helpers/_2RealPoco.h"
+#include "helpers/_2RealAtomic.h"
+#include "helpers/_2RealThreadAffinity.h"
+#include "helpers/_2RealParallelFor.h"
 
-#include <list>
-#include <set>
 #include <string>
-#include <deque>
-#include <map>
+#include <vector>
 
 namespace _2Real
 {
 
 	class EngineImpl;
 	class PooledThread;
-	class FunctionBlockStateManager;
 	class Timer;
 	class Logger;
 
 	struct ThreadExecRequest;
+	class FunctionBlockStateManager;
 
-	class ThreadPool
+	// work stealing executor: a fixed number of workers, each with its own request queue.
+	// requests scheduled from a worker go to that worker's queue, requests from any other
+	// thread are distributed round robin; idle workers steal the most urgent request of the others.
+	// every queue is ordered earliest deadline first, the deadline given by the block's BlockPriority.
+	// running updates are never preempted - under saturation, a long update only delays the requests
+	// queued behind it on the same worker, and the other workers steal those in deadline order
+	// workers that find nothing to steal go to sleep, scheduling a request wakes one of them up
+	// the pool itself does not serialize requests per block - a block never has more than one
+	// request in flight, because the state manager disables triggering until its update has finished,
+	// and setup / singlestep / shutdown are blocking requests issued while the block is not updating.
+	// a blocking request scheduled from a worker is executed right away by that worker, since the
+	// worker would otherwise wait for a request queued behind the one it's executing.
+	// the workers of a pool with a cpu set are pinned to those cpus ( all of them, the os balances within the set );
+	// if the set lies on one numa node, they also allocate pooled buffers from that node, see BufferPool
+	// parallelFor spreads a loop over the caller & the currently idle workers, helper requests are the most urgent of all
+	class ThreadPool : public AbstractParallelExecutor
 	{
 
 	public:
 
-		ThreadPool( EngineImpl &engine, const unsigned int capacity, const unsigned int stackSize, std::string const& name );
+		// capacity 0 -> one worker per cpu in the set, or per hardware thread if the set is empty ( no pinning )
+		ThreadPool( EngineImpl &engine, const unsigned int capacity, const unsigned int stackSize, std::string const& name, CpuSet const& cpus = CpuSet() );
 		~ThreadPool();
 
-		PooledThread * requestUniqueThread();
-
 		void update( long &time );
-		void scheduleRequest( ThreadExecRequest &request, PooledThread *thread );
-		void executeCleanUp();
+		void scheduleRequest( ThreadExecRequest &request );
+		ThreadExecRequest * stealRequest( PooledThread const& thief );
+		void parallelFor( const unsigned int count, AbstractCallback< const unsigned int > &body );
+
+		// called by workers before / after they go to sleep
+		void addIdleThread( PooledThread &thread );
+		void removeIdleThread( PooledThread &thread );
+
+		unsigned int getNumberOfThreads() const;
+		std::string const& getName() const;
+		CpuSet const& getCpus() const;
+		unsigned int getNumaNode() const;
+
+		// blocks whose metrics are written to the log every UpdateInterval, if enabled
+		void registerBlock( FunctionBlockStateManager &block );
+		void unregisterBlock( FunctionBlockStateManager &block );
+		unsigned int getNumberOfBlocks() const;
+		void setMetricsLogging( const bool enabled );
+		bool isMetricsLoggingEnabled() const;
 
 	private:
 
+		typedef std::vector< PooledThread * >								Threads;
+		typedef std::vector< PooledThread * >::iterator						ThreadIterator;
+		typedef std::vector< PooledThread * >::const_iterator				ThreadConstIterator;
 
-		typedef std::deque< ThreadExecRequest * >							RequestQueue;
-		typedef std::deque< ThreadExecRequest * >::iterator					RequestIterator;
-		typedef std::deque< ThreadExecRequest * >::const_iterator			RequestConstIterator;
+		typedef std::vector< FunctionBlockStateManager * >					Blocks;
+		typedef std::vector< FunctionBlockStateManager * >::iterator		BlockIterator;
 
-		struct ThreadQueue
-		{
-			RequestQueue		localQueue;
-			bool				isReserved;
-			bool				isUnique;
-		};
+		enum { UpdateInterval = 5000000 };		// us
 
-		typedef std::map< PooledThread *, ThreadQueue >						ThreadQueues;
-		typedef std::map< PooledThread *, ThreadQueue >::iterator			ThreadQueueIterator;
-		typedef std::map< PooledThread *, ThreadQueue >::const_iterator		ThreadQueueConstIterator;
+		PooledThread * getCurrentThread() const;
+		void wakeIdleThread( PooledThread &target );
 
 		Timer								&m_Timer;
 		Logger								&m_Logger;
 
 		std::string							m_Name;
 		unsigned int						m_StackSize;
+		CpuSet								m_Cpus;
+		unsigned int						m_NumaNode;
 
-		ThreadQueues						m_Threads;
-		RequestQueue						m_RequestQueue;
+		Threads								m_Threads;
+		volatile unsigned int				m_NextThread;			// round robin hint for requests from outside the pool, races are harmless
 
-		mutable Poco::FastMutex				m_ThreadQueuesAccess;
-		mutable Poco::FastMutex				m_RequestQueueAccess;
+		Threads								m_IdleThreads;
+		mutable Poco::FastMutex				m_IdleThreadsAccess;
 
-		long								m_Elapsed;
+		Blocks								m_Blocks;
+		mutable Poco::FastMutex				m_BlocksAccess;
+		AtomicLong							m_IsMetricsLoggingEnabled;
 
 	};
 
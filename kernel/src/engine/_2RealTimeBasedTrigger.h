@@ -32,15 +32,15 @@ namespace _2Real
 
 	public:
 
-		TimeBasedTrigger( AbstractStateManager &mgr, const long timeslice ) :
+		// skipped counts the deadlines that passed without triggering an update
+		TimeBasedTrigger( AbstractStateManager &mgr, const long timeslice, AtomicLong &skipped ) :
 			m_Condition( false ),
 			m_UpdateManager( mgr ),
-			m_DesiredTime( timeslice ),
-			m_ElapsedTime( 0 )
+			m_SkippedDeadlines( skipped )
 		{
-			AbstractCallback< long > *cb = new MemberCallback< TimeBasedTrigger, long >( *this, &TimeBasedTrigger::tryTriggerUpdate );
-			EngineImpl::instance().getTimer().registerToTimerSignal( *cb );
 			m_UpdateManager.addTrigger( *this );
+			AbstractCallback< long > *cb = new MemberCallback< TimeBasedTrigger, long >( *this, &TimeBasedTrigger::tryTriggerUpdate );
+			EngineImpl::instance().getTimer().registerToTimerSignal( *cb, timeslice );
 		}
 
 		~TimeBasedTrigger()
@@ -50,31 +50,31 @@ namespace _2Real
 			m_UpdateManager.removeTrigger( *this );
 		}
 
-		void tryTriggerUpdate( long &time )
+		// called by the timer at each deadline; missed is the number of deadlines the timer itself was too late for
+		void tryTriggerUpdate( long &missed )
 		{
-			m_ElapsedTime += time;
-			if ( !m_Condition.isFulfilled() && m_ElapsedTime >= m_DesiredTime )
+			if ( missed > 0 ) m_SkippedDeadlines.add( missed );
+
+			if ( m_Condition.tryFulfill() )
 			{
-				m_ElapsedTime = 0;
-				m_Condition.set( true );
 				m_UpdateManager.tryTriggerTime( *this );
 			}
-		}
-
-		void resetTime()
-		{
-			m_ElapsedTime = 0;
+			else
+			{
+				// the previous deadline was not consumed yet: the block is still updating, or waiting for its inlets
+				m_SkippedDeadlines.increment();
+			}
 		}
 
 		bool isFulfilled() const { return m_Condition.isFulfilled(); }
-		void set( const bool fulfilled ) { m_Condition.set( fulfilled ); }
+		bool tryReset() { return m_Condition.tryReset(); }
+		bool detach() { return m_Condition.detach(); }
 
 	private:
 
 		AbstractStateManager	&m_UpdateManager;
 		UpdateCondition			m_Condition;
-		long					m_DesiredTime;
-		long					m_ElapsedTime;
+		AtomicLong				&m_SkippedDeadlines;
 
 	};
 
@@ -1,7 +1,6 @@
 /*
 	CADET - Center for Advances in Digital Entertainment Technologies
 	Copyright 2011 Fachhochschule Salzburg GmbH
-
 		http://www.cadet.at
 
 	Licensed under the Apache License, Version 2.0 (the "License");
@@ -19,63 +18,272 @@
 
 #include "engine/_2RealTimer.h"
 #include "engine/_2RealLogger.h"
+#include "engine/_2RealTracer.h"
 
+#include <algorithm>
+#include <functional>
 #include <sstream>
 
+#ifdef _2REAL_WINDOWS
+	#include <windows.h>
+	#include <mmsystem.h>
+#else
+	#include <time.h>
+	#include <errno.h>
+#endif
+
 namespace _2Real
 {
+
+	// below this, the timer thread does not wait on its event anymore but sleeps precisely
+	static const Timer::Time PreciseSleepThreshold = 2000;
+
 	Timer::Timer( Logger &logger ) :
-		m_Callback( nullptr ),
-		m_Timer( 0, 1 ),				//attempt to get the best resolution possible, even if this won't work in practice
 		m_Logger( logger ),
+		m_KeepRunning( 1 ),
+		m_WakeUp( true ),
+		m_IsInvoking( false ),
+		m_InvokeDone( false ),
+		m_WaitableTimer( nullptr ),
 		m_UpdateCount( 0 ),
 		m_SkippedCount( 0 ),
-		m_DebugTime()
+		m_DebugTime( now() )
 	{
-		m_Callback = new Poco::TimerCallback< Timer >( *this, &Timer::receiveTimerSignal );
-		m_Timer.start( *m_Callback, Poco::Thread::PRIO_HIGHEST );
+		m_InvokeDone.set();
+
+#ifdef _2REAL_WINDOWS
+		// waitable timers & sleep have the resolution of the system timer, which is ~15 ms by default
+		timeBeginPeriod( 1 );
+		m_WaitableTimer = CreateWaitableTimer( nullptr, TRUE, nullptr );
+#endif
+
+		m_Thread.setName( "2real timer" );
+		m_Thread.setPriority( Poco::Thread::PRIO_HIGHEST );
+		m_Thread.start( *this );
 	}
 
 	Timer::~Timer()
 	{
-		m_Timer.stop();
-		delete m_Callback;
+		m_KeepRunning.store( 0 );
+		m_WakeUp.set();
+		m_Thread.join();
+
+		for ( DeadlineIterator it = m_Deadlines.begin(); it != m_Deadlines.end(); ++it )
+		{
+			delete it->callback;
+		}
+
+#ifdef _2REAL_WINDOWS
+		if ( m_WaitableTimer != nullptr ) CloseHandle( m_WaitableTimer );
+		timeEndPeriod( 1 );
+#endif
 	}
 
-	void Timer::receiveTimerSignal( Poco::Timer &t )
+	Timer::Time Timer::now()
 	{
-		Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
+#ifdef _2REAL_WINDOWS
+		static LARGE_INTEGER frequency = { 0 };
+		if ( frequency.QuadPart == 0 ) QueryPerformanceFrequency( &frequency );
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter( &counter );
+		return static_cast< Time >( ( counter.QuadPart / frequency.QuadPart ) * 1000000 + ( counter.QuadPart % frequency.QuadPart ) * 1000000 / frequency.QuadPart );
+#else
+		timespec ts;
+		clock_gettime( CLOCK_MONOTONIC, &ts );
+		return static_cast< Time >( ts.tv_sec ) * 1000000 + ts.tv_nsec / 1000;
+#endif
+	}
+
+	// m_Access must not be locked
+	void Timer::sleepUntil( const Time deadline )
+	{
+#ifdef _2REAL_WINDOWS
+		// relative, in units of 100 ns; precise to the 1 ms system timer period set in the ctor
+		const Time remaining = deadline - now();
+		if ( remaining <= 0 ) return;
+		if ( m_WaitableTimer == nullptr )
+		{
+			Sleep( static_cast< DWORD >( ( remaining + 999 ) / 1000 ) );
+			return;
+		}
+		LARGE_INTEGER due;
+		due.QuadPart = -remaining * 10;
+		if ( SetWaitableTimer( m_WaitableTimer, &due, 0, nullptr, nullptr, FALSE ) )
+		{
+			WaitForSingleObject( m_WaitableTimer, INFINITE );
+		}
+#else
+		timespec ts;
+		ts.tv_sec = static_cast< time_t >( deadline / 1000000 );
+		ts.tv_nsec = static_cast< long >( ( deadline % 1000000 ) * 1000 );
+		while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr ) == EINTR ) {}
+#endif
+	}
+
+	void Timer::run()
+	{
+		Tracer::setThreadName( "2Real timer" );
+		m_Access.lock();
+
+		while ( m_KeepRunning.load() )
+		{
+			if ( m_Deadlines.empty() )
+			{
+				m_Access.unlock();
+				m_WakeUp.tryWait( 100 );
+				m_Access.lock();
+				continue;
+			}
+
+			const Time due = m_Deadlines.front().due;
+			Time current = now();
+			if ( due > current )
+			{
+				m_Access.unlock();
+				if ( due - current > PreciseSleepThreshold )
+				{
+					m_WakeUp.tryWait( static_cast< long >( ( due - current - PreciseSleepThreshold / 2 ) / 1000 ) );
+				}
+				else
+				{
+					sleepUntil( due );
+				}
+				m_Access.lock();
+				continue;
+			}
+
+			invokeDue( current );
+
+			if ( ( m_UpdateCount + m_SkippedCount ) >= 20000 )
+			{
+				if ( m_Logger.isEnabled( LogLevel::LOG_DEBUG, LogCategory::LOG_TIMER ) )
+				{
+					std::ostringstream msg;
+					msg << "TIMER: invoked " << m_UpdateCount << " callbacks, skipped " << m_SkippedCount << " deadlines, elapsed: " << ( current - m_DebugTime );
+					_2REAL_LOG( m_Logger, LogLevel::LOG_DEBUG, LogCategory::LOG_TIMER, msg.str() );
+				}
+
+				m_UpdateCount = 0;
+				m_SkippedCount = 0;
+				m_DebugTime = current;
+			}
+		}
+
+		m_Access.unlock();
+	}
+
+	// m_Access must be locked; it is unlocked while the callbacks run
+	void Timer::invokeDue( const Time current )
+	{
+		while ( !m_Deadlines.empty() && m_Deadlines.front().due <= current )
+		{
+			std::pop_heap( m_Deadlines.begin(), m_Deadlines.end(), std::greater< Deadline >() );
+			Deadline d = m_Deadlines.back();
+			m_Deadlines.pop_back();
 
-		long elapsed = ( long )m_Timestamp.elapsed();
-		m_TimerSignal.notify( elapsed );
-		m_Timestamp.update();
+			// the next deadline is always a multiple of the period after the previous one
+			d.missed = static_cast< long >( ( current - d.due ) / d.period );
+			d.due += ( d.missed + 1 ) * d.period;
+			m_Invoked.push_back( d );
+		}
+
+		m_IsInvoking = true;
+		m_InvokeDone.reset();
+		m_Access.unlock();
 
-		m_UpdateCount++;
-		m_SkippedCount += t.skipped();
-		if ( ( m_UpdateCount + m_SkippedCount ) >= 20000 )
+		// entries are only flagged as removed meanwhile, so indices stay valid
+		for ( size_t i=0; i<m_Invoked.size(); ++i )
 		{
-			std::ostringstream msg;
-			msg << std::endl;
-			msg << "-------------------------------------------------------------------------\n";
-			msg << "TIMER: updated " << m_UpdateCount << " times" << std::endl;
-			msg << "TIMER: skipped " << m_SkippedCount << " times" << std::endl;
-			msg << "TIMER: elapsed: " << m_DebugTime.elapsed() << std::endl;
-			msg << "-------------------------------------------------------------------------";
-			m_Logger.addLine( msg.str() );
-
-			m_UpdateCount = 0;
-			m_SkippedCount = 0;
-			m_DebugTime.update();
+			m_Access.lock();
+			const bool isRemoved = m_Invoked[ i ].isRemoved;
+			AbstractCallback< long > *callback = m_Invoked[ i ].callback;
+			long missed = m_Invoked[ i ].missed;
+			m_Access.unlock();
+
+			if ( !isRemoved ) callback->invoke( missed );
 		}
+
+		m_Access.lock();
+		for ( DeadlineIterator it = m_Invoked.begin(); it != m_Invoked.end(); ++it )
+		{
+			if ( it->isRemoved )
+			{
+				delete it->callback;
+				continue;
+			}
+
+			++m_UpdateCount;
+			m_SkippedCount += it->missed;
+			m_Deadlines.push_back( *it );
+			std::push_heap( m_Deadlines.begin(), m_Deadlines.end(), std::greater< Deadline >() );
+		}
+		m_Invoked.clear();
+		m_IsInvoking = false;
+		m_InvokeDone.set();
 	}
 
-	void Timer::registerToTimerSignal( AbstractCallback< long > &callback )
+	Timer::DeadlineIterator Timer::find( Deadlines &deadlines, AbstractCallback< long > &callback )
 	{
-		m_TimerSignal.addListener( callback );
+		for ( DeadlineIterator it = deadlines.begin(); it != deadlines.end(); ++it )
+		{
+			if ( it->isRemoved ) continue;
+			if ( !( *it->callback < callback ) && !( callback < *it->callback ) ) return it;
+		}
+		return deadlines.end();
+	}
+
+	void Timer::registerToTimerSignal( AbstractCallback< long > &callback, const long period )
+	{
+		const Time p = std::max< Time >( period, 1 );
+
+		Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
+		DeadlineIterator it = find( m_Deadlines, callback );
+		if ( it != m_Deadlines.end() )
+		{
+			delete it->callback;
+			m_Deadlines.erase( it );
+		}
+
+		// being invoked right now: replaced once it returns
+		it = find( m_Invoked, callback );
+		if ( it != m_Invoked.end() ) it->isRemoved = true;
+
+		m_Deadlines.push_back( Deadline( &callback, p, now() + p ) );
+		std::make_heap( m_Deadlines.begin(), m_Deadlines.end(), std::greater< Deadline >() );
+
+		// the new deadline might be earlier than the one the timer is waiting for
+		m_WakeUp.set();
 	}
 
 	void Timer::unregisterFromTimerSignal( AbstractCallback< long > &callback )
 	{
-		m_TimerSignal.removeListener( callback );
+		m_Access.lock();
+		DeadlineIterator it = find( m_Deadlines, callback );
+		if ( it != m_Deadlines.end() )
+		{
+			delete it->callback;
+			m_Deadlines.erase( it );
+			std::make_heap( m_Deadlines.begin(), m_Deadlines.end(), std::greater< Deadline >() );
+		}
+
+		// being invoked right now: the timer thread deletes it. unless this is called by one of
+		// the callbacks, wait until they returned
+		it = find( m_Invoked, callback );
+		if ( it != m_Invoked.end() )
+		{
+			it->isRemoved = true;
+			if ( Poco::Thread::current() != &m_Thread )
+			{
+				while ( m_IsInvoking )
+				{
+					m_Access.unlock();
+					m_InvokeDone.wait();
+					m_Access.lock();
+				}
+			}
+		}
+		m_Access.unlock();
+
+		delete &callback;
 	}
 }
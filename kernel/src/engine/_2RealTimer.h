@@ -1,7 +1,6 @@
- /*
+/*
 	CADET - Center for Advances in Digital Entertainment Technologies
 	Copyright 2011 Fachhochschule Salzburg GmbH
-
 		http://www.cadet.at
 
 	Licensed under the Apache License, Version 2.0 (the "License");
@@ -20,41 +19,80 @@
 #pragma once
 
 #include "helpers/_2RealPoco.h"
-#include "helpers/_2RealEvent.h"
+#include "helpers/_2RealCallback.h"
+#include "helpers/_2RealAtomic.h"
+
+#include <vector>
 
 namespace _2Real
 {
 
 	class Logger;
-	template< typename T >
-	class Callback;
 
-	class Timer
+	// runs its own thread, which sleeps until the earliest deadline of all registered callbacks.
+	// deadlines are absolute ( monotonic clock, microseconds ) & advance by exactly one period, so there
+	// is no drift; a callback that could not be invoked in time receives the number of deadlines it missed.
+	// waits longer than a few ms can be interrupted ( new registrations ), the rest is slept precisely,
+	// which allows periods below 1 ms ( on windows, the system timer runs at 1 ms while the timer exists ).
+	// callbacks are invoked without holding the lock, so they may ( un )register themselves or others
+	class Timer : public Poco::Runnable
 	{
 
 	public:
 
+		typedef Poco::Timestamp::TimeVal		Time;
+
 		Timer( Logger &logger );
 		~Timer();
 
-		void receiveTimerSignal( Poco::Timer &t );
-		void registerToTimerSignal( AbstractCallback< long > &callback );
+		void run();
+
+		// takes ownership of the callback, period in microseconds;
+		// registering a callback with the same target again changes the period
+		void registerToTimerSignal( AbstractCallback< long > &callback, const long period );
+		// the callback must have the same target as the registered one; it is deleted, as is the registered one
+		// once this returns, the registered callback is not being invoked & won't be invoked again
+		// ( unless this is called by a callback, which then is allowed to finish )
 		void unregisterFromTimerSignal( AbstractCallback< long > &callback );
 
+		static Time now();
+
 	private:
 
-		Poco::AbstractTimerCallback			*m_Callback;
-		Poco::Timer							m_Timer;
-		Poco::Timestamp						m_Timestamp;
+		struct Deadline
+		{
+			Deadline( AbstractCallback< long > *cb, const Time p, const Time d ) : callback( cb ), period( p ), due( d ), missed( 0 ), isRemoved( false ) {}
+			bool operator>( Deadline const& other ) const { return due > other.due; }
+
+			AbstractCallback< long >	*callback;
+			Time						period;
+			Time						due;
+			long						missed;
+			bool						isRemoved;
+		};
+
+		typedef std::vector< Deadline >					Deadlines;
+		typedef std::vector< Deadline >::iterator		DeadlineIterator;
+
+		DeadlineIterator find( Deadlines &deadlines, AbstractCallback< long > &callback );
+		void sleepUntil( const Time deadline );
+		void invokeDue( const Time current );
 
 		Logger								&m_Logger;
+		Poco::Thread						m_Thread;
+		AtomicLong							m_KeepRunning;
+		Poco::Event							m_WakeUp;
 
 		mutable Poco::FastMutex				m_Access;
-		CallbackEvent< long >				m_TimerSignal;
+		Deadlines							m_Deadlines;			// min heap on due
+		Deadlines							m_Invoked;				// taken from the heap while their callbacks run
+		bool								m_IsInvoking;
+		Poco::Event							m_InvokeDone;			// manual reset, set while not invoking
+		void								*m_WaitableTimer;		// windows only
 
 		long								m_UpdateCount;
 		long								m_SkippedCount;
-		Poco::Timestamp						m_DebugTime;
+		Time								m_DebugTime;
 
 	};
-}
\ No newline at end of file
+}
@@ -20,6 +20,8 @@
 
 #include "helpers/_2RealAny.h"
 
+#include <vector>
+
 namespace _2Real
 {
 
@@ -28,10 +30,11 @@ namespace _2Real
 
 	public:
 
-		TimestampedData() : anyValue(), timestamp( -1 ), key( -1 ) {}
-		TimestampedData( Any const& a ) : anyValue( a ), timestamp( -1 ), key( -1 ) {}
-		TimestampedData( Any const& a, const long t ) : anyValue( a ), timestamp( t ), key( -1 ) {}
-		TimestampedData( Any const& a, const long t, const long k ) : anyValue( a ), timestamp( t ), key( k ) {}
+		TimestampedData() : anyValue(), timestamp( -1 ), key( -1 ), version( 0 ) {}
+		TimestampedData( Any const& a ) : anyValue( a ), timestamp( -1 ), key( -1 ), version( 0 ) {}
+		TimestampedData( Any const& a, const long t ) : anyValue( a ), timestamp( t ), key( -1 ), version( 0 ) {}
+		TimestampedData( Any const& a, const long t, const long k ) : anyValue( a ), timestamp( t ), key( k ), version( 0 ) {}
+		TimestampedData( Any const& a, const long t, const long k, const long v ) : anyValue( a ), timestamp( t ), key( k ), version( v ) {}
 
 		void cloneAnyFrom( TimestampedData const& src ) { anyValue.cloneFrom( src.anyValue ); }
 		void createAnyFrom( TimestampedData const& src ) { anyValue.createNew( src.anyValue ); }
@@ -40,7 +43,13 @@ namespace _2Real
 		Any		anyValue;
 		long	timestamp;
 		long	key;
+		long	version;		// set by outlets: data with the same version has the same value; 0 -> untracked ( see BasicInlet::hasChanged )
 
 	};
 
+	// all data items an inlet received between two updates, oldest first ( see batched delivery )
+	typedef std::vector< TimestampedData >					TimestampedDataBatch;
+	typedef std::vector< TimestampedData >::iterator		TimestampedDataBatchIterator;
+	typedef std::vector< TimestampedData >::const_iterator	TimestampedDataBatchConstIterator;
+
 }
\ No newline at end of file
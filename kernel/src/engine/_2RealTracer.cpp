@@ -0,0 +1,247 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#include "engine/_2RealTracer.h"
+#include "engine/_2RealAbstractStateManager.h"
+#include "helpers/_2RealAtomic.h"
+#include "helpers/_2RealException.h"
+#include "helpers/_2RealPoco.h"
+#include "helpers/_2RealHelpers.h"
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+namespace _2Real
+{
+
+	namespace
+	{
+		const unsigned int		SubjectLength = 56;
+
+		struct Record
+		{
+			Timer::Time		start;
+			Timer::Time		duration;		// < 0: instant event
+			const char		*event;
+			const char		*category;
+			char			subject[ SubjectLength ];
+		};
+
+		// written by its thread only; the exporter reads the first 'count' records of the current session
+		struct ThreadBuffer
+		{
+			ThreadBuffer( const unsigned int i ) : id( i ), count( 0 ), dropped( 0 ), session( 0 ) {}
+
+			unsigned int			id;
+			std::string				name;
+			std::vector< Record >	records;
+			AtomicLong				count;
+			AtomicLong				dropped;
+			AtomicLong				session;
+		};
+
+		class TracerImpl
+		{
+
+		public:
+
+			TracerImpl() : m_IsEnabled( 0 ), m_Session( 0 ), m_Capacity( 0 ), m_StartTime( 0 ) {}
+
+			AtomicLong						m_IsEnabled;
+			AtomicLong						m_Session;
+			AtomicLong						m_Capacity;
+			Timer::Time						m_StartTime;
+
+			Poco::FastMutex					m_Access;			// start / stop & thread registration
+			std::vector< ThreadBuffer * >	m_Buffers;
+
+		};
+
+		TracerImpl & getTracer()
+		{
+			// never destroyed, threads might record while statics are torn down
+			static TracerImpl *tracer = new TracerImpl();
+			return *tracer;
+		}
+
+		_2REAL_THREAD_LOCAL ThreadBuffer *tl_Buffer = nullptr;
+
+		ThreadBuffer & getThreadBuffer()
+		{
+			if ( tl_Buffer == nullptr )
+			{
+				TracerImpl &t = getTracer();
+				Poco::ScopedLock< Poco::FastMutex > lock( t.m_Access );
+				tl_Buffer = new ThreadBuffer( static_cast< unsigned int >( t.m_Buffers.size() ) );
+				t.m_Buffers.push_back( tl_Buffer );
+			}
+			return *tl_Buffer;
+		}
+
+		void record( const char *event, const char *category, std::string const& subject, const Timer::Time start, const Timer::Time duration )
+		{
+			TracerImpl &t = getTracer();
+			ThreadBuffer &b = getThreadBuffer();
+
+			// first event of this thread in a new session
+			const long session = t.m_Session.load();
+			if ( b.session.load() != session )
+			{
+				b.count.store( 0 );
+				b.dropped.store( 0 );
+				const size_t capacity = static_cast< size_t >( t.m_Capacity.load() );
+				if ( b.records.size() != capacity )
+				{
+					std::vector< Record >( capacity ).swap( b.records );
+				}
+				b.session.store( session );
+			}
+
+			const long index = b.count.load();
+			if ( static_cast< size_t >( index ) >= b.records.size() )
+			{
+				b.dropped.increment();
+				return;
+			}
+
+			Record &r = b.records[ index ];
+			r.start = start;
+			r.duration = duration;
+			r.event = event;
+			r.category = category;
+			const size_t length = std::min< size_t >( subject.length(), SubjectLength - 1 );
+			std::memcpy( r.subject, subject.c_str(), length );
+			r.subject[ length ] = '\0';
+
+			b.count.store( index + 1 );
+		}
+
+		void writeEscaped( std::ostream &out, const char *str )
+		{
+			for ( ; *str != '\0'; ++str )
+			{
+				const unsigned char c = static_cast< unsigned char >( *str );
+				if ( c == '"' || c == '\\' )	out << '\\' << *str;
+				else if ( c < 0x20 )			out << ' ';
+				else							out << *str;
+			}
+		}
+	}
+
+	bool Tracer::isEnabled()
+	{
+		return ( getTracer().m_IsEnabled.load() != 0 );
+	}
+
+	void Tracer::start( const unsigned int maxEventsPerThread )
+	{
+		TracerImpl &t = getTracer();
+		Poco::ScopedLock< Poco::FastMutex > lock( t.m_Access );
+
+		t.m_IsEnabled.store( 0 );
+		t.m_Capacity.store( static_cast< long >( maxEventsPerThread ) );
+		t.m_StartTime = Timer::now();
+		t.m_Session.increment();
+		t.m_IsEnabled.store( 1 );
+	}
+
+	unsigned long Tracer::stop( std::string const& filePath )
+	{
+		TracerImpl &t = getTracer();
+		Poco::ScopedLock< Poco::FastMutex > lock( t.m_Access );
+
+		t.m_IsEnabled.store( 0 );
+
+		std::ofstream out( filePath.c_str() );
+		if ( !out.is_open() )
+		{
+			throw Exception( "could not open trace file " + filePath );
+		}
+
+		const long session = t.m_Session.load();
+		unsigned long written = 0, dropped = 0;
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"2Real\"}}";
+
+		for ( std::vector< ThreadBuffer * >::const_iterator it = t.m_Buffers.begin(); it != t.m_Buffers.end(); ++it )
+		{
+			ThreadBuffer const& b = **it;
+			if ( b.session.load() != session ) continue;
+
+			out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b.id << ",\"args\":{\"name\":\"";
+			if ( b.name.empty() )	out << "thread " << b.id;
+			else					writeEscaped( out, b.name.c_str() );
+			out << "\"}}";
+
+			const long count = b.count.load();
+			for ( long i = 0; i<count; ++i )
+			{
+				Record const& r = b.records[ i ];
+				out << ",\n{\"name\":\"";
+				writeEscaped( out, r.subject[ 0 ] != '\0' ? r.subject : r.event );
+				out << "\",\"cat\":\"" << r.category << "\",\"pid\":1,\"tid\":" << b.id << ",\"ts\":" << ( r.start - t.m_StartTime );
+				if ( r.duration < 0 )	out << ",\"ph\":\"i\",\"s\":\"t\"";
+				else					out << ",\"ph\":\"X\",\"dur\":" << r.duration;
+				out << ",\"args\":{\"event\":\"" << r.event << "\"}}";
+			}
+
+			written += static_cast< unsigned long >( count );
+			dropped += static_cast< unsigned long >( b.dropped.load() );
+		}
+
+		out << "\n],\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+		return written;
+	}
+
+	void Tracer::setThreadName( std::string const& name )
+	{
+		ThreadBuffer &b = getThreadBuffer();
+		Poco::ScopedLock< Poco::FastMutex > lock( getTracer().m_Access );		// the exporter might read it
+		b.name = name;
+	}
+
+	void Tracer::instant( const char *event, const char *category, std::string const& subject )
+	{
+		record( event, category, subject, Timer::now(), -1 );
+	}
+
+	void Tracer::complete( const char *event, const char *category, std::string const& subject, const Timer::Time start, const Timer::Time end )
+	{
+		record( event, category, subject, start, end - start );
+	}
+
+	TraceScope::TraceScope( const char *event, const char *category, AbstractStateManager const& block ) :
+		m_Event( event ),
+		m_Category( category ),
+		m_Block( Tracer::isEnabled() ? &block : nullptr ),
+		m_Start( m_Block != nullptr ? Timer::now() : 0 )
+	{
+	}
+
+	TraceScope::~TraceScope()
+	{
+		if ( m_Block != nullptr && Tracer::isEnabled() )
+		{
+			Tracer::complete( m_Event, m_Category, m_Block->getName(), m_Start, Timer::now() );
+		}
+	}
+
+}
@@ -0,0 +1,82 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+#pragma once
+
+#include "engine/_2RealTimer.h"
+#include "helpers/_2RealNonCopyable.h"
+
+#include <string>
+
+// compile time kill switch, like _2REAL_NO_LOGGING
+#ifdef _2REAL_NO_TRACING
+	#define _2REAL_TRACE_SCOPE( event, category, block )
+	#define _2REAL_TRACE_INSTANT( event, category, subject )
+#else
+	// records a complete event from here to the end of the enclosing scope
+	#define _2REAL_TRACE_SCOPE( event, category, block )		_2Real::TraceScope _2RealTraceScope( event, category, block )
+	// the subject is only evaluated while tracing
+	#define _2REAL_TRACE_INSTANT( event, category, subject )										\
+		if ( !_2Real::Tracer::isEnabled() ) {} else _2Real::Tracer::instant( event, category, subject )
+#endif
+
+namespace _2Real
+{
+
+	class AbstractStateManager;
+
+	// process wide timeline recorder, exported as chrome trace json ( chrome://tracing, ui.perfetto.dev ).
+	// every thread records into its own preallocated buffer ( no locks, no allocations except for the subject
+	// string the caller builds ); a full buffer drops further events. events & categories must be string literals
+	class Tracer
+	{
+
+	public:
+
+		static bool				isEnabled();
+
+		// starts a new recording, discarding the previous one
+		static void				start( const unsigned int maxEventsPerThread );
+		// stops recording & writes the events to the file, returns the number of events written
+		static unsigned long	stop( std::string const& filePath );
+
+		// name of the calling thread in the timeline
+		static void				setThreadName( std::string const& name );
+
+		static void				instant( const char *event, const char *category, std::string const& subject );
+		static void				complete( const char *event, const char *category, std::string const& subject, const Timer::Time start, const Timer::Time end );
+
+	};
+
+	class TraceScope : private NonCopyable< TraceScope >
+	{
+
+	public:
+
+		TraceScope( const char *event, const char *category, AbstractStateManager const& block );
+		~TraceScope();
+
+	private:
+
+		const char						*m_Event;
+		const char						*m_Category;
+		AbstractStateManager const		*m_Block;			// null if tracing was disabled at construction
+		Timer::Time						m_Start;
+
+	};
+
+}
@@ -19,17 +19,21 @@
 #include "helpers/_2RealAny.h"
 #include "datatypes/_2RealTypes.h"
 
+#include <algorithm>
+
 namespace _2Real
 {
 	Any::Any() :
-		m_Content( new AnyHolder< NullType >() ),
-		m_TypeDescriptor( createTypeDescriptor< NullType >() )
+		m_TypeDescriptor( _2Real::getTypeDescriptor< NullType >() ),
+		m_InlineOperations( &InlineHolder< NullType >::Operations )
 	{
 	}
 
 	Any::Any( Any const& src ) :
+		m_TypeDescriptor( src.m_TypeDescriptor ),
+		m_InlineOperations( src.m_InlineOperations ),
 		m_Content( src.m_Content ),
-		m_TypeDescriptor( src.m_TypeDescriptor )
+		m_InlineValue( src.m_InlineValue )
 	{
 	}
 
@@ -40,8 +44,10 @@ namespace _2Real
 			return *this;
 		}
 
-		m_Content = src.m_Content;
 		m_TypeDescriptor = src.m_TypeDescriptor;
+		m_InlineOperations = src.m_InlineOperations;
+		m_Content = src.m_Content;
+		m_InlineValue = src.m_InlineValue;
 
 		return *this;
 	}
@@ -53,22 +59,57 @@ namespace _2Real
 
 	bool Any::isEqualTo( Any const& any ) const
 	{
-		return m_Content->isEqualTo( *any.m_Content.get() );
+		if ( !hasSameType( any ) )
+		{
+			return false;
+		}
+		else if ( isInline() )
+		{
+			return m_InlineOperations->isEqualTo( m_InlineValue.bytes, any.m_InlineValue.bytes );
+		}
+		else return m_Content->isEqualTo( *any.m_Content.get() );
 	}
 
 	bool Any::isLessThan( Any const& any ) const
 	{
-		return m_Content->isLessThan( *any.m_Content.get() );
+		if ( !hasSameType( any ) )
+		{
+			std::ostringstream msg;
+			msg << "type of data " << any.m_TypeDescriptor->m_TypeName << " does not match type " << m_TypeDescriptor->m_TypeName << std::endl;
+			throw TypeMismatchException( msg.str() );
+		}
+		else if ( isInline() )
+		{
+			return m_InlineOperations->isLessThan( m_InlineValue.bytes, any.m_InlineValue.bytes );
+		}
+		else return m_Content->isLessThan( *any.m_Content.get() );
+	}
+
+	bool Any::hashContent( unsigned long long &hash ) const
+	{
+		if ( isInline() )
+		{
+			return false;
+		}
+		else return m_Content->hashContent( hash );
 	}
 
 	void Any::writeTo(std::ostream &out) const
 	{
-		m_Content->writeTo(out);
+		if ( isInline() )
+		{
+			m_InlineOperations->writeTo( out, m_InlineValue.bytes );
+		}
+		else m_Content->writeTo(out);
 	}
 
 	void Any::readFrom(std::istream &in)
 	{
-		m_Content->readFrom(in);
+		if ( isInline() )
+		{
+			m_InlineOperations->readFrom( in, m_InlineValue.bytes );
+		}
+		else m_Content->readFrom(in);
 	}
 
 	Type const& Any::getType() const
@@ -81,16 +122,81 @@ namespace _2Real
 		return m_TypeDescriptor->m_TypeCategory;
 	}
 
+	TypeDescriptor const& Any::getTypeDescriptor() const
+	{
+		return *m_TypeDescriptor;
+	}
+
+	bool Any::hasSameType( Any const& other ) const
+	{
+		return m_TypeDescriptor->isSameType( *other.m_TypeDescriptor );
+	}
+
 	void Any::cloneFrom( Any const& src )
 	{
-		m_Content.reset( src.m_Content->clone() );
+		if ( src.isInline() )
+		{
+			m_InlineValue = src.m_InlineValue;
+			m_Content.reset();
+		}
+		else m_Content.reset( src.m_Content->clone() );
+
+		m_InlineOperations = src.m_InlineOperations;
 		m_TypeDescriptor = src.m_TypeDescriptor;
 	}
 
 	void Any::createNew( Any const& src )
 	{
-		m_Content.reset( src.m_Content->create() );
+		if ( src.isInline() )
+		{
+			src.m_InlineOperations->construct( m_InlineValue.bytes );
+			m_Content.reset();
+		}
+		else m_Content.reset( src.m_Content->create() );
+
+		m_InlineOperations = src.m_InlineOperations;
 		m_TypeDescriptor = src.m_TypeDescriptor;
 	}
 
+	bool Any::isUnique() const
+	{
+		return isInline() || m_Content.use_count() == 1;
+	}
+
+	bool Any::sharesValueWith( Any const& other ) const
+	{
+		if ( isInline() )
+		{
+			return this == &other;
+		}
+		else return m_Content.get() == other.m_Content.get();
+	}
+
+	bool Any::copyValueFrom( Any const& src )
+	{
+		if ( sharesValueWith( src ) )
+		{
+			return true;
+		}
+		else if ( !hasSameType( src ) )
+		{
+			return false;
+		}
+		else if ( isInline() )
+		{
+			m_InlineValue = src.m_InlineValue;
+		}
+		else m_Content->assign( *src.m_Content.get() );
+
+		return true;
+	}
+
+	void Any::swap( Any &other )
+	{
+		std::swap( m_TypeDescriptor, other.m_TypeDescriptor );
+		std::swap( m_InlineOperations, other.m_InlineOperations );
+		m_Content.swap( other.m_Content );
+		std::swap( m_InlineValue, other.m_InlineValue );
+	}
+
 }
\ No newline at end of file
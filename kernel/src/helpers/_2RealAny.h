@@ -35,9 +35,35 @@
 
 namespace _2Real
 {
+	// values of these types are stored inside the any itself: no allocation, no refcounting.
+	// they must be trivially copyable & destructible, and fit into Any::InlineSize bytes
+	template< typename TType > struct IsStoredInline						{ enum { value = false }; };
+	template< > struct IsStoredInline< NullType >							{ enum { value = true }; };
+	template< > struct IsStoredInline< bool >								{ enum { value = true }; };
+	template< > struct IsStoredInline< char >								{ enum { value = true }; };
+	template< > struct IsStoredInline< unsigned char >						{ enum { value = true }; };
+	template< > struct IsStoredInline< short >								{ enum { value = true }; };
+	template< > struct IsStoredInline< unsigned short >						{ enum { value = true }; };
+	template< > struct IsStoredInline< int >								{ enum { value = true }; };
+	template< > struct IsStoredInline< unsigned int >						{ enum { value = true }; };
+	template< > struct IsStoredInline< long >								{ enum { value = true }; };
+	template< > struct IsStoredInline< unsigned long >						{ enum { value = true }; };
+	template< > struct IsStoredInline< float >								{ enum { value = true }; };
+	template< > struct IsStoredInline< double >								{ enum { value = true }; };
+	template< > struct IsStoredInline< Number >								{ enum { value = true }; };
+	template< > struct IsStoredInline< Vec2 >								{ enum { value = true }; };
+	template< > struct IsStoredInline< Vec3 >								{ enum { value = true }; };
+	template< > struct IsStoredInline< Vec4 >								{ enum { value = true }; };
+
+	template< typename TType, bool isInline >
+	struct AnyStorage;
+
 	class Any
 	{
 
+		template< typename TType, bool isInline >
+		friend struct AnyStorage;
+
 	public:
 
 		Any();
@@ -45,44 +71,54 @@ namespace _2Real
 		Any& operator=( Any const& src );
 
 		template< typename TType >
-		explicit Any( TType const& value )
+		explicit Any( TType const& value ) :
+			m_TypeDescriptor( _2Real::getTypeDescriptor< TType >() ),
+			m_InlineOperations( nullptr )
 		{
-			m_Content.reset( new AnyHolder< TType >( value ) );
-			m_TypeDescriptor.reset( createTypeDescriptor< TType >() );
+			AnyStorage< TType, IsStoredInline< TType >::value >::construct( *this, value );
 		}
 
 		bool isNull() const;
 		Type const& getType() const;
 		TypeCategory const& getTypeCategory() const;
+		TypeDescriptor const& getTypeDescriptor() const;
+		bool hasSameType( Any const& other ) const;
 
 		template< typename TType >
 		bool isDatatype() const
 		{
-			return m_TypeDescriptor->m_TypeInfo == typeid( TType );
+			return m_TypeDescriptor->isSameType( *_2Real::getTypeDescriptor< TType >() );
 		}
 
 		bool isEqualTo( Any const& any ) const;
 		bool isLessThan( Any const& any ) const;
+		// false for inline values ( just compare them ) & for types that can't be hashed, see hashContent
+		bool hashContent( unsigned long long &hash ) const;
 
 		void cloneFrom( Any const& src );
 		void createNew( Any const& src );
 
+		// copy on write support: an any is unique if no other any shares its value
+		// ( always true for inline values, they are copied along with the any )
+		bool isUnique() const;
+		bool sharesValueWith( Any const& other ) const;
+		// copies src's value into this any's value, without allocating; false if the types differ
+		bool copyValueFrom( Any const& src );
+		void swap( Any &other );
+
 		void writeTo( std::ostream &out ) const;
 		void readFrom( std::istream &in );
 
 		template< typename TType >
 		TType & extract()
 		{
-			std::type_info const& info = typeid( TType );
-			if ( info == m_TypeDescriptor->m_TypeInfo )
+			TypeDescriptor const* t = _2Real::getTypeDescriptor< TType >();
+			if ( m_TypeDescriptor->isSameType( *t ) )
 			{
-				AbstractAnyHolder *ptr = m_Content.get();
-				AnyHolder< TType > &holder = dynamic_cast< AnyHolder< TType > & >( *ptr );
-				return holder.m_Data;
+				return AnyStorage< TType, IsStoredInline< TType >::value >::get( *this );
 			}
 			else
 			{
-				TypeDescriptor *t = createTypeDescriptor< TType >();
 				std::ostringstream msg;
 				msg << "type of 0 data " << m_TypeDescriptor->m_TypeName << " does not match template parameter " << t->m_TypeName << std::endl;
 				throw TypeMismatchException( msg.str() );
@@ -92,26 +128,83 @@ namespace _2Real
 		template< typename TType >
 		TType const& extract() const
 		{
-			std::type_info const& info = typeid( TType );
-			if ( info == m_TypeDescriptor->m_TypeInfo )
+			TypeDescriptor const* t = _2Real::getTypeDescriptor< TType >();
+			if ( m_TypeDescriptor->isSameType( *t ) )
 			{
-				AbstractAnyHolder *ptr = m_Content.get();
-				AnyHolder< TType > &holder = dynamic_cast< AnyHolder< TType > & >( *ptr );
-				return holder.m_Data;
+				return AnyStorage< TType, IsStoredInline< TType >::value >::get( const_cast< Any & >( *this ) );
 			}
 			else
 			{
-				TypeDescriptor *t = createTypeDescriptor< TType >();
 				std::ostringstream msg;
 				msg << "type of 1 data " << m_TypeDescriptor->m_TypeName << " does not match template parameter " << t->m_TypeName << std::endl;
 				throw TypeMismatchException( msg.str() );
 			}
 		}
 
+		// no type check ( except for an assertion ), for callers that checked the type once up front
+		template< typename TType >
+		TType & extractUnchecked()
+		{
+			assert( isDatatype< TType >() );
+			return AnyStorage< TType, IsStoredInline< TType >::value >::get( *this );
+		}
+
+		template< typename TType >
+		TType const& extractUnchecked() const
+		{
+			assert( isDatatype< TType >() );
+			return AnyStorage< TType, IsStoredInline< TType >::value >::get( const_cast< Any & >( *this ) );
+		}
+
 	private:
 
-		std::shared_ptr< TypeDescriptor >		m_TypeDescriptor;
-		std::shared_ptr< AbstractAnyHolder >	m_Content;
+		enum { InlineSize = 4 * sizeof( double ) };
+
+		union InlineStorage
+		{
+			double			alignAsDouble;
+			long long		alignAsLongLong;
+			void			*alignAsPointer;
+			unsigned char	bytes[ InlineSize ];
+		};
+
+		bool isInline() const { return m_InlineOperations != nullptr; }
 
+		TypeDescriptor							const* m_TypeDescriptor;	// interned, never owned
+		InlineOperations						const* m_InlineOperations;	// != nullptr -> the value is in m_InlineValue
+		std::shared_ptr< AbstractAnyHolder >	m_Content;					// otherwise, the value lives here
+		InlineStorage							m_InlineValue;
+
+	};
+
+	template< typename TType >
+	struct AnyStorage< TType, true >
+	{
+		static void construct( Any &any, TType const& value )
+		{
+			static_assert( sizeof( TType ) <= Any::InlineSize, "type is too large to be stored inline" );
+			new ( any.m_InlineValue.bytes ) TType( value );
+			any.m_InlineOperations = &InlineHolder< TType >::Operations;
+		}
+
+		static TType & get( Any &any )
+		{
+			return *reinterpret_cast< TType * >( any.m_InlineValue.bytes );
+		}
+	};
+
+	template< typename TType >
+	struct AnyStorage< TType, false >
+	{
+		static void construct( Any &any, TType const& value )
+		{
+			any.m_Content.reset( new AnyHolder< TType >( value ) );
+		}
+
+		// the type has been checked, no need for a dynamic_cast
+		static TType & get( Any &any )
+		{
+			return static_cast< AnyHolder< TType > * >( any.m_Content.get() )->m_Data;
+		}
 	};
 }
\ No newline at end of file
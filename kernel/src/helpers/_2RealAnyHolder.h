@@ -20,6 +20,7 @@
 
 #include "datatypes/_2RealTypeComparisons.h"
 #include "datatypes/_2RealTypeStreamOperators.h"
+#include "helpers/_2RealContentHash.h"
 
 #ifdef _UNIX
 	#include <typeinfo>
@@ -29,23 +30,27 @@
 
 #include <string>
 #include <sstream>
+#include <new>
 
 namespace _2Real
 {
+	// heap storage for the values of an any that are too large to be stored inline.
+	// the any compares the type descriptors before calling any of the binary operations,
+	// so the holders can static_cast instead of checking the type again
 	class AbstractAnyHolder
 	{
 
 	public:
 
 		virtual ~AbstractAnyHolder() {}
-		virtual const std::string getTypename() const = 0;
-		virtual std::type_info const& getTypeinfo() const = 0;
 		virtual AbstractAnyHolder* clone() const = 0;
 		virtual AbstractAnyHolder* create() const = 0;
+		virtual void assign( AbstractAnyHolder const& other ) = 0;
 		virtual void writeTo( std::ostream &out ) const = 0;
 		virtual void readFrom( std::istream &in ) = 0;
 		virtual bool isEqualTo( AbstractAnyHolder const& other ) const = 0;
 		virtual bool isLessThan( AbstractAnyHolder const& other ) const = 0;
+		virtual bool hashContent( unsigned long long &hash ) const = 0;
 	};
 
 	template< typename TData >
@@ -57,16 +62,16 @@ namespace _2Real
 		AnyHolder();
 		explicit AnyHolder( TData const& value );
 
-		const std::string getTypename() const;
-		std::type_info const& getTypeinfo() const;
 		AbstractAnyHolder * create() const;
 		AbstractAnyHolder * clone() const;
+		void assign( AbstractAnyHolder const& other );
 
 		void writeTo( std::ostream &out ) const;
 		void readFrom( std::istream &in );
 
 		bool isEqualTo( AbstractAnyHolder const& other ) const;
 		bool isLessThan( AbstractAnyHolder const& other ) const;
+		bool hashContent( unsigned long long &hash ) const;
 
 		TData		m_Data;
 
@@ -109,45 +114,23 @@ namespace _2Real
 	}
 
 	template< typename TData >
-	std::type_info const& AnyHolder< TData >::getTypeinfo() const
-	{
-		return typeid( TData );
-	}
-
-	template< typename TData >
-	const std::string AnyHolder< TData >::getTypename() const
+	bool AnyHolder< TData >::isEqualTo( AbstractAnyHolder const& other ) const
 	{
-		return typeid( TData ).name();
+		AnyHolder< TData > const& holder = static_cast< AnyHolder< TData > const& >( other );
+		return m_Data == holder.m_Data;
 	}
 
 	template< typename TData >
-	bool AnyHolder< TData >::isEqualTo( AbstractAnyHolder const& other ) const
+	bool AnyHolder< TData >::isLessThan( AbstractAnyHolder const& other ) const
 	{
-		if ( other.getTypename() == this->getTypename() )
-		{
-			AnyHolder< TData > const& holder = dynamic_cast< AnyHolder< TData > const& >( other );
-			return m_Data == holder.m_Data;
-		}
-		else
-		{
-			return false;
-		}
+		AnyHolder< TData > const& holder = static_cast< AnyHolder< TData > const& >( other );
+		return isLess( m_Data, holder.m_Data );
 	}
 
 	template< typename TData >
-	bool AnyHolder< TData >::isLessThan( AbstractAnyHolder const& other ) const
+	bool AnyHolder< TData >::hashContent( unsigned long long &hash ) const
 	{
-		if ( other.getTypename() == this->getTypename() )
-		{
-			AnyHolder< TData > const& holder = dynamic_cast< AnyHolder< TData > const& >( other );
-			return isLess( m_Data, holder.m_Data );
-		}
-		else
-		{
-			std::ostringstream msg;
-			msg << "type of data " << other.getTypename() << " does not match type " << this->getTypename() << std::endl;
-			throw TypeMismatchException( msg.str() );
-		}
+		return _2Real::hashContent( m_Data, hash );
 	}
 
 	template< typename TData >
@@ -174,4 +157,44 @@ namespace _2Real
 		return new AnyHolder< TData >( m_Data );
 	}
 
-}
+	template< typename TData >
+	void AnyHolder< TData >::assign( AbstractAnyHolder const& other )
+	{
+		AnyHolder< TData > const& holder = static_cast< AnyHolder< TData > const& >( other );
+		m_Data = holder.m_Data;
+	}
+
+	// inline storage for small, trivially copyable values: copied bytewise, never destroyed.
+	// instead of a holder's vtable, the any points to a static table of functions for the type
+	struct InlineOperations
+	{
+		void ( *construct )( void *value );
+		void ( *writeTo )( std::ostream &out, void const* value );
+		void ( *readFrom )( std::istream &in, void *value );
+		bool ( *isEqualTo )( void const* value, void const* other );
+		bool ( *isLessThan )( void const* value, void const* other );
+	};
+
+	template< typename TData >
+	struct InlineHolder
+	{
+		static void construct( void *value )								{ new ( value ) TData(); }
+		static void writeTo( std::ostream &out, void const* value )			{ _2Real::writeTo( out, *static_cast< TData const* >( value ) ); }
+		static void readFrom( std::istream &in, void *value )				{ _2Real::readFrom( in, *static_cast< TData * >( value ) ); }
+		static bool isEqualTo( void const* value, void const* other )		{ return *static_cast< TData const* >( value ) == *static_cast< TData const* >( other ); }
+		static bool isLessThan( void const* value, void const* other )		{ return isLess( *static_cast< TData const* >( value ), *static_cast< TData const* >( other ) ); }
+
+		static const InlineOperations		Operations;
+	};
+
+	template< typename TData >
+	const InlineOperations InlineHolder< TData >::Operations =
+	{
+		&InlineHolder< TData >::construct,
+		&InlineHolder< TData >::writeTo,
+		&InlineHolder< TData >::readFrom,
+		&InlineHolder< TData >::isEqualTo,
+		&InlineHolder< TData >::isLessThan
+	};
+
+}
\ No newline at end of file
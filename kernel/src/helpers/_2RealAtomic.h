@@ -0,0 +1,138 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+	#pragma intrinsic( _InterlockedIncrement, _InterlockedDecrement, _InterlockedExchangeAdd, _InterlockedExchange, _InterlockedCompareExchange )
+	#pragma intrinsic( _InterlockedCompareExchange64 )
+#endif
+
+namespace _2Real
+{
+
+	// minimal atomic integer for the few places where a mutex would be too expensive:
+	// msvc 2010 has no <atomic>, so this maps to the interlocked intrinsics / gcc's atomic builtins.
+	// all operations are sequentially consistent
+	class AtomicLong
+	{
+
+	public:
+
+		explicit AtomicLong( const long value = 0 ) : m_Value( value ) {}
+
+#ifdef _MSC_VER
+		// on x86 / x64, msvc's volatile read & write have acquire / release semantics
+		long load() const											{ return m_Value; }
+		void store( const long value )								{ _InterlockedExchange( &m_Value, value ); }
+		long increment()											{ return _InterlockedIncrement( &m_Value ); }
+		long decrement()											{ return _InterlockedDecrement( &m_Value ); }
+		long add( const long value )								{ return _InterlockedExchangeAdd( &m_Value, value ) + value; }
+		long exchange( const long value )							{ return _InterlockedExchange( &m_Value, value ); }
+		bool compareAndSwap( const long expected, const long desired )	{ return _InterlockedCompareExchange( &m_Value, desired, expected ) == expected; }
+#else
+		long load() const											{ return __atomic_load_n( &m_Value, __ATOMIC_SEQ_CST ); }
+		void store( const long value )								{ __atomic_store_n( &m_Value, value, __ATOMIC_SEQ_CST ); }
+		long increment()											{ return __atomic_add_fetch( &m_Value, 1, __ATOMIC_SEQ_CST ); }
+		long decrement()											{ return __atomic_sub_fetch( &m_Value, 1, __ATOMIC_SEQ_CST ); }
+		long add( const long value )								{ return __atomic_add_fetch( &m_Value, value, __ATOMIC_SEQ_CST ); }
+		long exchange( const long value )							{ return __atomic_exchange_n( &m_Value, value, __ATOMIC_SEQ_CST ); }
+		bool compareAndSwap( long expected, const long desired )	{ return __atomic_compare_exchange_n( &m_Value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ); }
+#endif
+
+	private:
+
+		AtomicLong( AtomicLong const& src );
+		AtomicLong& operator=( AtomicLong const& src );
+
+		volatile long		m_Value;
+
+	};
+
+	// 64 bit counterpart, for sums that outgrow a long ( 32 bit on windows ). 32 bit msvc has only the
+	// 64 bit compare & swap ( cmpxchg8b ), so everything else is built on it
+	class AtomicInt64
+	{
+
+	public:
+
+		explicit AtomicInt64( const long long value = 0 ) : m_Value( value ) {}
+
+#ifdef _MSC_VER
+		long long load() const										{ return _InterlockedCompareExchange64( const_cast< long long volatile * >( &m_Value ), 0, 0 ); }
+		bool compareAndSwap( const long long expected, const long long desired )	{ return _InterlockedCompareExchange64( &m_Value, desired, expected ) == expected; }
+
+		void store( const long long value )
+		{
+			long long curr = load();
+			while ( !compareAndSwap( curr, value ) ) curr = load();
+		}
+
+		long long add( const long long value )
+		{
+			long long curr = load();
+			while ( !compareAndSwap( curr, curr + value ) ) curr = load();
+			return curr + value;
+		}
+#else
+		long long load() const										{ return __atomic_load_n( &m_Value, __ATOMIC_SEQ_CST ); }
+		void store( const long long value )							{ __atomic_store_n( &m_Value, value, __ATOMIC_SEQ_CST ); }
+		long long add( const long long value )						{ return __atomic_add_fetch( &m_Value, value, __ATOMIC_SEQ_CST ); }
+		bool compareAndSwap( long long expected, const long long desired )	{ return __atomic_compare_exchange_n( &m_Value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ); }
+#endif
+
+	private:
+
+		AtomicInt64( AtomicInt64 const& src );
+		AtomicInt64& operator=( AtomicInt64 const& src );
+
+		// 64 bit atomics need 8 byte alignment, gcc aligns long long to 4 bytes on 32 bit x86
+#ifdef _MSC_VER
+		__declspec( align( 8 ) ) volatile long long		m_Value;
+#else
+		volatile long long		m_Value __attribute__(( aligned( 8 ) ));
+#endif
+
+	};
+
+	// atomic access to a plain volatile pointer: unlike a class member, such a pointer is zero initialized
+	// before any code runs, so it may be used by static initializers ( msvc 2010 has no constexpr constructors )
+	template< typename T >
+	T * atomicLoad( T *volatile const& ptr )
+	{
+#ifdef _MSC_VER
+		return ptr;
+#else
+		return __atomic_load_n( &ptr, __ATOMIC_SEQ_CST );
+#endif
+	}
+
+	template< typename T >
+	bool atomicCompareAndSwap( T *volatile& ptr, T *expected, T *desired )
+	{
+#ifdef _MSC_VER
+		void *exp = const_cast< void * >( static_cast< void const* >( expected ) );
+		void *des = const_cast< void * >( static_cast< void const* >( desired ) );
+		return _InterlockedCompareExchangePointer( ( void *volatile * )&ptr, des, exp ) == exp;
+#else
+		return __atomic_compare_exchange_n( &ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+#endif
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,254 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#include "helpers/_2RealBufferPool.h"
+#include "helpers/_2RealPoco.h"
+#include "helpers/_2RealHelpers.h"
+
+#include <vector>
+#include <new>
+
+namespace _2Real
+{
+
+	namespace
+	{
+		// smallest bucket is 256 bytes, above that there are 4 buckets per power of two
+		const unsigned int		MinBucketShift = 8;
+		const size_t			MinBucketSize = size_t( 1 ) << MinBucketShift;
+		const unsigned int		NumberOfBuckets = ( sizeof( size_t ) * 8 - MinBucketShift ) * 4 + 1;
+		const size_t			DefaultMaxCachedBytes = 256 * 1024 * 1024;
+		const unsigned int		MaxNodes = 8;				// threads on higher nodes share the last free lists
+		const size_t			PageSize = 4096;
+
+		// payload starts right behind the header, on a BufferAlignment boundary
+		const size_t			HeaderSize = ( sizeof( PooledBlock ) + BufferAlignment - 1 ) & ~( BufferAlignment - 1 );
+
+		unsigned int getBucket( const size_t size, size_t &capacity )
+		{
+			if ( size <= MinBucketSize )
+			{
+				capacity = MinBucketSize;
+				return 0;
+			}
+
+			// 2^k < size <= 2^(k+1)
+			unsigned int k = 0;
+			for ( size_t v = size - 1; v > 1; v >>= 1 ) ++k;
+
+			size_t const base = size_t( 1 ) << k;
+			size_t const quarter = base >> 2;
+			size_t const steps = ( size - base + quarter - 1 ) / quarter;		// 1 .. 4
+			capacity = base + steps * quarter;
+			return ( k - MinBucketShift ) * 4 + static_cast< unsigned int >( steps );
+		}
+
+		// -1: thread was not placed on a node
+		_2REAL_THREAD_LOCAL int tl_Node = -1;
+
+		PooledBlock * createBlock( const size_t capacity, const unsigned int bucket, const unsigned int node )
+		{
+			unsigned char *raw = new unsigned char[ HeaderSize + capacity + BufferAlignment - 1 ];
+			unsigned char *base = reinterpret_cast< unsigned char * >( ( reinterpret_cast< size_t >( raw ) + BufferAlignment - 1 ) & ~( BufferAlignment - 1 ) );
+			PooledBlock *block = new ( base ) PooledBlock;
+			block->capacity = capacity;
+			block->bucket = bucket;
+			block->node = node;
+			block->data = base + HeaderSize;
+			block->memory = raw;
+
+			// first touch: map all pages now, from this thread, so the os places them on this thread's node
+			if ( tl_Node >= 0 )
+			{
+				for ( size_t offset = 0; offset < capacity; offset += PageSize ) block->data[ offset ] = 0;
+			}
+			return block;
+		}
+
+		void destroyBlock( PooledBlock *block )
+		{
+			unsigned char *raw = block->memory;
+			block->~PooledBlock();
+			delete [] raw;
+		}
+
+		class BufferPoolImpl
+		{
+
+		public:
+
+			BufferPoolImpl()
+			{
+				m_Statistics.maxBytesCached = DefaultMaxCachedBytes;
+			}
+
+			PooledBlock * acquire( const size_t size )
+			{
+				size_t capacity;
+				unsigned int bucket = getBucket( size, capacity );
+				unsigned int node = ( tl_Node >= 0 ? std::min< unsigned int >( tl_Node, MaxNodes - 1 ) : 0 );
+
+				PooledBlock *block = nullptr;
+				{
+					Poco::FastMutex::ScopedLock lock( m_Access );
+
+					FreeList &freeList = m_FreeLists[ node ][ bucket ];
+					if ( !freeList.empty() )
+					{
+						block = freeList.back();
+						freeList.pop_back();
+						++m_Statistics.hits;
+						--m_Statistics.buffersCached;
+						m_Statistics.bytesCached -= capacity;
+					}
+					else
+					{
+						++m_Statistics.misses;
+					}
+
+					++m_Statistics.buffersInUse;
+					m_Statistics.bytesInUse += capacity;
+				}
+
+				if ( block == nullptr )
+				{
+					block = createBlock( capacity, bucket, node );
+				}
+
+				block->refCount.store( 1 );
+				return block;
+			}
+
+			void release( PooledBlock *block )
+			{
+				{
+					Poco::FastMutex::ScopedLock lock( m_Access );
+
+					--m_Statistics.buffersInUse;
+					m_Statistics.bytesInUse -= block->capacity;
+
+					if ( m_Statistics.bytesCached + block->capacity <= m_Statistics.maxBytesCached )
+					{
+						m_FreeLists[ block->node ][ block->bucket ].push_back( block );
+						++m_Statistics.releases;
+						++m_Statistics.buffersCached;
+						m_Statistics.bytesCached += block->capacity;
+						return;
+					}
+
+					++m_Statistics.discards;
+				}
+
+				destroyBlock( block );
+			}
+
+			BufferPoolStatistics getStatistics() const
+			{
+				Poco::FastMutex::ScopedLock lock( m_Access );
+				return m_Statistics;
+			}
+
+			void setMaxCachedBytes( const size_t bytes )
+			{
+				Poco::FastMutex::ScopedLock lock( m_Access );
+				m_Statistics.maxBytesCached = bytes;
+				trim();
+			}
+
+			void clear()
+			{
+				Poco::FastMutex::ScopedLock lock( m_Access );
+				const size_t max = m_Statistics.maxBytesCached;
+				m_Statistics.maxBytesCached = 0;
+				trim();
+				m_Statistics.maxBytesCached = max;
+			}
+
+		private:
+
+			typedef std::vector< PooledBlock * >		FreeList;
+
+			// frees cached buffers, largest first, until the limit is met
+			void trim()
+			{
+				for ( unsigned int i = NumberOfBuckets; i > 0 && m_Statistics.bytesCached > m_Statistics.maxBytesCached; --i )
+				{
+					for ( unsigned int node = 0; node < MaxNodes; ++node )
+					{
+						FreeList &freeList = m_FreeLists[ node ][ i-1 ];
+						while ( !freeList.empty() && m_Statistics.bytesCached > m_Statistics.maxBytesCached )
+						{
+							PooledBlock *block = freeList.back();
+							freeList.pop_back();
+							--m_Statistics.buffersCached;
+							m_Statistics.bytesCached -= block->capacity;
+							++m_Statistics.discards;
+							destroyBlock( block );
+						}
+					}
+				}
+			}
+
+			mutable Poco::FastMutex		m_Access;
+			FreeList					m_FreeLists[ MaxNodes ][ NumberOfBuckets ];
+			BufferPoolStatistics		m_Statistics;
+
+		};
+
+		BufferPoolImpl & getPool()
+		{
+			// never destroyed: datatypes held by other statics may release their buffers after this translation unit is torn down
+			static BufferPoolImpl *pool = new BufferPoolImpl();
+			return *pool;
+		}
+
+		// constructs the pool before main, so the lazy initialization above is never raced
+		BufferPoolImpl &s_Pool = getPool();
+	}
+
+	PooledBlock * BufferPool::acquire( const size_t size )
+	{
+		return getPool().acquire( size );
+	}
+
+	void BufferPool::release( PooledBlock *block )
+	{
+		getPool().release( block );
+	}
+
+	void BufferPool::setThreadNode( const unsigned int node )
+	{
+		tl_Node = static_cast< int >( node );
+	}
+
+	BufferPoolStatistics BufferPool::getStatistics()
+	{
+		return getPool().getStatistics();
+	}
+
+	void BufferPool::setMaxCachedBytes( const size_t bytes )
+	{
+		getPool().setMaxCachedBytes( bytes );
+	}
+
+	void BufferPool::clear()
+	{
+		getPool().clear();
+	}
+
+}
@@ -0,0 +1,180 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include "helpers/_2RealAtomic.h"
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+namespace _2Real
+{
+
+	struct BufferPoolStatistics
+	{
+		BufferPoolStatistics() :
+			hits( 0 ), misses( 0 ), releases( 0 ), discards( 0 ),
+			buffersInUse( 0 ), buffersCached( 0 ), bytesInUse( 0 ), bytesCached( 0 ), maxBytesCached( 0 )
+		{
+		}
+
+		unsigned long		hits;				// acquisitions served from a free list
+		unsigned long		misses;				// acquisitions that had to go to the heap
+		unsigned long		releases;			// buffers handed back to a free list
+		unsigned long		discards;			// buffers freed b/c the cache was full
+		unsigned long		buffersInUse;
+		unsigned long		buffersCached;
+		size_t				bytesInUse;
+		size_t				bytesCached;
+		size_t				maxBytesCached;
+	};
+
+	// payloads start on a cache line, which is also enough for the widest simd loads
+	const size_t BufferAlignment = 64;
+
+	// header in front of every pooled allocation, the payload follows directly
+	struct PooledBlock
+	{
+		AtomicLong			refCount;
+		size_t				capacity;
+		unsigned int		bucket;
+		unsigned int		node;				// numa node of the free list the block goes back to
+		unsigned char		*data;
+		unsigned char		*memory;			// start of the allocation, in front of the aligned header
+	};
+
+	// process wide, size-bucketed pool for the payloads of the large datatypes ( images, audio buffers )
+	// requests are rounded up to 2^k * ( 1 + s/4 ), so at most 25% of a buffer is slack; released
+	// buffers go onto the free list of their bucket until the cache limit is reached.
+	// in a steady-state pipeline every frame is thus served from a free list.
+	// free lists are kept per numa node: a worker pinned to a node only reuses buffers that were
+	// allocated - and first touched, so their pages live there - by a worker on the same node
+	class BufferPool
+	{
+
+	public:
+
+		static PooledBlock *			acquire( const size_t size );
+		static void						release( PooledBlock *block );
+
+		// numa node of the calling thread, set by the workers of pinned thread pools
+		static void						setThreadNode( const unsigned int node );
+
+		static BufferPoolStatistics		getStatistics();
+		static void						setMaxCachedBytes( const size_t bytes );
+		static void						clear();
+
+	};
+
+	// refcounted handle to a pooled buffer, copies share the payload.
+	// the datatypes use isUnique() to do copy-on-write
+	class SharedBuffer
+	{
+
+	public:
+
+		SharedBuffer() : m_Block( nullptr ) {}
+		explicit SharedBuffer( const size_t size ) : m_Block( size > 0 ? BufferPool::acquire( size ) : nullptr ) {}
+
+		SharedBuffer( SharedBuffer const& src ) :
+			m_Block( src.m_Block )
+		{
+			if ( m_Block != nullptr ) m_Block->refCount.increment();
+		}
+
+		SharedBuffer& operator=( SharedBuffer const& src )
+		{
+			SharedBuffer tmp( src );
+			swap( tmp );
+			return *this;
+		}
+
+		~SharedBuffer()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			if ( m_Block != nullptr && m_Block->refCount.decrement() == 0 )
+			{
+				BufferPool::release( m_Block );
+			}
+			m_Block = nullptr;
+		}
+
+		void swap( SharedBuffer &other )
+		{
+			std::swap( m_Block, other.m_Block );
+		}
+
+		// makes sure this handle holds an unshared buffer of at least size bytes; contents are undefined afterwards
+		// an unshared buffer that is large enough is reused
+		void allocate( const size_t size )
+		{
+			if ( size == 0 )
+			{
+				reset();
+			}
+			else if ( !isUnique() || m_Block->capacity < size )
+			{
+				SharedBuffer tmp( size );
+				swap( tmp );
+			}
+		}
+
+		void assign( void const* data, const size_t size )
+		{
+			if ( data == nullptr )
+			{
+				reset();
+				return;
+			}
+
+			allocate( size );
+			if ( size > 0 ) memcpy( m_Block->data, data, size );
+		}
+
+		// detaches from other handles, keeping the first size bytes of the content
+		void makeUnique( const size_t size )
+		{
+			if ( m_Block != nullptr && !isUnique() )
+			{
+				SharedBuffer tmp( size );
+				if ( size > 0 ) memcpy( tmp.getData(), getData(), std::min( size, m_Block->capacity ) );
+				swap( tmp );
+			}
+		}
+
+		unsigned char *		getData() const			{ return m_Block != nullptr ? m_Block->data : nullptr; }
+		size_t				getCapacity() const		{ return m_Block != nullptr ? m_Block->capacity : 0; }
+		bool				isNull() const			{ return m_Block == nullptr; }
+		bool				isUnique() const		{ return m_Block != nullptr && m_Block->refCount.load() == 1; }
+
+		bool operator==( SharedBuffer const& other ) const { return m_Block == other.m_Block; }
+		bool operator!=( SharedBuffer const& other ) const { return m_Block != other.m_Block; }
+
+	private:
+
+		PooledBlock			*m_Block;
+
+	};
+
+}
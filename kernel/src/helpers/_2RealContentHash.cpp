@@ -0,0 +1,101 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#include "helpers/_2RealContentHash.h"
+
+#include <string.h>
+
+namespace _2Real
+{
+
+	namespace
+	{
+		const unsigned long long Prime1 = 0x9E3779B185EBCA87ULL;
+		const unsigned long long Prime2 = 0xC2B2AE3D27D4EB4FULL;
+		const unsigned long long Prime3 = 0x165667B19E3779F9ULL;
+
+		inline unsigned long long rotate( const unsigned long long x, const int bits )
+		{
+			return ( x << bits ) | ( x >> ( 64 - bits ) );
+		}
+
+		inline unsigned long long mixLane( unsigned long long lane, const unsigned long long word )
+		{
+			lane += word * Prime2;
+			lane = rotate( lane, 31 );
+			return lane * Prime1;
+		}
+
+		// memcpy b/c the data is not necessarily aligned; compiles to a plain load
+		inline unsigned long long readWord( unsigned char const* p )
+		{
+			unsigned long long word;
+			memcpy( &word, p, sizeof( word ) );
+			return word;
+		}
+	}
+
+	unsigned long long hashBytes( void const* data, const size_t size, const unsigned long long seed )
+	{
+		unsigned char const* p = static_cast< unsigned char const* >( data );
+		unsigned char const* const end = p + size;
+
+		unsigned long long h;
+		if ( size >= 32 )
+		{
+			unsigned long long l0 = seed + Prime1 + Prime2;
+			unsigned long long l1 = seed + Prime2;
+			unsigned long long l2 = seed;
+			unsigned long long l3 = seed - Prime1;
+
+			unsigned char const* const last = end - 32;
+			for ( ; p <= last; p += 32 )
+			{
+				l0 = mixLane( l0, readWord( p ) );
+				l1 = mixLane( l1, readWord( p + 8 ) );
+				l2 = mixLane( l2, readWord( p + 16 ) );
+				l3 = mixLane( l3, readWord( p + 24 ) );
+			}
+
+			h = rotate( l0, 1 ) + rotate( l1, 7 ) + rotate( l2, 12 ) + rotate( l3, 18 );
+		}
+		else h = seed + Prime3;
+
+		h += static_cast< unsigned long long >( size );
+
+		for ( ; p + 8 <= end; p += 8 )
+		{
+			h ^= mixLane( 0, readWord( p ) );
+			h = rotate( h, 27 ) * Prime1 + Prime3;
+		}
+
+		for ( ; p < end; ++p )
+		{
+			h ^= ( *p ) * Prime3;
+			h = rotate( h, 11 ) * Prime1;
+		}
+
+		h ^= h >> 33;
+		h *= Prime2;
+		h ^= h >> 29;
+		h *= Prime3;
+		h ^= h >> 32;
+		return h;
+	}
+
+}
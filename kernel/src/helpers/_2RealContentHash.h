@@ -0,0 +1,48 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+#include <stddef.h>
+
+namespace _2Real
+{
+
+	// 64 bit hash of a value's content, used for change detection of values that carry no version
+	// ( see BasicInlet::hasChanged ). not cryptographic - equal hashes mean equal content with
+	// a probability that is good enough for 'did this change', not for anything else.
+	// types without a specialization return false, their values are compared instead
+	template< typename TData >
+	inline bool hashContent( TData const& value, unsigned long long &hash )
+	{
+		return false;
+	}
+
+	// four independent multiply-xorshift lanes over 8 byte words, so the loop is bound by memory
+	// bandwidth rather than by the latency of a single multiply chain
+	unsigned long long hashBytes( void const* data, const size_t size, const unsigned long long seed = 0 );
+
+	template < >
+	inline bool hashContent( std::string const& value, unsigned long long &hash )
+	{
+		hash = hashBytes( value.data(), value.size() );
+		return true;
+	}
+
+}
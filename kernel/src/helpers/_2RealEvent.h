@@ -20,68 +20,226 @@
 
 #include "helpers/_2RealPoco.h"
 #include "helpers/_2RealCallback.h"
+#include "helpers/_2RealParallelFor.h"
 
-#include <set>
+#include <vector>
+#include <memory>
+#include <algorithm>
 #include <iostream>
 
 namespace _2Real
 {
+	// copy on write listener list: add & remove build a new list and swap it in, notify iterates over
+	// an immutable snapshot of the current list. the lock notify takes only guards copying the snapshot pointer
+	// & registering as its reader, so a slow listener neither blocks ( un- )registration nor other notifying threads.
+	// removeListener & clear wait until no notify uses a list containing the removed listeners anymore -
+	// once they return, those listeners won't be invoked again. they may be called from a listener ( the calling
+	// listener itself is allowed to finish ), but not from one that runs in a parallel notify
 	template< typename TArg >
 	class CallbackEvent
 	{
 
 	public:
 
-		typedef std::set< AbstractCallback< TArg > *, AbstractCallbackCompare< TArg > >								Callbacks;
-		typedef typename std::set< AbstractCallback< TArg > *, AbstractCallbackCompare< TArg > >::iterator			CallbackIterator;
-		typedef typename std::set< AbstractCallback< TArg > *, AbstractCallbackCompare< TArg > >::const_iterator	CallbackConstIterator;
+		typedef std::shared_ptr< AbstractCallback< TArg > >							SharedCallback;
+		typedef std::vector< SharedCallback >											Callbacks;
+		typedef typename std::vector< SharedCallback >::iterator						CallbackIterator;
+		typedef typename std::vector< SharedCallback >::const_iterator					CallbackConstIterator;
 
-		CallbackEvent() {}
+		CallbackEvent() : m_Snapshot( new Snapshot() ), m_Generation( 0 ) {}
 		~CallbackEvent() { clear(); }
 
 		void clear()
 		{
-			Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
-			for ( CallbackIterator cbIter = m_Callbacks.begin(); cbIter != m_Callbacks.end(); ++cbIter ) delete *cbIter;
-			m_Callbacks.clear();
+			unsigned long previous;
+			{
+				Poco::ScopedLock< Poco::FastMutex > lock( m_WriteAccess );
+				previous = publish( SnapshotPtr( new Snapshot() ) );
+			}
+			waitForReaders( previous );
 		}
 
 		void addListener( AbstractCallback< TArg > &callback )
 		{
-			Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
-			CallbackIterator cbIter = m_Callbacks.find( &callback );
-			if ( cbIter == m_Callbacks.end() )
+			Poco::ScopedLock< Poco::FastMutex > lock( m_WriteAccess );
+			SnapshotPtr current = getSnapshot();
+			if ( find( current->callbacks, callback ) == current->callbacks.end() )
 			{
-				m_Callbacks.insert( &callback );
+				Snapshot *next = new Snapshot( current->callbacks );
+				next->callbacks.push_back( SharedCallback( &callback ) );
+				publish( SnapshotPtr( next ) );
 			}
 			else delete &callback;
 		}
 
 		void removeListener( AbstractCallback< TArg > &callback )
 		{
-			Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
-			CallbackIterator cbIter = m_Callbacks.find( &callback );
-			if ( cbIter != m_Callbacks.end() )
+			bool wasRemoved = false;
+			unsigned long previous = 0;
 			{
-				delete *cbIter;
-				m_Callbacks.erase( cbIter );
+				Poco::ScopedLock< Poco::FastMutex > lock( m_WriteAccess );
+				SnapshotPtr current = getSnapshot();
+				Callbacks const& callbacks = current->callbacks;
+				CallbackConstIterator cbIter = find( callbacks, callback );
+				if ( cbIter != callbacks.end() )
+				{
+					Snapshot *next = new Snapshot( Callbacks( callbacks.begin(), cbIter ) );
+					next->callbacks.insert( next->callbacks.end(), cbIter + 1, callbacks.end() );
+					previous = publish( SnapshotPtr( next ) );
+					wasRemoved = true;
+				}
 			}
 			delete &callback;
+
+			// not holding the write lock, so listeners that are waited for may ( un- )register
+			if ( wasRemoved ) waitForReaders( previous );
 		}
 
 		void notify( TArg &arg ) const
 		{
-			Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
-			for ( CallbackIterator cbIter = m_Callbacks.begin(); cbIter != m_Callbacks.end(); ++cbIter )
+			ReadScope scope( *this );
+			Callbacks const& callbacks = scope.snapshot->callbacks;
+			for ( CallbackConstIterator cbIter = callbacks.begin(); cbIter != callbacks.end(); ++cbIter )
 			{
 				( *cbIter )->invoke( arg );
 			}
 		}
 
+		// the listeners are invoked in parallel, so they must not depend on each other
+		void notify( TArg &arg, AbstractParallelExecutor &executor ) const
+		{
+			ReadScope scope( *this );
+			Callbacks const& callbacks = scope.snapshot->callbacks;
+			if ( callbacks.size() < 2 )
+			{
+				if ( !callbacks.empty() ) callbacks.front()->invoke( arg );
+				return;
+			}
+
+			FanOut fanOut( callbacks, arg );
+			MemberCallback< FanOut, const unsigned int > body( fanOut, &FanOut::invoke );
+			executor.parallelFor( static_cast< unsigned int >( callbacks.size() ), body );
+		}
+
 	private:
 
-		mutable Poco::FastMutex		m_Access;
-		Callbacks					m_Callbacks;
+		struct Snapshot
+		{
+			Snapshot() : generation( 0 ) {}
+			explicit Snapshot( Callbacks const& c ) : callbacks( c ), generation( 0 ) {}
+
+			Callbacks			callbacks;
+			unsigned long		generation;
+		};
+
+		typedef std::shared_ptr< Snapshot >		SnapshotPtr;
+
+		// a notifying thread & the generation of the snapshot it iterates
+		struct Reader
+		{
+			Reader( const Poco::Thread::TID t, const unsigned long g ) : thread( t ), generation( g ) {}
+			bool operator==( Reader const& other ) const { return thread == other.thread && generation == other.generation; }
+
+			Poco::Thread::TID	thread;
+			unsigned long		generation;
+		};
+
+		// registers the calling thread as reader of the current snapshot for its lifetime
+		struct ReadScope
+		{
+			ReadScope( CallbackEvent const& e ) : event( e ), snapshot( e.beginRead() ) {}
+			~ReadScope() { event.endRead( snapshot ); }
+
+			CallbackEvent const		&event;
+			SnapshotPtr				snapshot;
+		};
+
+		struct FanOut
+		{
+			FanOut( Callbacks const& c, TArg &a ) : callbacks( c ), arg( a ) {}
+			void invoke( const unsigned int &index ) { callbacks[ index ]->invoke( arg ); }
+
+			Callbacks const		&callbacks;
+			TArg				&arg;
+		};
+
+		static CallbackConstIterator find( Callbacks const& callbacks, AbstractCallback< TArg > &callback )
+		{
+			AbstractCallbackCompare< TArg > less;
+			for ( CallbackConstIterator cbIter = callbacks.begin(); cbIter != callbacks.end(); ++cbIter )
+			{
+				if ( !less( cbIter->get(), &callback ) && !less( &callback, cbIter->get() ) ) return cbIter;
+			}
+			return callbacks.end();
+		}
+
+		SnapshotPtr getSnapshot() const
+		{
+			Poco::ScopedLock< Poco::FastMutex > lock( m_SnapshotAccess );
+			return m_Snapshot;
+		}
+
+		SnapshotPtr beginRead() const
+		{
+			Poco::ScopedLock< Poco::FastMutex > lock( m_SnapshotAccess );
+			m_Readers.push_back( Reader( Poco::Thread::currentTid(), m_Snapshot->generation ) );
+			return m_Snapshot;
+		}
+
+		void endRead( SnapshotPtr const& snapshot ) const
+		{
+			Poco::ScopedLock< Poco::FastMutex > lock( m_SnapshotAccess );
+			m_Readers.erase( std::find( m_Readers.begin(), m_Readers.end(), Reader( Poco::Thread::currentTid(), snapshot->generation ) ) );
+			for ( std::vector< Poco::Event * >::const_iterator it = m_Waiters.begin(); it != m_Waiters.end(); ++it )
+			{
+				( *it )->set();
+			}
+		}
+
+		// m_WriteAccess must be locked, returns the generation of the previous snapshot
+		unsigned long publish( SnapshotPtr const& next )
+		{
+			Poco::ScopedLock< Poco::FastMutex > lock( m_SnapshotAccess );
+			const unsigned long previous = m_Snapshot->generation;
+			next->generation = ++m_Generation;
+			m_Snapshot = next;
+			return previous;
+		}
+
+		// m_SnapshotAccess must be locked
+		bool isRead( const unsigned long generation, const Poco::Thread::TID self ) const
+		{
+			for ( typename std::vector< Reader >::const_iterator it = m_Readers.begin(); it != m_Readers.end(); ++it )
+			{
+				if ( it->thread != self && it->generation <= generation ) return true;
+			}
+			return false;
+		}
+
+		// waits until all threads but the calling one stopped reading snapshots up to the generation
+		void waitForReaders( const unsigned long generation )
+		{
+			const Poco::Thread::TID self = Poco::Thread::currentTid();
+			Poco::Event readerDone;
+
+			m_SnapshotAccess.lock();
+			while ( isRead( generation, self ) )
+			{
+				m_Waiters.push_back( &readerDone );
+				m_SnapshotAccess.unlock();
+				readerDone.wait();
+				m_SnapshotAccess.lock();
+				m_Waiters.erase( std::find( m_Waiters.begin(), m_Waiters.end(), &readerDone ) );
+			}
+			m_SnapshotAccess.unlock();
+		}
+
+		mutable Poco::FastMutex					m_SnapshotAccess;		// never held while a listener runs
+		Poco::FastMutex							m_WriteAccess;
+		SnapshotPtr								m_Snapshot;
+		unsigned long							m_Generation;
+		mutable std::vector< Reader >			m_Readers;
+		mutable std::vector< Poco::Event * >	m_Waiters;				// set whenever a reader is done
 
 	};
-}
+}
\ No newline at end of file
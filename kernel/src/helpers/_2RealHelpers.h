@@ -18,6 +18,12 @@
 
 #pragma once
 
+#ifdef _2REAL_WINDOWS
+	#define _2REAL_THREAD_LOCAL __declspec( thread )
+#else
+	#define _2REAL_THREAD_LOCAL __thread
+#endif
+
 namespace _2Real
 {
 	template< class T > void safeDelete( T*& pVal )
@@ -0,0 +1,102 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#include "helpers/_2RealNameIndex.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+namespace _2Real
+{
+
+	namespace
+	{
+		inline bool isWhitespace( const char c )
+		{
+			return ( c == ' ' || c == '\t' || c == '\n' );
+		}
+
+		inline char lower( const char c )
+		{
+			return static_cast< char >( tolower( static_cast< unsigned char >( c ) ) );
+		}
+	}
+
+	void NameIndex::strip( std::string const& name, const char *&begin, const char *&end )
+	{
+		begin = name.data();
+		end = begin + name.size();
+		while ( begin != end && isWhitespace( *begin ) ) ++begin;
+		while ( end != begin && isWhitespace( *( end-1 ) ) ) --end;
+	}
+
+	// fnv-1a over the lower case chars
+	unsigned int NameIndex::hash( const char *begin, const char *end )
+	{
+		unsigned int h = 2166136261u;
+		for ( const char *c = begin; c != end; ++c )
+		{
+			h ^= static_cast< unsigned char >( lower( *c ) );
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	bool NameIndex::equals( std::string const& name, const char *begin, const char *end )
+	{
+		if ( name.size() != static_cast< size_t >( end - begin ) ) return false;
+		for ( size_t i=0; i<name.size(); ++i )
+		{
+			if ( lower( name[ i ] ) != lower( begin[ i ] ) ) return false;
+		}
+		return true;
+	}
+
+	void NameIndex::insert( std::string const& name, const unsigned int index )
+	{
+		if ( find( name ) != NotFound ) return;
+
+		const char *begin, *end;
+		strip( name, begin, end );
+
+		Entry entry;
+		entry.hash = hash( begin, end );
+		entry.name.assign( begin, end );
+		entry.index = index;
+		m_Entries.insert( std::upper_bound( m_Entries.begin(), m_Entries.end(), entry, HashLess() ), entry );
+	}
+
+	unsigned int NameIndex::find( std::string const& name ) const
+	{
+		const char *begin, *end;
+		strip( name, begin, end );
+
+		const unsigned int h = hash( begin, end );
+		for ( EntryConstIterator it = std::lower_bound( m_Entries.begin(), m_Entries.end(), h, HashLess() ); it != m_Entries.end() && it->hash == h; ++it )
+		{
+			if ( equals( it->name, begin, end ) ) return it->index;
+		}
+		return NotFound;
+	}
+
+	void NameIndex::clear()
+	{
+		m_Entries.clear();
+	}
+
+}
@@ -0,0 +1,71 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace _2Real
+{
+
+	// case insensitive name -> index map for the inlets & outlets of a block, built once when the block is created.
+	// a lookup hashes the name on the fly, ignoring case & surrounding whitespace ( like trim & toLower would ),
+	// so it neither allocates nor copies any string
+	class NameIndex
+	{
+
+	public:
+
+		enum { NotFound = 0xffffffff };
+
+		// a name that is already present keeps its first index
+		void				insert( std::string const& name, const unsigned int index );
+		unsigned int		find( std::string const& name ) const;
+		void				clear();
+
+	private:
+
+		struct Entry
+		{
+			unsigned int	hash;
+			std::string		name;
+			unsigned int	index;
+		};
+
+		// both argument orders, for msvc's debug checks
+		struct HashLess
+		{
+			bool operator()( Entry const& a, Entry const& b ) const			{ return a.hash < b.hash; }
+			bool operator()( Entry const& a, const unsigned int b ) const	{ return a.hash < b; }
+			bool operator()( const unsigned int a, Entry const& b ) const	{ return a < b.hash; }
+		};
+
+		typedef std::vector< Entry >					Entries;
+		typedef std::vector< Entry >::iterator			EntryIterator;
+		typedef std::vector< Entry >::const_iterator	EntryConstIterator;
+
+		static void			strip( std::string const& name, const char *&begin, const char *&end );
+		static unsigned int	hash( const char *begin, const char *end );
+		static bool			equals( std::string const& name, const char *begin, const char *end );
+
+		Entries				m_Entries;		// sorted by hash
+
+	};
+
+}
@@ -21,6 +21,8 @@
 #include "helpers/_2RealAny.h"
 
 #include <set>
+#include <vector>
+#include <algorithm>
 
 namespace _2Real
 {
@@ -106,6 +108,9 @@ namespace _2Real
 
 	};
 
+	// every value an inlet receives is validated against its options, so the values are indexed
+	// once: all options have the same type, and the set is already sorted, so a lookup is a single
+	// type check & a binary search over a plain array
 	class AnyOptionSet
 	{
 
@@ -115,13 +120,34 @@ namespace _2Real
 		typedef std::set< AnyOption >::iterator				OptionIterator;
 		typedef std::set< AnyOption >::const_iterator		OptionConstIterator;
 
+		typedef std::vector< Any >							Values;
+		typedef std::vector< Any >::const_iterator			ValueConstIterator;
+
+		struct IsLess
+		{
+			bool operator()( Any const& lhs, Any const& rhs ) const { return lhs.isLessThan( rhs ); }
+		};
+
 		Options			m_Options;
+		Values			m_Values;
+
+		void buildIndex()
+		{
+			m_Values.reserve( m_Options.size() );
+			for ( OptionConstIterator it = m_Options.begin(); it != m_Options.end(); ++it )
+			{
+				m_Values.push_back( it->getValue() );
+			}
+		}
 
 	public:
 
-		AnyOptionSet() : m_Options() {}
+		AnyOptionSet() : m_Options(), m_Values() {}
 
-		AnyOptionSet( std::set< AnyOption > const& options ) : m_Options( options ) {}
+		AnyOptionSet( std::set< AnyOption > const& options ) : m_Options( options ), m_Values()
+		{
+			buildIndex();
+		}
 
 		bool isEmpty() const
 		{
@@ -130,14 +156,13 @@ namespace _2Real
 
 		bool isOption( Any const& any ) const
 		{
-			for ( OptionConstIterator it = m_Options.begin(); it != m_Options.end(); ++it )
+			if ( m_Values.empty() || !m_Values.front().hasSameType( any ) )
 			{
-				if ( it->isEqualTo( any ) )
-				{
-					return true;
-				}
+				return false;
 			}
-			return false;
+
+			ValueConstIterator it = std::lower_bound( m_Values.begin(), m_Values.end(), any, IsLess() );
+			return ( it != m_Values.end() && it->isEqualTo( any ) );
 		}
 
 		template< typename TData >
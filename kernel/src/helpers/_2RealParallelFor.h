@@ -0,0 +1,65 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include "helpers/_2RealCallback.h"
+
+#include <algorithm>
+
+namespace _2Real
+{
+
+	// runs body.invoke( i ) for every i in [ 0, count ), possibly on several threads, and returns once all
+	// of them are done. the calling thread takes part in the work, so this may be called from a worker
+	// ( see ThreadPool ). if the body throws, the first exception is rethrown to the caller
+	class AbstractParallelExecutor
+	{
+
+	public:
+
+		virtual ~AbstractParallelExecutor() {}
+		virtual void parallelFor( const unsigned int count, AbstractCallback< const unsigned int > &body ) = 0;
+
+	};
+
+	// splits [ 0, size ) into ranges of grain elements ( the last one may be shorter ), e.g. the rows of
+	// an image into bands: one parallelFor item per range rather than per row keeps the overhead low
+	class RangePartition
+	{
+
+	public:
+
+		RangePartition( const unsigned int size, const unsigned int grain ) :
+			m_Size( size ),
+			m_Grain( grain > 0 ? grain : 1 )
+		{
+		}
+
+		unsigned int	getCount() const { return m_Size / m_Grain + ( m_Size % m_Grain > 0 ? 1 : 0 ); }
+		unsigned int	getBegin( const unsigned int index ) const { return index * m_Grain; }
+		unsigned int	getEnd( const unsigned int index ) const { return std::min( m_Size, ( index + 1 ) * m_Grain ); }
+
+	private:
+
+		unsigned int	m_Size;
+		unsigned int	m_Grain;
+
+	};
+
+}
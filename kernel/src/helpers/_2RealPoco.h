@@ -26,4 +26,5 @@
 #include "Poco/Thread.h"
 #include "Poco/Runnable.h"
 #include "Poco/Event.h"
-#include "Poco/ThreadLocal.h"
\ No newline at end of file
+#include "Poco/ThreadLocal.h"
+#include "Poco/Environment.h"
\ No newline at end of file
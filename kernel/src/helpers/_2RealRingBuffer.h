@@ -0,0 +1,169 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include "helpers/_2RealAtomic.h"
+
+#include <vector>
+
+namespace _2Real
+{
+
+	// bounded, preallocated multi producer / multi consumer queue ( d. vyukov's algorithm ):
+	// every cell carries a sequence number, so producers and consumers only ever race for a position
+	// via compare and swap, and no locks or allocations are needed once the ring is constructed.
+	// the capacity is rounded up to a power of two; the logical size limit may be smaller than that
+	template< typename T >
+	class RingBuffer
+	{
+
+	public:
+
+		RingBuffer( const unsigned int maxSize, T const& empty ) :
+			m_Cells( roundUpToPowerOfTwo( maxSize ) ),
+			m_Mask( static_cast< unsigned long >( m_Cells.size() - 1 ) ),
+			m_MaxSize( maxSize > 0 ? maxSize : 1 ),
+			m_Empty( empty ),
+			m_EnqueuePos( 0 ),
+			m_DequeuePos( 0 )
+		{
+			for ( unsigned int i=0; i<m_Cells.size(); ++i )
+			{
+				m_Cells[ i ].sequence.store( static_cast< long >( i ) );
+				m_Cells[ i ].data = m_Empty;
+			}
+		}
+
+		unsigned int getMaxSize() const		{ return m_MaxSize; }
+		unsigned int getCapacity() const	{ return static_cast< unsigned int >( m_Cells.size() ); }
+
+		// approximate while producers / consumers are active
+		unsigned int getSize() const
+		{
+			const long size = m_EnqueuePos.load() - m_DequeuePos.load();
+			return ( size > 0 ? static_cast< unsigned int >( size ) : 0 );
+		}
+
+		bool isFull() const					{ return getSize() >= m_MaxSize; }
+		bool isEmpty() const				{ return getSize() == 0; }
+
+		// returns false if the ring already holds max size items
+		bool tryPush( T const& data )
+		{
+			Cell *cell;
+			long pos = m_EnqueuePos.load();
+			while ( true )
+			{
+				if ( pos - m_DequeuePos.load() >= static_cast< long >( m_MaxSize ) )
+				{
+					return false;
+				}
+
+				cell = &m_Cells[ static_cast< unsigned long >( pos ) & m_Mask ];
+				const long dif = cell->sequence.load() - pos;
+				if ( dif == 0 )
+				{
+					if ( m_EnqueuePos.compareAndSwap( pos, pos + 1 ) ) break;
+					pos = m_EnqueuePos.load();
+				}
+				else if ( dif < 0 )
+				{
+					return false;
+				}
+				else
+				{
+					pos = m_EnqueuePos.load();
+				}
+			}
+
+			cell->data = data;
+			cell->sequence.store( pos + 1 );
+			return true;
+		}
+
+		// returns false if the ring is empty
+		bool tryPop( T &data )
+		{
+			Cell *cell;
+			long pos = m_DequeuePos.load();
+			while ( true )
+			{
+				cell = &m_Cells[ static_cast< unsigned long >( pos ) & m_Mask ];
+				const long dif = cell->sequence.load() - ( pos + 1 );
+				if ( dif == 0 )
+				{
+					if ( m_DequeuePos.compareAndSwap( pos, pos + 1 ) ) break;
+					pos = m_DequeuePos.load();
+				}
+				else if ( dif < 0 )
+				{
+					return false;
+				}
+				else
+				{
+					pos = m_DequeuePos.load();
+				}
+			}
+
+			data = cell->data;
+			cell->data = m_Empty;				// release the payload now, not when the cell is reused
+			cell->sequence.store( pos + static_cast< long >( m_Mask ) + 1 );
+			return true;
+		}
+
+		// removes one item without returning it
+		bool tryDrop()
+		{
+			T tmp( m_Empty );
+			return tryPop( tmp );
+		}
+
+	private:
+
+		RingBuffer( RingBuffer const& src );
+		RingBuffer& operator=( RingBuffer const& src );
+
+		struct Cell
+		{
+			Cell() {}
+			Cell( Cell const& src ) : sequence( src.sequence.load() ), data( src.data ) {}
+
+			AtomicLong		sequence;
+			T				data;
+		};
+
+		static unsigned int roundUpToPowerOfTwo( const unsigned int size )
+		{
+			unsigned int result = 2;
+			while ( result < size ) result <<= 1;
+			return result;
+		}
+
+		std::vector< Cell >		m_Cells;
+		const unsigned long		m_Mask;
+		const unsigned int		m_MaxSize;
+		const T					m_Empty;
+
+		AtomicLong				m_EnqueuePos;
+		char					m_Padding[ 64 ];		// keep producers & consumers off each other's cache line
+		AtomicLong				m_DequeuePos;
+
+	};
+
+}
\ No newline at end of file
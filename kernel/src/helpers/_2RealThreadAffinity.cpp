@@ -0,0 +1,162 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#include "helpers/_2RealThreadAffinity.h"
+#include "helpers/_2RealPoco.h"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#ifdef _2REAL_WINDOWS
+	#include <windows.h>
+#elif defined( _2REAL_UNIX )
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+namespace _2Real
+{
+
+	namespace
+	{
+		CpuSet getAllCpus()
+		{
+			CpuSet cpus;
+			const unsigned int count = std::max< unsigned int >( Poco::Environment::processorCount(), 1 );
+			for ( unsigned int i=0; i<count; ++i ) cpus.push_back( i );
+			return cpus;
+		}
+
+#ifdef _2REAL_UNIX
+		// sysfs cpu lists look like "0-7,16-23"
+		CpuSet parseCpuList( std::string const& list )
+		{
+			CpuSet cpus;
+			std::istringstream in( list );
+			std::string range;
+			while ( std::getline( in, range, ',' ) )
+			{
+				unsigned int first = 0, last = 0;
+				char dash = 0;
+				std::istringstream r( range );
+				if ( !( r >> first ) ) continue;
+				if ( r >> dash >> last )
+				{
+					for ( unsigned int i=first; i<=last; ++i ) cpus.push_back( i );
+				}
+				else
+				{
+					cpus.push_back( first );
+				}
+			}
+			return cpus;
+		}
+
+		bool readNodeCpus( const unsigned int node, CpuSet &cpus )
+		{
+			std::ostringstream path;
+			path << "/sys/devices/system/node/node" << node << "/cpulist";
+			std::ifstream file( path.str().c_str() );
+			std::string list;
+			if ( !file.is_open() || !std::getline( file, list ) ) return false;
+			cpus = parseCpuList( list );
+			return true;
+		}
+#endif
+	}
+
+	unsigned int ThreadAffinity::getNumberOfNumaNodes()
+	{
+#ifdef _2REAL_WINDOWS
+		ULONG highest = 0;
+		if ( !GetNumaHighestNodeNumber( &highest ) ) return 1;
+		return static_cast< unsigned int >( highest ) + 1;
+#elif defined( _2REAL_UNIX )
+		unsigned int count = 0;
+		CpuSet cpus;
+		while ( readNodeCpus( count, cpus ) ) ++count;
+		return std::max< unsigned int >( count, 1 );
+#else
+		return 1;
+#endif
+	}
+
+	CpuSet ThreadAffinity::getCpusOfNumaNode( const unsigned int node )
+	{
+#ifdef _2REAL_WINDOWS
+		ULONGLONG mask = 0;
+		if ( !GetNumaNodeProcessorMask( static_cast< UCHAR >( node ), &mask ) ) return ( node == 0 ? getAllCpus() : CpuSet() );
+		CpuSet cpus;
+		for ( unsigned int i=0; i<64; ++i )
+		{
+			if ( mask & ( ULONGLONG( 1 ) << i ) ) cpus.push_back( i );
+		}
+		return cpus;
+#elif defined( _2REAL_UNIX )
+		CpuSet cpus;
+		if ( !readNodeCpus( node, cpus ) && node == 0 ) return getAllCpus();
+		return cpus;
+#else
+		return ( node == 0 ? getAllCpus() : CpuSet() );
+#endif
+	}
+
+	unsigned int ThreadAffinity::getNumaNode( CpuSet const& cpus )
+	{
+		if ( cpus.empty() ) return 0;
+
+		const unsigned int numNodes = getNumberOfNumaNodes();
+		for ( unsigned int node=0; node<numNodes; ++node )
+		{
+			CpuSet nodeCpus = getCpusOfNumaNode( node );
+			bool containsAll = true;
+			for ( CpuSetConstIterator it = cpus.begin(); it != cpus.end() && containsAll; ++it )
+			{
+				containsAll = ( std::find( nodeCpus.begin(), nodeCpus.end(), *it ) != nodeCpus.end() );
+			}
+			if ( containsAll ) return node;
+		}
+		return 0;
+	}
+
+	bool ThreadAffinity::pinCurrentThread( CpuSet const& cpus )
+	{
+		if ( cpus.empty() ) return false;
+
+#ifdef _2REAL_WINDOWS
+		DWORD_PTR mask = 0;
+		for ( CpuSetConstIterator it = cpus.begin(); it != cpus.end(); ++it )
+		{
+			if ( *it < sizeof( DWORD_PTR ) * 8 ) mask |= ( DWORD_PTR( 1 ) << *it );
+		}
+		return ( mask != 0 && SetThreadAffinityMask( GetCurrentThread(), mask ) != 0 );
+#elif defined( _2REAL_UNIX )
+		cpu_set_t set;
+		CPU_ZERO( &set );
+		for ( CpuSetConstIterator it = cpus.begin(); it != cpus.end(); ++it )
+		{
+			if ( *it < CPU_SETSIZE ) CPU_SET( *it, &set );
+		}
+		return ( pthread_setaffinity_np( pthread_self(), sizeof( cpu_set_t ), &set ) == 0 );
+#else
+		return false;
+#endif
+	}
+
+}
@@ -0,0 +1,47 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2011 Fachhochschule Salzburg GmbH
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#pragma once
+
+#include <vector>
+
+namespace _2Real
+{
+
+	typedef std::vector< unsigned int >						CpuSet;
+	typedef std::vector< unsigned int >::iterator			CpuSetIterator;
+	typedef std::vector< unsigned int >::const_iterator		CpuSetConstIterator;
+
+	// processor topology & pinning of threads to processors. supported on windows ( first processor group only,
+	// i.e. 64 processors ) and linux; elsewhere all processors are reported as one node & pinning does nothing
+	class ThreadAffinity
+	{
+
+	public:
+
+		static unsigned int		getNumberOfNumaNodes();
+		static CpuSet			getCpusOfNumaNode( const unsigned int node );
+		// the node all of the cpus belong to, 0 if they are spread over several nodes
+		static unsigned int		getNumaNode( CpuSet const& cpus );
+
+		// restricts the calling thread to the cpus, false if this is not supported or failed
+		static bool				pinCurrentThread( CpuSet const& cpus );
+
+	};
+
+}
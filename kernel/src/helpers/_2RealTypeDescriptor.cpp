@@ -17,10 +17,13 @@
 */
 
 #include "helpers/_2RealTypeDescriptor.h"
+#include "helpers/_2RealPoco.h"
+
+#include <map>
 
 namespace _2Real
 {
-		TypeDescriptor::TypeDescriptor( std::type_info const& info, Type const& type, std::string const& name, TypeDescriptor * nestedType ) :
+		TypeDescriptor::TypeDescriptor( std::type_info const& info, Type const& type, std::string const& name, TypeDescriptor const* nestedType ) :
 			m_NestedType( nestedType ),
 			m_Type( type ),
 			m_TypeCategory( TypeCategory::CONTAINER ),
@@ -40,9 +43,9 @@ namespace _2Real
 		{
 		}
 
+		// nested types are interned as well, and not owned
 		TypeDescriptor::~TypeDescriptor()
 		{
-			delete m_NestedType;
 		}
 
 		//std::type_info const& TypeDescriptor::getTypeInfo() const
@@ -82,7 +85,11 @@ namespace _2Real
 
 		bool TypeDescriptor::operator==( TypeDescriptor const& other ) const
 		{
-			if ( m_Type == other.m_Type )
+			if ( this == &other )
+			{
+				return true;
+			}
+			else if ( m_Type == other.m_Type )
 			{
 				if ( m_NestedType == nullptr )
 				{
@@ -103,4 +110,41 @@ namespace _2Real
 			}
 			else return false;
 		}
+
+		namespace
+		{
+			typedef std::map< std::string, TypeDescriptor * >	Descriptors;
+
+			struct Registry
+			{
+				Poco::FastMutex		access;
+				Descriptors			descriptors;
+			};
+
+			Registry & getRegistry()
+			{
+				// never destroyed, descriptors may be used during static destruction
+				static Registry *registry = new Registry();
+				return *registry;
+			}
+
+			// constructs the registry before main, so the lazy initialization above is never raced
+			Registry &s_Registry = getRegistry();
+		}
+
+		TypeDescriptor const* TypeRegistry::intern( TypeDescriptor *descriptor )
+		{
+			Registry &registry = getRegistry();
+			Poco::FastMutex::ScopedLock lock( registry.access );
+
+			Descriptors::iterator it = registry.descriptors.find( descriptor->m_LongTypename );
+			if ( it != registry.descriptors.end() )
+			{
+				delete descriptor;
+				return it->second;
+			}
+
+			registry.descriptors[ descriptor->m_LongTypename ] = descriptor;
+			return descriptor;
+		}
 }
\ No newline at end of file
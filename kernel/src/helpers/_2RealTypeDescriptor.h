@@ -35,12 +35,14 @@ namespace _2Real
 	class TypeCategory;
 	class Type;
 
+	// descriptors are interned: there is exactly one immutable instance per type ( and module ), obtained via getTypeDescriptor< T >()
+	// they are never deleted, so anyone may hold on to the pointer
 	class TypeDescriptor
 	{
 
 	public:
 
-		TypeDescriptor( std::type_info const& info, Type const& type, std::string const& name, TypeDescriptor * nestedType );
+		TypeDescriptor( std::type_info const& info, Type const& type, std::string const& name, TypeDescriptor const* nestedType );
 		TypeDescriptor( std::type_info const& info, Type const& type, std::string const& name, TypeCategory const& category );
 		~TypeDescriptor();
 
@@ -54,6 +56,12 @@ namespace _2Real
 		bool operator!=( TypeDescriptor const& other ) const;
 		bool operator==( TypeDescriptor const& other ) const;
 
+		// exact type identity: a pointer compare, unless the descriptors come from different modules
+		bool isSameType( TypeDescriptor const& other ) const
+		{
+			return ( this == &other || m_TypeInfo == other.m_TypeInfo );
+		}
+
 		TypeDescriptor						const* const m_NestedType;
 		Type								const m_Type;
 		TypeCategory						const m_TypeCategory;
@@ -61,5 +69,24 @@ namespace _2Real
 		std::string							const m_TypeName;
 		std::string							const m_LongTypename;
 
+	private:
+
+		TypeDescriptor( TypeDescriptor const& src );
+		TypeDescriptor& operator=( TypeDescriptor const& src );
+
+	};
+
+	// process wide set of interned descriptors, keyed by the type's long name.
+	// the app & every bundle library link their own copy of the kernel, so each module has its own registry;
+	// that's why isSameType falls back to comparing the type_info
+	class TypeRegistry
+	{
+
+	public:
+
+		// returns the registered descriptor for the type, registering the given one if there is none yet;
+		// takes ownership of the descriptor ( which is deleted if it's a duplicate )
+		static TypeDescriptor const* intern( TypeDescriptor *descriptor );
+
 	};
 }
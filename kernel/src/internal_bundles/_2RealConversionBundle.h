@@ -54,23 +54,30 @@ namespace _2Real
 	template< typename TSrc, typename TDst >
 	class ConversionBlock;
 
+	// row by row, b/c the rows of an ImageT may be padded
+	template< typename T >
+	void copyToImage( ImageT< T > const& src, Image &dst, ImageType const& type )
+	{
+		const unsigned int w = src.getWidth();
+		const unsigned int h = src.getHeight();
+		dst.allocate( type, w, h, src.getChannelOrder() );
+
+		const size_t rowBytes = static_cast< size_t >( w ) * src.getNumberOfChannels() * sizeof( T );
+		const size_t pitch = ( src.getRowPitch() > 0 ? src.getRowPitch() : rowBytes );
+		unsigned char const* s = reinterpret_cast< unsigned char const* >( src.getData() );
+		unsigned char *d = dst.getData();
+		for ( unsigned int y=0; y<h; ++y )
+		{
+			memcpy( d + y * dst.getRowPitch(), s + y * pitch, rowBytes );
+		}
+	}
+
 	template< >
 	class ConversionBlock< Image8U, Image > : public AbstractConversionBlock
 	{
 		void update()
 		{
-			Image8U const& src = m_Src.getReadableRef< Image8U >();
-			Image &dst = m_Dst.getWriteableRef< Image >();
-
-			const unsigned char w = src.getWidth();
-			const unsigned char h = src.getHeight();
-			const unsigned char c = src.getNumberOfChannels();
-			const unsigned int sz = w*h*c;
-			unsigned char *data = new unsigned char[ sz ];
-
-			memcpy( data, src.getData(), sz );
-
-			dst.assign( data, true, src.getWidth(), src.getHeight(), src.getChannelOrder() );
+			copyToImage( m_Src.getReadableRef< Image8U >(), m_Dst.getWriteableRef< Image >(), ImageType::UNSIGNED_BYTE );
 		}
 	};
 
@@ -79,18 +86,7 @@ namespace _2Real
 	{
 		void update()
 		{
-			Image16U const& src = m_Src.getReadableRef< Image16U >();
-			Image &dst = m_Dst.getWriteableRef< Image >();
-
-			const unsigned char w = src.getWidth();
-			const unsigned char h = src.getHeight();
-			const unsigned char c = src.getNumberOfChannels();
-			const unsigned int sz = w*h*c;
-			unsigned short *data = new unsigned short[ sz ];
-
-			memcpy( data, src.getData(), sz*sizeof( unsigned short ) );
-
-			dst.assign( data, true, src.getWidth(), src.getHeight(), src.getChannelOrder() );
+			copyToImage( m_Src.getReadableRef< Image16U >(), m_Dst.getWriteableRef< Image >(), ImageType::UNSIGNED_SHORT );
 		}
 	};
 
@@ -99,18 +95,7 @@ namespace _2Real
 	{
 		void update()
 		{
-			Image32F const& src = m_Src.getReadableRef< Image32F >();
-			Image &dst = m_Dst.getWriteableRef< Image >();
-
-			const unsigned char w = src.getWidth();
-			const unsigned char h = src.getHeight();
-			const unsigned char c = src.getNumberOfChannels();
-			const unsigned int sz = w*h*c;
-			float *data = new float[ sz ];
-
-			memcpy( data, src.getData(), sz*sizeof( float ) );
-
-			dst.assign( data, true, src.getWidth(), src.getHeight(), src.getChannelOrder() );
+			copyToImage( m_Src.getReadableRef< Image32F >(), m_Dst.getWriteableRef< Image >(), ImageType::FLOAT );
 		}
 	};
 
@@ -119,26 +104,15 @@ namespace _2Real
 	{
 		void update()
 		{
-			Image64F const& src = m_Src.getReadableRef< Image64F >();
-			Image &dst = m_Dst.getWriteableRef< Image >();
-
-			const unsigned char w = src.getWidth();
-			const unsigned char h = src.getHeight();
-			const unsigned char c = src.getNumberOfChannels();
-			const unsigned int sz = w*h*c;
-			double *data = new double[ sz ];
-
-			memcpy( data, src.getData(), sz*sizeof( double ) );
-
-			dst.assign( data, true, src.getWidth(), src.getHeight(), src.getChannelOrder() );
+			copyToImage( m_Src.getReadableRef< Image64F >(), m_Dst.getWriteableRef< Image >(), ImageType::DOUBLE );
 		}
 	};
 
 	template< typename TSrc, typename TDst >
 	std::string getConversionName()
 	{
-		TypeDescriptor *tSrc = createTypeDescriptor< TSrc >();
-		TypeDescriptor *tDst = createTypeDescriptor< TDst >();
+		TypeDescriptor const* tSrc = getTypeDescriptor< TSrc >();
+		TypeDescriptor const* tDst = getTypeDescriptor< TDst >();
 
 		std::string src = tSrc->m_TypeName;
 		std::string dst = tDst->m_TypeName;
@@ -152,9 +126,6 @@ namespace _2Real
 			if ( dst[i] == ' ' ) dst[i] = '_';
 		}
 
-		delete tDst;
-		delete tSrc;
-
 		std::string conversion = src + "_to_" + dst;
 		return conversion;
 	}
@@ -0,0 +1,269 @@
+/*
+	CADET - Center for Advances in Digital Entertainment Technologies
+	Copyright 2012 Fachhochschule Salzburg GmbH
+
+		http://www.cadet.at
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+#include "datatypes/_2RealImageConversion.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#ifndef _UNIX
+#ifdef _DEBUG
+	#include "vld.h"
+#endif
+#endif
+
+using namespace std;
+using namespace _2Real;
+
+// compares the simd kernels of ImageConversion against its plain c++ code: every channel order pair, the depth
+// conversions with & without saturation, and widths that leave tails of every length behind the vector loops.
+// sources are contiguous as well as sub images of a padded image ( converted row by row ).
+// writes past the end of a row only show up with a memory checker ( vld in debug builds, or asan ).
+// usage: ImageConversionTestingApp [ number of failures to print, default 10 ]
+
+const ImageChannelOrder::CHANNEL_CODE AllOrders[] = {
+	ImageChannelOrder::RGBA, ImageChannelOrder::BGRA, ImageChannelOrder::ARGB, ImageChannelOrder::ABGR,
+	ImageChannelOrder::RGBX, ImageChannelOrder::BGRX, ImageChannelOrder::XRGB, ImageChannelOrder::XBGR,
+	ImageChannelOrder::RGB, ImageChannelOrder::BGR,
+	ImageChannelOrder::R, ImageChannelOrder::G, ImageChannelOrder::B, ImageChannelOrder::A };
+const unsigned int NumOrders = sizeof( AllOrders ) / sizeof( AllOrders[ 0 ] );
+
+const char *InstructionSets[] = { "sse2", "ssse3", "avx2" };
+const unsigned int NumInstructionSets = sizeof( InstructionSets ) / sizeof( InstructionSets[ 0 ] );
+
+class ConversionTest
+{
+
+public:
+
+	ConversionTest( const unsigned int maxReports ) : m_Checks( 0 ), m_Failures( 0 ), m_MaxReports( maxReports ), m_Seed( 12345 ) {}
+
+	unsigned int getNumberOfChecks() const { return m_Checks; }
+	unsigned int getNumberOfFailures() const { return m_Failures; }
+
+	// 1..70 covers every tail of the 16 & 32 byte loops for all pixel sizes; a few larger ones for good measure
+	static vector< unsigned int > getWidths()
+	{
+		vector< unsigned int > widths;
+		for ( unsigned int w=1; w<=70; ++w ) widths.push_back( w );
+		widths.push_back( 127 );
+		widths.push_back( 128 );
+		widths.push_back( 131 );
+		widths.push_back( 257 );
+		return widths;
+	}
+
+	// the source is filled with random values, including the extremes & values outside of the target range
+	Image createSource( ImageType const& type, ImageChannelOrder const& order, const unsigned int w, const unsigned int h, const bool subImage )
+	{
+		// a sub image starts at an odd offset of a larger image with padded rows
+		Image parent;
+		if ( subImage )		parent.allocate( type, w + 5, h + 2, order, true );
+		else				parent.allocate( type, w, h, order );
+
+		for ( unsigned int y=0; y<parent.getHeight(); ++y )
+		{
+			unsigned char *row = parent.getRow( y );
+			const unsigned int count = parent.getWidth() * parent.getNumberOfChannels();
+			for ( unsigned int i=0; i<count; ++i )
+			{
+				const unsigned int r = random();
+				switch ( type.getDatatype() )
+				{
+				case ImageType::UNSIGNED_BYTE:
+					row[ i ] = static_cast< unsigned char >( r );
+					break;
+				case ImageType::UNSIGNED_SHORT:
+					reinterpret_cast< unsigned short * >( row )[ i ] = ( r % 7 == 0 ? 65535 : ( r % 11 == 0 ? 0 : static_cast< unsigned short >( r ) ) );
+					break;
+				case ImageType::FLOAT:
+					reinterpret_cast< float * >( row )[ i ] = ( r % 65536 ) / 32768.f - .5f;		// -0.5 .. 1.5
+					break;
+				case ImageType::DOUBLE:
+					reinterpret_cast< double * >( row )[ i ] = ( r % 65536 ) / 32768. - .5;
+					break;
+				}
+			}
+		}
+
+		return subImage ? parent.getSubImage( 3, 1, w, h ) : parent;
+	}
+
+	// converts with the plain c++ code & with the instruction set, then compares the results; integers must match
+	// exactly, floats may differ in the last bits because the kernels compute in single precision
+	void check( Image const& src, ImageType const& type, ImageChannelOrder const& order, const double scale, const char *isa, std::string const& what )
+	{
+		Image expected, actual;
+		ImageConversion::limitInstructionSet( "none" );
+		ImageConversion::convert( src, expected, type, order, scale );
+		ImageConversion::limitInstructionSet( isa );
+		ImageConversion::convert( src, actual, type, order, scale );
+
+		++m_Checks;
+		std::string error;
+		if ( !compare( expected, actual, error ) )
+		{
+			if ( ++m_Failures <= m_MaxReports )
+			{
+				cout << "FAILED " << isa << ": " << what << " " << src.getWidth() << "x" << src.getHeight() << ( src.isContiguous() ? "" : " ( sub image )" ) << " - " << error << endl;
+			}
+		}
+	}
+
+private:
+
+	unsigned int random()
+	{
+		m_Seed = m_Seed * 1103515245 + 12345;
+		return ( m_Seed >> 8 ) & 0xffffff;
+	}
+
+	static bool compare( Image const& expected, Image const& actual, std::string &error )
+	{
+		if ( expected.getWidth() != actual.getWidth() || expected.getHeight() != actual.getHeight()
+			|| expected.getChannelOrder() != actual.getChannelOrder() || expected.getImageType() != actual.getImageType() )
+		{
+			error = "different shape";
+			return false;
+		}
+
+		const unsigned int count = expected.getWidth() * expected.getNumberOfChannels();
+		for ( unsigned int y=0; y<expected.getHeight(); ++y )
+		{
+			unsigned char const* e = expected.getRow( y );
+			unsigned char const* a = actual.getRow( y );
+			for ( unsigned int i=0; i<count; ++i )
+			{
+				double ve, va, tolerance;
+				switch ( expected.getImageType().getDatatype() )
+				{
+				case ImageType::UNSIGNED_BYTE:
+					ve = e[ i ];
+					va = a[ i ];
+					tolerance = 0.;
+					break;
+				case ImageType::UNSIGNED_SHORT:
+					ve = reinterpret_cast< unsigned short const* >( e )[ i ];
+					va = reinterpret_cast< unsigned short const* >( a )[ i ];
+					tolerance = 0.;
+					break;
+				case ImageType::FLOAT:
+					ve = reinterpret_cast< float const* >( e )[ i ];
+					va = reinterpret_cast< float const* >( a )[ i ];
+					tolerance = 1e-6 * std::max( 1., fabs( ve ) );
+					break;
+				default:
+					ve = reinterpret_cast< double const* >( e )[ i ];
+					va = reinterpret_cast< double const* >( a )[ i ];
+					tolerance = 0.;
+					break;
+				}
+
+				if ( fabs( ve - va ) > tolerance )
+				{
+					std::ostringstream msg;
+					msg << "row " << y << ", value " << i << ": expected " << ve << ", got " << va;
+					error = msg.str();
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	unsigned int		m_Checks;
+	unsigned int		m_Failures;
+	unsigned int		m_MaxReports;
+	unsigned int		m_Seed;
+
+};
+
+int main( int argc, char *argv[] )
+{
+	unsigned int maxReports = 10;
+	if ( argc > 1 ) maxReports = atoi( argv[ 1 ] );
+
+	const char *detected = ImageConversion::getInstructionSet();
+	cout << "instruction set of this cpu: " << detected << endl;
+
+	ConversionTest test( maxReports );
+	vector< unsigned int > widths = ConversionTest::getWidths();
+
+	for ( unsigned int s=0; s<NumInstructionSets; ++s )
+	{
+		// not supported by the cpu: the limit leaves a lower instruction set, which was tested already
+		const char *isa = InstructionSets[ s ];
+		ImageConversion::limitInstructionSet( isa );
+		if ( std::string( ImageConversion::getInstructionSet() ) != isa )
+		{
+			cout << "skipping " << isa << endl;
+			continue;
+		}
+
+		const unsigned int checksBefore = test.getNumberOfChecks();
+		const unsigned int failuresBefore = test.getNumberOfFailures();
+
+		for ( unsigned int wi=0; wi<widths.size(); ++wi )
+		{
+			const unsigned int w = widths[ wi ];
+			for ( unsigned int sub=0; sub<2; ++sub )
+			{
+				const unsigned int h = ( sub ? 3 : 2 );
+
+				// every swizzle, 8 bit
+				for ( unsigned int i=0; i<NumOrders; ++i )
+				{
+					Image src = test.createSource( ImageType::UNSIGNED_BYTE, AllOrders[ i ], w, h, sub != 0 );
+					for ( unsigned int j=0; j<NumOrders; ++j )
+					{
+						if ( i == j ) continue;
+						std::ostringstream what;
+						what << "swizzle " << ImageChannelOrder( AllOrders[ i ] ).toString() << " -> " << ImageChannelOrder( AllOrders[ j ] ).toString();
+						test.check( src, ImageType::UNSIGNED_BYTE, AllOrders[ j ], 1., isa, what.str() );
+					}
+				}
+
+				// depth, with the default scale & with one that saturates
+				Image src16 = test.createSource( ImageType::UNSIGNED_SHORT, ImageChannelOrder::RGBA, w, h, sub != 0 );
+				Image srcF = test.createSource( ImageType::FLOAT, ImageChannelOrder::RGBA, w, h, sub != 0 );
+				Image src8 = test.createSource( ImageType::UNSIGNED_BYTE, ImageChannelOrder::RGBA, w, h, sub != 0 );
+
+				test.check( src16, ImageType::UNSIGNED_BYTE, ImageChannelOrder::RGBA, 255. / 65535., isa, "16u -> 8u" );
+				test.check( src16, ImageType::UNSIGNED_BYTE, ImageChannelOrder::RGBA, 1. / 16., isa, "16u -> 8u, saturating" );
+				test.check( srcF, ImageType::UNSIGNED_BYTE, ImageChannelOrder::RGBA, 255., isa, "32f -> 8u, saturating" );
+				test.check( src16, ImageType::FLOAT, ImageChannelOrder::RGBA, 1. / 65535., isa, "16u -> 32f" );
+				test.check( src8, ImageType::FLOAT, ImageChannelOrder::RGBA, 1. / 255., isa, "8u -> 32f" );
+
+				// depth & channel order at once
+				test.check( src16, ImageType::UNSIGNED_BYTE, ImageChannelOrder::BGR, 255. / 65535., isa, "16u rgba -> 8u bgr" );
+				test.check( src8, ImageType::FLOAT, ImageChannelOrder::XBGR, 1. / 255., isa, "8u rgba -> 32f xbgr" );
+			}
+		}
+
+		cout << isa << ": " << test.getNumberOfChecks() - checksBefore << " conversions, " << test.getNumberOfFailures() - failuresBefore << " failed" << endl;
+	}
+
+	ImageConversion::limitInstructionSet( detected );
+
+	cout << ( test.getNumberOfFailures() == 0 ? "all conversions match" : "MISMATCHES FOUND" ) << endl;
+	return ( test.getNumberOfFailures() == 0 ? 0 : 1 );
+}
@@ -19,11 +19,17 @@
 
 #include "_2RealApplication.h"
 
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
+
 #include <windows.h>
 #include <iostream>
+#include <sstream>
+#include <cstdlib>
 #include <list>
 #include <deque>
 #include <vector>
+#include <algorithm>
 #ifndef _UNIX
 #ifdef _DEBUG
 	#include "vld.h"
@@ -34,11 +40,82 @@ using namespace std;
 using namespace _2Real;
 using namespace _2Real::app;
 
+// receives the output of the last block of the chain, which is the time the chain's source was updated.
+// every time must be newer than the previous one: a repeated time means a block read its input before
+// the predecessor had updated, 0 means the branches of a join disagreed
+class ChainLatency
+{
+
+public:
+
+	ChainLatency( const unsigned int chainLength ) :
+		m_ChainLength( chainLength ), m_Count( 0 ), m_Sum( 0. ), m_Min( 0. ), m_Max( 0. ), m_Last( 0. ), m_Errors( 0 ) {}
+
+	void receiveData( AppData const& data )
+	{
+		Poco::Timestamp now;
+		const double time = data.getData< double >();
+		double latency = static_cast< double >( now.epochMicroseconds() ) - time;
+
+		Poco::ScopedLock< Poco::FastMutex > lock( m_Access );
+
+		if ( time <= m_Last )
+		{
+			++m_Errors;
+			return;
+		}
+		m_Last = time;
+
+		if ( m_Count == 0 || latency < m_Min ) m_Min = latency;
+		if ( m_Count == 0 || latency > m_Max ) m_Max = latency;
+		m_Sum += latency;
+		++m_Count;
+
+		if ( m_Count == 500 )
+		{
+			std::ostringstream msg;
+			msg << "chain of " << m_ChainLength << " blocks, latency ( microseconds ) avg: " << m_Sum / m_Count;
+			msg << " min: " << m_Min << " max: " << m_Max << " avg per hop: " << m_Sum / ( m_Count * m_ChainLength );
+			msg << " out of order: " << m_Errors << endl;
+			cout << msg.str();
+
+			m_Count = 0;
+			m_Sum = 0.;
+		}
+	}
+
+private:
+
+	unsigned int		m_ChainLength;
+	unsigned int		m_Count;
+	double				m_Sum, m_Min, m_Max;
+	double				m_Last;
+	unsigned int		m_Errors;
+	Poco::FastMutex		m_Access;
+
+};
+
+// usage: ThreadpoolTestingApp [ number of relay blocks in the chain ] [ mode ]
+// modes: 'plain' - every block is triggered by the data of its predecessor
+//        'fused' - the relays are fused with their predecessors, so the chain runs on one thread per update
+//        'frame' - a second branch of one relay runs in parallel to the chain, a join block compares both;
+//                  all blocks are in a frame group, so every frame must deliver one new & matching time
 int main( int argc, char *argv[] )
 {
 	Engine &testEngine = Engine::instance();
 	testEngine.setBaseDirectory( "." );
 
+	unsigned int chainLength = 10;
+	if ( argc > 1 ) chainLength = std::max( atoi( argv[ 1 ] ), 1 );
+	const string mode = ( argc > 2 ? argv[ 2 ] : "plain" );
+	const bool frameMode = ( mode == "frame" );
+	const bool fusedMode = ( mode == "fused" );
+	cout << "chain of " << chainLength << " relays, mode: " << mode << endl;
+
+	ChainLatency latency( chainLength );
+	std::vector< BlockHandle > chain;
+	OutletHandle chainEnd;
+
 	unsigned int count = 5;
 	std::vector< BlockHandle > blockInstances;
 	blockInstances.resize( 3*count );
@@ -49,6 +126,64 @@ int main( int argc, char *argv[] )
 	try
 	{
 		BundleHandle testBundle = testEngine.loadBundle( "ThreadpoolTesting" );
+
+		// latency benchmark: a time triggered source followed by a chain of relays, each triggered by new data
+		BlockHandle source = testBundle.createBlockInstance( "chain_source" );
+		source.setUpdateRate( 100. );
+		chain.push_back( source );
+		OutletHandle previous = source.getOutletHandle( "chain_outlet" );
+
+		for ( unsigned int i=0; i<chainLength; ++i )
+		{
+			BlockHandle relay = testBundle.createBlockInstance( "chain_relay" );
+			relay.setUpdateRate( 0. );
+			InletHandle relayIn = relay.getInletHandle( "chain_inlet" );
+			relayIn.setUpdatePolicy( InletPolicy::OR_NEWER_DATA );
+			relayIn.link( previous );
+			previous = relay.getOutletHandle( "chain_outlet" );
+			chain.push_back( relay );
+		}
+
+		if ( frameMode )
+		{
+			BlockHandle branch = testBundle.createBlockInstance( "chain_relay" );
+			branch.getInletHandle( "chain_inlet" ).link( source.getOutletHandle( "chain_outlet" ) );
+			chain.push_back( branch );
+
+			BlockHandle join = testBundle.createBlockInstance( "chain_join" );
+			join.getInletHandle( "chain_inlet_a" ).link( previous );
+			join.getInletHandle( "chain_inlet_b" ).link( branch.getOutletHandle( "chain_outlet" ) );
+			chain.push_back( join );
+			previous = join.getOutletHandle( "chain_outlet" );
+		}
+
+		chainEnd = previous;
+		chainEnd.registerToNewData( latency, &ChainLatency::receiveData );
+
+		for ( std::vector< BlockHandle >::iterator it = chain.begin(); it != chain.end(); ++it )
+		{
+			it->setup();
+		}
+
+		if ( frameMode )
+		{
+			// the group's clock replaces the source's update rate, the blocks are not started
+			testEngine.createFrameGroup( chain, 100. );
+		}
+		else
+		{
+			if ( fusedMode )
+			{
+				// every link of the chain qualifies
+				const unsigned int fused = testEngine.fuseLinearChains();
+				cout << "fused " << fused << " of " << chainLength << " links" << endl;
+			}
+
+			for ( std::vector< BlockHandle >::reverse_iterator it = chain.rbegin(); it != chain.rend(); ++it )
+			{
+				it->start();
+			}
+		}
 		
 		// testEngine.loadConfig( "threadpooltest.xml" ); // TODO File does not exist and program crashes here!!
 
@@ -198,6 +333,7 @@ int main( int argc, char *argv[] )
 		getline( cin, line, lineEnd );
 		if ( line == "q" )
 		{
+			if ( chainEnd.isValid() ) chainEnd.unregisterFromNewData( latency, &ChainLatency::receiveData );
 			break;
 		}
 		//else if ( line == "r" )
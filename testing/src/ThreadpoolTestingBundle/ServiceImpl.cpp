@@ -3,6 +3,8 @@
 
 #include "bundle/_2RealBlockHandle.h"
 
+#include "Poco/Timestamp.h"
+
 #include <iostream>
 #include <vector>
 #include <string>
@@ -146,4 +148,88 @@ void MultiIn::update()
 		cout << e.message() << endl;
 		e.rethrow();
 	}
+};
+
+void ChainSource::setup( BlockHandle &handle )
+{
+	try
+	{
+		m_Out = handle.getOutletHandle( "chain_outlet" );
+	}
+	catch ( Exception &e )
+	{
+		cout << e.message() << endl;
+		e.rethrow();
+	}
+};
+
+void ChainSource::update()
+{
+	try
+	{
+		Poco::Timestamp now;
+		m_Out.getWriteableRef< double >() = static_cast< double >( now.epochMicroseconds() );
+	}
+	catch ( Exception &e )
+	{
+		cout << e.message() << endl;
+		e.rethrow();
+	}
+};
+
+void ChainRelay::setup( BlockHandle &handle )
+{
+	try
+	{
+		m_In = handle.getInletHandle( "chain_inlet" );
+		m_Out = handle.getOutletHandle( "chain_outlet" );
+	}
+	catch ( Exception &e )
+	{
+		cout << e.message() << endl;
+		e.rethrow();
+	}
+};
+
+void ChainRelay::update()
+{
+	try
+	{
+		m_Out.getWriteableRef< double >() = m_In.getReadableRef< double >();
+	}
+	catch ( Exception &e )
+	{
+		cout << e.message() << endl;
+		e.rethrow();
+	}
+};
+
+void ChainJoin::setup( BlockHandle &handle )
+{
+	try
+	{
+		m_InA = handle.getInletHandle( "chain_inlet_a" );
+		m_InB = handle.getInletHandle( "chain_inlet_b" );
+		m_Out = handle.getOutletHandle( "chain_outlet" );
+	}
+	catch ( Exception &e )
+	{
+		cout << e.message() << endl;
+		e.rethrow();
+	}
+};
+
+void ChainJoin::update()
+{
+	try
+	{
+		const double a = m_InA.getReadableRef< double >();
+		const double b = m_InB.getReadableRef< double >();
+		m_Out.getWriteableRef< double >() = ( a == b ? a : 0. );
+	}
+	catch ( Exception &e )
+	{
+		cout << e.message() << endl;
+		e.rethrow();
+	}
 };
\ No newline at end of file
@@ -73,4 +73,59 @@ private:
 	_2Real::bundle::InletHandle			m_InOptions;
 	_2Real::bundle::InletHandle			m_Msg;
 
+};
+
+// latency benchmark: the source writes the time of its update ( in microseconds ),
+// relays pass it on unchanged, so the app can measure the delay at the end of a chain
+class ChainSource : public _2Real::bundle::Block
+{
+
+public:
+
+	ChainSource() : Block() {}
+	void shutdown() {}
+	void update();
+	void setup( _2Real::bundle::BlockHandle &handle );
+
+private:
+
+	_2Real::bundle::OutletHandle		m_Out;
+
+};
+
+class ChainRelay : public _2Real::bundle::Block
+{
+
+public:
+
+	ChainRelay() : Block() {}
+	void shutdown() {}
+	void update();
+	void setup( _2Real::bundle::BlockHandle &handle );
+
+private:
+
+	_2Real::bundle::InletHandle			m_In;
+	_2Real::bundle::OutletHandle		m_Out;
+
+};
+
+// end of two branches that started at the same source: passes the time on if both
+// branches deliver the same one, writes 0 otherwise
+class ChainJoin : public _2Real::bundle::Block
+{
+
+public:
+
+	ChainJoin() : Block() {}
+	void shutdown() {}
+	void update();
+	void setup( _2Real::bundle::BlockHandle &handle );
+
+private:
+
+	_2Real::bundle::InletHandle			m_InA;
+	_2Real::bundle::InletHandle			m_InB;
+	_2Real::bundle::OutletHandle		m_Out;
+
 };
\ No newline at end of file
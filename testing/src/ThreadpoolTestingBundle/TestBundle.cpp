@@ -42,6 +42,21 @@ void getBundleMetainfo( BundleMetainfo &info )
 		multiin.addInlet< string >( "multiin_msg", "undefined" );
 		multiin.addMultiInlet< int >( "multiin_inlet", 0 );
 		multiin.addMultiInlet< int >( "multiin_inlet_options", 0, inputOptions );
+
+		BlockMetainfo &chainSource = info.exportBlock< ChainSource, WithoutContext >( "chain_source" );
+		chainSource.setDescription( "latency benchmark: writes the time of its update" );
+		chainSource.addOutlet< double >( "chain_outlet" );
+
+		BlockMetainfo &chainRelay = info.exportBlock< ChainRelay, WithoutContext >( "chain_relay" );
+		chainRelay.setDescription( "latency benchmark: passes on the received time" );
+		chainRelay.addInlet< double >( "chain_inlet", 0. );
+		chainRelay.addOutlet< double >( "chain_outlet" );
+
+		BlockMetainfo &chainJoin = info.exportBlock< ChainJoin, WithoutContext >( "chain_join" );
+		chainJoin.setDescription( "latency benchmark: joins two branches, writes 0 if they disagree" );
+		chainJoin.addInlet< double >( "chain_inlet_a", 0. );
+		chainJoin.addInlet< double >( "chain_inlet_b", 0. );
+		chainJoin.addOutlet< double >( "chain_outlet" );
 	}
 	catch ( Exception &e )
 	{